@@ -0,0 +1,706 @@
+#include "ADC.h"
+#include "MS8313.h"
+#include "stm32f10x.h"
+#include <math.h>
+
+#if MYADC_SHUNT_NUM == 1
+#if MS8313_USE_TIM1
+#error "单电阻采样需要上溢/下溢各一次更新事件装载非对称PWM图样，仅支持TIM2后端"
+#endif
+// 母线电流换算系数（A/计数）：分流电阻在下桥公共端，电流流回地时电压为正
+#define MYADC_CURRENT_SCALE     (MYADC_VREF / 4096.0f / (MYADC_SHUNT_OHM * MYADC_AMP_GAIN))
+#define MYADC_MODE              ADC_Mode_Independent
+#else
+// 相电流换算系数（A/计数）：低边分流电阻上电流流出逆变器时电压为负，取负号
+#define MYADC_CURRENT_SCALE     (-MYADC_VREF / 4096.0f / (MYADC_SHUNT_OHM * MYADC_AMP_GAIN))
+#define MYADC_MODE              ADC_Mode_InjecSimult
+#endif
+
+// ==================== 静态变量 ====================
+static uint16_t slow_buffer[2 * MYADC_DECIMATE * MYADC_SLOW_NUM];  // DMA循环缓冲（两半交替处理）
+static MYADC_Slow_t slow[2] = {
+    {MYADC_VBUS_NOMINAL, 1.0f / MYADC_VBUS_NOMINAL, 25.0f, 25.0f, {0.0f, 0.0f, 0.0f}, 0},
+    {MYADC_VBUS_NOMINAL, 1.0f / MYADC_VBUS_NOMINAL, 25.0f, 25.0f, {0.0f, 0.0f, 0.0f}, 0}
+};
+static volatile uint8_t slow_index = 0;             // 当前有效的一份
+static MYADC_Current_t current = {
+    {0, 0, 0},
+    {MYADC_CURRENT_OFFSET, MYADC_CURRENT_OFFSET, MYADC_CURRENT_OFFSET},
+    {1.0f, 1.0f, 1.0f},
+    0.0f, 0.0f, 0.0f, 0, 0
+};
+static float current_scale[3] = {MYADC_CURRENT_SCALE, MYADC_CURRENT_SCALE, MYADC_CURRENT_SCALE};
+static volatile uint16_t acc_remaining = 0;         // 剩余累加次数（0 = 正常采样）
+static uint16_t acc_samples = 0;                    // 累加总次数
+static uint32_t acc_sum[3];                         // 各通道原始计数累加值
+static uint16_t oc_trip_counts = 0;                 // 过流阈值（计数，0 = 关闭）
+static volatile uint8_t oc_fault = 0;               // 过流故障锁存
+static volatile uint8_t unsampled = 0;              // 调制器提供的不可采样相
+#if MYADC_SHUNT_NUM == 1
+static uint8_t ss_step = 0;                         // 单电阻：0 = 等待第一次采样，1 = 等待第二次
+static int16_t ss_first = 0;                        // 单电阻：第一次采样（去偏置）
+static uint8_t ss_tag = 0;                          // 单电阻：第一次采样时图样的附带信息
+static uint16_t ss_trigger = 0;                     // 单电阻：第一次采样时图样的第二个触发点
+#endif
+
+// ==================== 私有函数声明 ====================
+static void MYADC_SlowInit(void);
+static void MYADC_SlowProcess(const uint16_t *block);
+static void MYADC_CurrentInit(void);
+static void MYADC_Accumulate(void);
+static void MYADC_WatchdogConfig(void);
+#if MYADC_SHUNT_NUM == 1
+static void MYADC_SingleShuntSample(void);
+#endif
+
+// ==================== 私有函数实现 ====================
+
+/**
+ * @brief  慢速通道初始化
+ * @note   TIM3更新事件（TRGO）触发一次规则组扫描，DMA1通道1循环搬运到缓冲；
+ *         缓冲分两半，半传输/传输完成中断各处理 MYADC_DECIMATE 次扫描。
+ *         规则组被注入组打断后自动重新转换，不影响电流采样时刻
+ */
+static void MYADC_SlowInit(void)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+    
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3, ENABLE);
+    
+    // DMA1通道1：ADC1_DR → 缓冲，半字，循环
+    DMA_DeInit(DMA1_Channel1);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&ADC1->DR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)slow_buffer;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize = 2 * MYADC_DECIMATE * MYADC_SLOW_NUM;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Low;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(DMA1_Channel1, &DMA_InitStructure);
+    DMA_ITConfig(DMA1_Channel1, DMA_IT_HT | DMA_IT_TC, ENABLE);
+    DMA_Cmd(DMA1_Channel1, ENABLE);
+    
+    // 低于控制中断和I2C，与串口同级（子优先级更高）
+    NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel1_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 3;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    
+    ADC_DMACmd(ADC1, ENABLE);
+    ADC_ExternalTrigConvCmd(ADC1, ENABLE);
+    
+    // TIM3：72MHz / 72 = 1MHz 计数，更新事件作为扫描触发
+    TIM_TimeBaseStructure.TIM_Period = 1000000 / MYADC_SCAN_FREQ - 1;
+    TIM_TimeBaseStructure.TIM_Prescaler = 72 - 1;
+    TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
+    TIM_TimeBaseInit(TIM3, &TIM_TimeBaseStructure);
+    TIM_SelectOutputTrigger(TIM3, TIM_TRGOSource_Update);
+    TIM_Cmd(TIM3, ENABLE);
+}
+
+/**
+ * @brief  慢速通道抽取与滤波
+ * @note   一阶CIC（MYADC_DECIMATE 点求和）后再做一阶IIR，写入非当前的一份再切换；
+ *         首次发布直接取抽取结果作为滤波初值
+ * @param  block: 半个DMA缓冲（MYADC_DECIMATE 次扫描，通道交错）
+ */
+static void MYADC_SlowProcess(const uint16_t *block)
+{
+    const MYADC_Slow_t *prev = &slow[slow_index];
+    MYADC_Slow_t *next = &slow[slow_index ^ 1];
+    uint32_t sum[MYADC_SLOW_NUM] = {0};
+    float vbus, ratio, r_ntc, temp_driver, temp_board;
+    uint16_t i;
+    uint8_t ch;
+    
+    for (i = 0; i < MYADC_DECIMATE; i++) {
+        for (ch = 0; ch < MYADC_SLOW_NUM; ch++) {
+            sum[ch] += block[i * MYADC_SLOW_NUM + ch];
+        }
+    }
+    for (ch = 0; ch < MYADC_SLOW_NUM; ch++) {
+        next->raw[ch] = (float)sum[ch] * (1.0f / MYADC_DECIMATE);
+    }
+    
+    // 母线电压
+    vbus = next->raw[0] * (MYADC_VREF * MYADC_VBUS_DIVIDER / 4096.0f);
+    
+    // NTC：R = Rpu * x / (1 - x)，B值公式
+    ratio = next->raw[1] * (1.0f / 4096.0f);
+    if (ratio < 0.001f) ratio = 0.001f;
+    if (ratio > 0.999f) ratio = 0.999f;
+    r_ntc = MYADC_NTC_PULLUP * ratio / (1.0f - ratio);
+    temp_driver = 1.0f / (1.0f / 298.15f + logf(r_ntc / MYADC_NTC_R25) / MYADC_NTC_BETA) - 273.15f;
+    
+    // 内部温度传感器
+    temp_board = (MYADC_TS_V25 - next->raw[2] * (MYADC_VREF / 4096.0f)) / MYADC_TS_SLOPE + 25.0f;
+    
+    if (prev->count == 0) {
+        next->vbus = vbus;
+        next->temp_driver = temp_driver;
+        next->temp_board = temp_board;
+    } else {
+        next->vbus = prev->vbus + (vbus - prev->vbus) * MYADC_VBUS_ALPHA;
+        next->temp_driver = prev->temp_driver + (temp_driver - prev->temp_driver) * MYADC_TEMP_ALPHA;
+        next->temp_board = prev->temp_board + (temp_board - prev->temp_board) * MYADC_TEMP_ALPHA;
+    }
+    
+    // 低于下限时按下限计算，避免调制深度随掉电无限放大
+    next->vbus_inv = 1.0f / ((next->vbus > MYADC_VBUS_MIN) ? next->vbus : MYADC_VBUS_MIN);
+    next->count = prev->count + 1;
+    
+    slow_index ^= 1;
+}
+
+#if MYADC_SHUNT_NUM == 1
+/**
+ * @brief  相电流采样初始化（单电阻）
+ * @note   ADC1注入组单通道，由PWM定时器TRGO（OC4REF）在向上计数时触发；
+ *         第一次转换完成后改写 CCR4 产生同一个上半周期内的第二次触发
+ */
+static void MYADC_CurrentInit(void)
+{
+    GPIO_InitTypeDef GPIO_InitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+    
+    // PA5: 模拟输入
+    GPIO_InitStructure.GPIO_Pin = GPIO_Pin_5;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AIN;
+    GPIO_Init(GPIOA, &GPIO_InitStructure);
+    
+    ADC_InjectedSequencerLengthConfig(ADC1, 1);
+    ADC_InjectedChannelConfig(ADC1, MYADC_IDC_CHANNEL, 1, MYADC_CURRENT_SAMPLETIME);
+    ADC_ExternalTrigInjectedConvConfig(ADC1, ADC_ExternalTrigInjecConv_T2_TRGO);
+    ADC_ExternalTrigInjectedConvCmd(ADC1, ENABLE);
+    
+    ADC_ClearITPendingBit(ADC1, ADC_IT_JEOC);
+    ADC_ITConfig(ADC1, ADC_IT_JEOC, ENABLE);
+    
+    NVIC_InitStructure.NVIC_IRQChannel = ADC1_2_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;  // 高于PWM中断：过流关断和电流环不等控制回调
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    
+    MS8313_SetSingleShuntTrigger();
+}
+
+/**
+ * @brief  单电阻采样处理
+ * @note   PWM图样在上半周期依次打开三相高边：只有最大相导通时母线电流 = +i_max，
+ *         最大、中间相导通时母线电流 = -i_min，第三相由基尔霍夫定律重构。
+ *         每次结果先用计数器位置核对是否属于图样中的触发点，中断被推迟时丢弃本周期；
+ *         第二次转换可能在上溢之后完成，此时更新中断已切换到下一周期的图样，
+ *         因此第一次采样时记下图样的相别和第二个触发点，第二次采样只用记下的值；
+ *         图样无效（窗口不足、六步换相、尚未生成）时保持上一次结果，仍调用回调，
+ *         保证由回调驱动的电流环能生成下一个图样
+ */
+static void MYADC_SingleShuntSample(void)
+{
+    const MS8313_AsymPattern_t *pattern = MS8313_GetActivePattern();
+    int16_t sample = (int16_t)(ADC1->JDR1 & 0x0FFF) - (int16_t)current.offset[0];
+    int32_t period = MS8313_GetTiming()->period;
+    int32_t cnt = MS8313_TIM->CNT;
+    int32_t trigger, elapsed;
+    uint8_t pos, neg, mid;
+    
+    if (ss_step == 0) {
+        if (pattern == 0 || !(pattern->tag & MYADC_SS_VALID)) {
+            current.reconstructed = 0x07;
+            current.count++;
+            MYADC_CurrentCallback();
+            return;
+        }
+        ss_tag = pattern->tag;
+        ss_trigger = pattern->trigger[1];
+        trigger = pattern->trigger[0];
+    } else {
+        trigger = ss_trigger;
+    }
+    
+    // 触发后经过的计数（越过峰值时按折返计算）
+    if (MS8313_TIM->CR1 & TIM_CR1_DIR) {
+        elapsed = 2 * period - trigger - cnt;
+    } else {
+        elapsed = cnt - trigger;
+    }
+    if (elapsed < 0 || elapsed > MYADC_SS_MAX_DELAY) {
+        ss_step = 0;
+        return;
+    }
+    
+    if (ss_step == 0) {
+        ss_first = sample;
+        // 改写后计数器仍在第二个触发点之前，才能保证产生上升沿
+        MS8313_SetADCTriggerPoint(ss_trigger);
+        if (!(MS8313_TIM->CR1 & TIM_CR1_DIR) && MS8313_TIM->CNT < ss_trigger) {
+            ss_step = 1;
+        }
+        return;
+    }
+    ss_step = 0;
+    
+    pos = ss_tag & 0x03;
+    neg = (ss_tag >> 2) & 0x03;
+    mid = 3 - pos - neg;
+    current.raw[pos] = ss_first;
+    current.raw[neg] = -sample;
+    current.raw[mid] = -current.raw[pos] - current.raw[neg];
+    current.reconstructed = (uint8_t)(1 << mid);
+    
+    current.ia = current.raw[0] * current_scale[0];
+    current.ib = current.raw[1] * current_scale[1];
+    current.ic = current.raw[2] * current_scale[2];
+    current.count++;
+    
+    MYADC_CurrentCallback();
+}
+#else
+/**
+ * @brief  相电流采样初始化
+ * @note   ADC1为主、ADC2为从，注入组同步模式，两路同时采样，时间偏差为0：
+ *         两电阻：ADC1 = A，ADC2 = B；
+ *         三电阻：ADC1 = A, C，ADC2 = B, B（第二个B为占位，两组长度须相同），
+ *                C相晚一次转换时间，采样窗口需覆盖两次转换。
+ *         触发只接到主ADC，从ADC设为软件触发防止误触发
+ */
+static void MYADC_CurrentInit(void)
+{
+    GPIO_InitTypeDef GPIO_InitStructure;
+    ADC_InitTypeDef ADC_InitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+    
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_ADC2, ENABLE);
+    
+    // PA5/PA6/PA7: 模拟输入
+    GPIO_InitStructure.GPIO_Pin = GPIO_Pin_5 | GPIO_Pin_6 | GPIO_Pin_7;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AIN;
+    GPIO_Init(GPIOA, &GPIO_InitStructure);
+    
+    // ADC2：只用注入组
+    ADC_InitStructure.ADC_Mode = ADC_Mode_InjecSimult;
+    ADC_InitStructure.ADC_ScanConvMode = ENABLE;
+    ADC_InitStructure.ADC_ContinuousConvMode = DISABLE;
+    ADC_InitStructure.ADC_ExternalTrigConv = ADC_ExternalTrigConv_None;
+    ADC_InitStructure.ADC_DataAlign = ADC_DataAlign_Right;
+    ADC_InitStructure.ADC_NbrOfChannel = 1;
+    ADC_Init(ADC2, &ADC_InitStructure);
+    
+    // 注入组序列（先设长度再配通道）
+    ADC_InjectedSequencerLengthConfig(ADC1, MYADC_SHUNT_NUM - 1);
+    ADC_InjectedSequencerLengthConfig(ADC2, MYADC_SHUNT_NUM - 1);
+    ADC_InjectedChannelConfig(ADC1, MYADC_IA_CHANNEL, 1, MYADC_CURRENT_SAMPLETIME);
+    ADC_InjectedChannelConfig(ADC2, MYADC_IB_CHANNEL, 1, MYADC_CURRENT_SAMPLETIME);
+#if MYADC_SHUNT_NUM == 3
+    ADC_InjectedChannelConfig(ADC1, MYADC_IC_CHANNEL, 2, MYADC_CURRENT_SAMPLETIME);
+    ADC_InjectedChannelConfig(ADC2, MYADC_IB_CHANNEL, 2, MYADC_CURRENT_SAMPLETIME);
+#endif
+    
+    // 主ADC由PWM定时器TRGO触发，从ADC软件触发
+#if MS8313_USE_TIM1
+    ADC_ExternalTrigInjectedConvConfig(ADC1, ADC_ExternalTrigInjecConv_T1_TRGO);
+#else
+    ADC_ExternalTrigInjectedConvConfig(ADC1, ADC_ExternalTrigInjecConv_T2_TRGO);
+#endif
+    ADC_ExternalTrigInjectedConvCmd(ADC1, ENABLE);
+    ADC_ExternalTrigInjectedConvConfig(ADC2, ADC_ExternalTrigInjecConv_None);
+    ADC_ExternalTrigInjectedConvCmd(ADC2, ENABLE);
+    
+    ADC_Cmd(ADC2, ENABLE);
+    
+    // 校准
+    ADC_ResetCalibration(ADC2);
+    while (ADC_GetResetCalibrationStatus(ADC2));
+    ADC_StartCalibration(ADC2);
+    while (ADC_GetCalibrationStatus(ADC2));
+    
+    // 注入组转换完成中断（主ADC，两路同时完成）
+    ADC_ClearITPendingBit(ADC1, ADC_IT_JEOC);
+    ADC_ITConfig(ADC1, ADC_IT_JEOC, ENABLE);
+    
+    NVIC_InitStructure.NVIC_IRQChannel = ADC1_2_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;  // 高于PWM中断：过流关断和电流环不等控制回调
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    
+    // PWM定时器通道4产生谷点触发
+    MS8313_SetADCTrigger(MYADC_TRIGGER_LEAD);
+}
+
+#endif
+
+/**
+ * @brief  累加注入组原始结果
+ */
+static void MYADC_Accumulate(void)
+{
+    acc_sum[0] += ADC1->JDR1 & 0x0FFF;
+#if MYADC_SHUNT_NUM >= 2
+    acc_sum[1] += ADC2->JDR1 & 0x0FFF;
+#endif
+#if MYADC_SHUNT_NUM == 3
+    acc_sum[2] += ADC1->JDR2 & 0x0FFF;
+#endif
+    acc_remaining--;
+}
+
+/**
+ * @brief  配置模拟看门狗阈值
+ * @note   所有监视通道共用一组阈值，取各通道偏置的最小/最大值再加减阈值
+ */
+static void MYADC_WatchdogConfig(void)
+{
+    uint16_t off_min = current.offset[0];
+    uint16_t off_max = current.offset[0];
+    int32_t high, low;
+    uint8_t i;
+    
+    if (oc_trip_counts == 0) {
+        ADC_ITConfig(ADC1, ADC_IT_AWD, DISABLE);
+        ADC_AnalogWatchdogCmd(ADC1, ADC_AnalogWatchdog_None);
+#if MYADC_SHUNT_NUM >= 2
+        ADC_ITConfig(ADC2, ADC_IT_AWD, DISABLE);
+        ADC_AnalogWatchdogCmd(ADC2, ADC_AnalogWatchdog_None);
+#endif
+        return;
+    }
+    
+    for (i = 1; i < MYADC_SHUNT_NUM; i++) {
+        if (current.offset[i] < off_min) off_min = current.offset[i];
+        if (current.offset[i] > off_max) off_max = current.offset[i];
+    }
+    high = (int32_t)off_max + oc_trip_counts;
+    low = (int32_t)off_min - oc_trip_counts;
+    if (high > 0x0FFF) high = 0x0FFF;
+    if (low < 0) low = 0;
+    
+    ADC_AnalogWatchdogThresholdsConfig(ADC1, (uint16_t)high, (uint16_t)low);
+    ADC_AnalogWatchdogCmd(ADC1, ADC_AnalogWatchdog_AllInjecEnable);
+    ADC_ClearITPendingBit(ADC1, ADC_IT_AWD);
+#if MYADC_SHUNT_NUM >= 2
+    ADC_AnalogWatchdogThresholdsConfig(ADC2, (uint16_t)high, (uint16_t)low);
+    ADC_AnalogWatchdogCmd(ADC2, ADC_AnalogWatchdog_AllInjecEnable);
+    ADC_ClearITPendingBit(ADC2, ADC_IT_AWD);
+#endif
+    if (!oc_fault) {
+        ADC_ITConfig(ADC1, ADC_IT_AWD, ENABLE);
+#if MYADC_SHUNT_NUM >= 2
+        ADC_ITConfig(ADC2, ADC_IT_AWD, ENABLE);
+#endif
+    }
+}
+
+// ==================== 公共函数实现 ====================
+
+/**
+ * @brief  ADC初始化
+ * @note   ADC1规则组由TIM3触发扫描慢速通道（DMA循环传输），完成校准后等待首次发布作为滤波初值；
+ *         ADC1/ADC2 注入组同步模式采样相电流，由PWM定时器触发，转换完成中断更新结果；
+ *         单电阻时ADC1为独立模式
+ * @retval 无
+ */
+void MYADC_Init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStructure;
+    ADC_InitTypeDef ADC_InitStructure;
+    uint32_t timeout;
+    
+    // ADC时钟 = 72MHz / 6 = 12MHz（不超过14MHz）
+    RCC_ADCCLKConfig(RCC_PCLK2_Div6);
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA | RCC_APB2Periph_GPIOB | RCC_APB2Periph_ADC1, ENABLE);
+    
+    // PA4: 母线电压，PB0: NTC，模拟输入
+    GPIO_InitStructure.GPIO_Pin = GPIO_Pin_4;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AIN;
+    GPIO_Init(GPIOA, &GPIO_InitStructure);
+    GPIO_InitStructure.GPIO_Pin = GPIO_Pin_0;
+    GPIO_Init(GPIOB, &GPIO_InitStructure);
+    
+    // 规则组扫描，TIM3触发；注入组与ADC2同步（规则组独立转换），单电阻时独立模式
+    ADC_InitStructure.ADC_Mode = MYADC_MODE;
+    ADC_InitStructure.ADC_ScanConvMode = ENABLE;
+    ADC_InitStructure.ADC_ContinuousConvMode = DISABLE;
+    ADC_InitStructure.ADC_ExternalTrigConv = ADC_ExternalTrigConv_T3_TRGO;
+    ADC_InitStructure.ADC_DataAlign = ADC_DataAlign_Right;
+    ADC_InitStructure.ADC_NbrOfChannel = MYADC_SLOW_NUM;
+    ADC_Init(ADC1, &ADC_InitStructure);
+    
+    // 分压电阻/NTC阻抗较高，内部温度传感器要求采样时间大于17us，都用最长采样时间（239.5周期，约21us/次）
+    ADC_RegularChannelConfig(ADC1, MYADC_VBUS_CHANNEL, 1, ADC_SampleTime_239Cycles5);
+    ADC_RegularChannelConfig(ADC1, MYADC_NTC_CHANNEL, 2, ADC_SampleTime_239Cycles5);
+    ADC_RegularChannelConfig(ADC1, ADC_Channel_TempSensor, 3, ADC_SampleTime_239Cycles5);
+    ADC_TempSensorVrefintCmd(ENABLE);
+    
+    ADC_Cmd(ADC1, ENABLE);
+    
+    // 校准
+    ADC_ResetCalibration(ADC1);
+    while (ADC_GetResetCalibrationStatus(ADC1));
+    ADC_StartCalibration(ADC1);
+    while (ADC_GetCalibrationStatus(ADC1));
+    
+    // 启动慢速通道，等待首次发布作为滤波初值（约4ms）
+    MYADC_SlowInit();
+    for (timeout = 0; slow[slow_index].count == 0 && timeout < 0x3FFFFF; timeout++);
+    
+    // 相电流采样
+    MYADC_CurrentInit();
+    
+#if MYADC_OC_ENABLE
+    MYADC_SetOvercurrent(MYADC_OC_TRIP);
+#endif
+}
+
+/**
+ * @brief  获取滤波后的母线电压
+ * @retval 母线电压（V）
+ */
+float MYADC_GetVbus(void)
+{
+    return slow[slow_index].vbus;
+}
+
+/**
+ * @brief  获取母线电压倒数
+ * @retval 1 / 母线电压（1/V），母线电压低于 MYADC_VBUS_MIN 时按下限计算
+ */
+float MYADC_GetVbusInv(void)
+{
+    return slow[slow_index].vbus_inv;
+}
+
+/**
+ * @brief  获取慢速通道结果
+ * @retval 结果指针（只读）
+ */
+const MYADC_Slow_t* MYADC_GetSlow(void)
+{
+    return &slow[slow_index];
+}
+
+/**
+ * @brief  获取相电流采样结果
+ * @retval 采样结果指针（只读，注入组转换完成中断中更新）
+ */
+const MYADC_Current_t* MYADC_GetCurrent(void)
+{
+    return &current;
+}
+
+/**
+ * @brief  设置电流采样校准值
+ * @param  offset: 各通道零电流偏置（计数）
+ * @param  gain: 各通道增益修正
+ * @retval 无
+ */
+void MYADC_SetCalibration(const uint16_t offset[3], const float gain[3])
+{
+    uint8_t i;
+    
+    // 与注入组中断同优先级以外的上下文调用时，先关中断保证一次采样内偏置与系数一致
+    NVIC_DisableIRQ(ADC1_2_IRQn);
+    for (i = 0; i < 3; i++) {
+        current.offset[i] = offset[i];
+        current.gain[i] = gain[i];
+        current_scale[i] = MYADC_CURRENT_SCALE * gain[i];
+    }
+    MYADC_WatchdogConfig();
+    NVIC_EnableIRQ(ADC1_2_IRQn);
+}
+
+/**
+ * @brief  开始累加注入组原始结果（校准用）
+ * @param  samples: 累加次数
+ * @retval 无
+ */
+void MYADC_StartAccumulate(uint16_t samples)
+{
+    NVIC_DisableIRQ(ADC1_2_IRQn);
+    acc_sum[0] = 0;
+    acc_sum[1] = 0;
+    acc_sum[2] = 0;
+    acc_samples = samples;
+    acc_remaining = samples;
+    NVIC_EnableIRQ(ADC1_2_IRQn);
+}
+
+/**
+ * @brief  获取累加结果
+ * @param  mean: 各通道平均原始计数（输出，未使用的通道为0）
+ * @retval 1: 累加完成, 0: 仍在进行
+ */
+uint8_t MYADC_GetAccumulate(float mean[3])
+{
+    uint8_t i;
+    
+    if (acc_remaining != 0 || acc_samples == 0) {
+        return 0;
+    }
+    for (i = 0; i < 3; i++) {
+        mean[i] = (float)acc_sum[i] / acc_samples;
+    }
+    return 1;
+}
+
+/**
+ * @brief  设置过流保护阈值并使能模拟看门狗
+ * @param  trip: 过流阈值（A），0 表示关闭保护
+ * @retval 无
+ */
+void MYADC_SetOvercurrent(float trip)
+{
+    float counts = trip / MYADC_CURRENT_SCALE;
+    
+    if (counts < 0.0f) {
+        counts = -counts;
+    }
+    if (counts > 0x0FFF) {
+        counts = 0x0FFF;
+    }
+    
+    NVIC_DisableIRQ(ADC1_2_IRQn);
+    oc_trip_counts = (uint16_t)counts;
+    MYADC_WatchdogConfig();
+    NVIC_EnableIRQ(ADC1_2_IRQn);
+}
+
+/**
+ * @brief  获取过流故障
+ * @retval 1: 发生过流且未清除, 0: 无故障
+ */
+uint8_t MYADC_GetFault(void)
+{
+    return oc_fault;
+}
+
+/**
+ * @brief  清除过流故障并重新使能看门狗中断
+ * @retval 无
+ */
+void MYADC_ClearFault(void)
+{
+    NVIC_DisableIRQ(ADC1_2_IRQn);
+    oc_fault = 0;
+    MYADC_WatchdogConfig();
+    NVIC_EnableIRQ(ADC1_2_IRQn);
+}
+
+/**
+ * @brief  设置不可采样相
+ * @param  mask: 不可采样相掩码（bit0=A, bit1=B, bit2=C）
+ * @retval 无
+ */
+void MYADC_SetUnsampled(uint8_t mask)
+{
+    unsampled = mask;
+}
+
+/**
+ * @brief  ADC中断处理
+ * @note   注入组结果直接读数据寄存器，去偏置换算为电流；
+ *         两电阻时C相总是重构，三电阻时重构调制器标记的那一相
+ *         （两相以上不可采样时无法重构，保留测量值）
+ * @retval 无
+ */
+void MYADC_IRQHandler(void)
+{
+    uint8_t mask;
+    uint8_t trip;
+    
+    // 过流：先关断驱动再处理其它事情；关闭看门狗中断避免越限期间反复进入
+    // （看门狗标志在中断关闭后仍会置位，只认使能了中断的）
+    trip = (ADC1->SR & ADC_SR_AWD) && (ADC1->CR1 & ADC_CR1_AWDIE);
+#if MYADC_SHUNT_NUM >= 2
+    trip |= (ADC2->SR & ADC_SR_AWD) && (ADC2->CR1 & ADC_CR1_AWDIE);
+#endif
+    if (trip) {
+        MS8313_DisableOutput();
+        oc_fault = 1;
+        ADC1->CR1 &= ~ADC_CR1_AWDIE;
+        ADC1->SR = ~(uint32_t)ADC_SR_AWD;
+#if MYADC_SHUNT_NUM >= 2
+        ADC2->CR1 &= ~ADC_CR1_AWDIE;
+        ADC2->SR = ~(uint32_t)ADC_SR_AWD;
+#endif
+    }
+    
+    if (!(ADC1->SR & ADC_SR_JEOC)) {
+        return;
+    }
+    ADC1->SR = ~(uint32_t)(ADC_SR_JEOC | ADC_SR_JSTRT);
+    
+    if (acc_remaining) {
+        MYADC_Accumulate();
+        return;
+    }
+    
+#if MYADC_SHUNT_NUM == 1
+    MYADC_SingleShuntSample();
+    (void)mask;
+#else
+    current.raw[0] = (int16_t)(ADC1->JDR1 & 0x0FFF) - (int16_t)current.offset[0];
+    current.raw[1] = (int16_t)(ADC2->JDR1 & 0x0FFF) - (int16_t)current.offset[1];
+#if MYADC_SHUNT_NUM == 3
+    current.raw[2] = (int16_t)(ADC1->JDR2 & 0x0FFF) - (int16_t)current.offset[2];
+    mask = unsampled;
+#else
+    mask = 0x04;
+#endif
+    
+    // 基尔霍夫定律重构（仅一相不可采样时）
+    if (mask == 0x01) {
+        current.raw[0] = -current.raw[1] - current.raw[2];
+    } else if (mask == 0x02) {
+        current.raw[1] = -current.raw[0] - current.raw[2];
+    } else if (mask == 0x04) {
+        current.raw[2] = -current.raw[0] - current.raw[1];
+    } else {
+        mask = 0;
+    }
+    current.reconstructed = mask;
+    
+    current.ia = current.raw[0] * current_scale[0];
+    current.ib = current.raw[1] * current_scale[1];
+    current.ic = current.raw[2] * current_scale[2];
+    current.count++;
+    
+    MYADC_CurrentCallback();
+#endif
+}
+
+/**
+ * @brief  慢速通道DMA中断处理
+ * @note   半传输时DMA正在写后一半，处理前一半；传输完成时反之
+ * @retval 无
+ */
+void MYADC_DMA_IRQHandler(void)
+{
+    if (DMA1->ISR & DMA_ISR_HTIF1) {
+        DMA1->IFCR = DMA_IFCR_CHTIF1;
+        MYADC_SlowProcess(&slow_buffer[0]);
+    }
+    if (DMA1->ISR & DMA_ISR_TCIF1) {
+        DMA1->IFCR = DMA_IFCR_CTCIF1;
+        MYADC_SlowProcess(&slow_buffer[MYADC_DECIMATE * MYADC_SLOW_NUM]);
+    }
+}
+
+/**
+ * @brief  电流采样完成回调（弱定义，用户重写）
+ * @retval 无
+ */
+__weak void MYADC_CurrentCallback(void)
+{
+    // 默认实现：什么都不做
+}
@@ -0,0 +1,205 @@
+#ifndef __ADC_H
+#define __ADC_H
+
+#include <stdint.h>
+
+// ==================== 硬件配置 ====================
+// 慢速通道：规则组扫描，TIM3定时触发，DMA循环搬运，DMA中断中抽取滤波后发布，不经过控制中断
+// PA4: ADC12_IN4 母线电压分压，PB0: ADC12_IN8 驱动器NTC，IN16: 芯片内部温度传感器
+#define MYADC_VBUS_CHANNEL      ADC_Channel_4   // ADC通道
+#define MYADC_NTC_CHANNEL       ADC_Channel_8
+#define MYADC_SLOW_NUM          3       // 扫描通道数（顺序：母线电压、驱动器温度、板温）
+#define MYADC_SCAN_FREQ         4000    // 扫描触发频率（Hz），每次扫描约63us，规则组占用约25%
+#define MYADC_DECIMATE          16      // 抽取比：每16次扫描求和输出一次（一阶CIC），发布频率250Hz
+#define MYADC_VREF              3.3f    // ADC参考电压（V）
+#define MYADC_VBUS_DIVIDER      11.0f   // 母线分压比（按硬件电阻调整，如 100k / 10k）
+
+// 驱动器NTC（上拉到Vref，NTC接地）
+#define MYADC_NTC_PULLUP        10000.0f    // 上拉电阻（Ω）
+#define MYADC_NTC_R25           10000.0f    // 25℃阻值（Ω）
+#define MYADC_NTC_BETA          3950.0f     // B值
+
+// 内部温度传感器（数据手册典型值，绝对精度约±5℃，用于趋势监测）
+#define MYADC_TS_V25            1.43f   // 25℃时输出（V）
+#define MYADC_TS_SLOPE          0.0043f // 斜率（V/℃）
+
+// 相电流采样（低边分流电阻 + 双极性放大，零电流偏置在 Vref/2）
+// ADC1/ADC2 注入组同步采样，由PWM定时器 TRGO（OC4REF）在谷点触发
+// PA5: ADC12_IN5 A相，PA6: ADC12_IN6 B相，PA7: ADC12_IN7 C相
+// 分流电阻数量：1 = 直流母线单电阻（PA5），每周期在两个有效矢量内各采样一次；
+//              2 = A/B同时采样，C = -(A+B)；3 = 三相
+#ifndef MYADC_SHUNT_NUM
+#define MYADC_SHUNT_NUM         2
+#endif
+#define MYADC_IDC_CHANNEL       ADC_Channel_5   // 单电阻：母线电流放大输出
+#define MYADC_IA_CHANNEL        ADC_Channel_5
+#define MYADC_IB_CHANNEL        ADC_Channel_6
+#define MYADC_IC_CHANNEL        ADC_Channel_7
+#define MYADC_CURRENT_SAMPLETIME    ADC_SampleTime_7Cycles5     // 7.5 + 12.5 周期 = 1.67us/次（12MHz）
+#define MYADC_SHUNT_OHM         0.01f   // 分流电阻（Ω）
+#define MYADC_AMP_GAIN          20.0f   // 电流放大倍数
+#define MYADC_CURRENT_OFFSET    2048    // 零电流偏置默认值（计数）
+#define MYADC_TRIGGER_LEAD      11      // 触发提前量（定时器计数），使采样保持窗口居中于谷点
+#define MYADC_SS_MAX_DELAY      180     // 单电阻：触发到转换完成中断的最大允许延迟（定时器计数，5us），
+                                        // 超出说明中断被推迟，结果不能确定属于哪个有效矢量
+
+// 单电阻采样附带信息（随PWM图样生效）：bit0-1 = 第一次采样对应相（母线电流 = +i），
+// bit2-3 = 第二次采样对应相（母线电流 = -i），bit4 = 两个采样窗口均满足
+#define MYADC_SS_VALID          0x10
+#define MYADC_SS_TAG(pos, neg)  ((uint8_t)(MYADC_SS_VALID | (pos) | ((neg) << 2)))
+
+// 过流保护（模拟看门狗）：注入组每次转换结束时硬件比较阈值，越限即进中断关断驱动，
+// 不等控制周期；阈值对所有相电流通道共用，按各通道偏置的范围放宽
+#define MYADC_OC_ENABLE         1       // 1: 初始化时使能过流保护
+#define MYADC_OC_TRIP           6.0f    // 默认过流阈值（A，相电流或母线电流峰值）
+
+// 慢速通道滤波（抽取后的一阶IIR，按250Hz发布频率）
+#define MYADC_VBUS_ALPHA        0.2f    // 母线电压，时间常数约20ms
+#define MYADC_TEMP_ALPHA        0.02f   // 温度，时间常数约0.2s
+#define MYADC_VBUS_MIN          6.0f    // 归一化下限（V），防止掉电/未接电池时倒数发散
+#define MYADC_VBUS_NOMINAL      12.0f   // 标称母线电压（V）
+
+// ==================== 数据结构 ====================
+/**
+ * @brief 慢速通道发布结果（双缓冲，DMA中断写入另一份后切换，读取方不会读到半更新的数据）
+ */
+typedef struct {
+    float vbus;                 // 滤波后母线电压（V）
+    float vbus_inv;             // 母线电压倒数（1/V），低于 MYADC_VBUS_MIN 时按下限计算
+    float temp_driver;          // 驱动器温度（℃）
+    float temp_board;           // 芯片温度（℃）
+    float raw[MYADC_SLOW_NUM];  // 抽取后的平均计数（未滤波）
+    uint32_t count;             // 发布次数
+} MYADC_Slow_t;
+
+/**
+ * @brief 相电流采样结果（注入组转换完成中断中更新）
+ */
+typedef struct {
+    int16_t raw[3];             // 去偏置后的原始值（计数）
+    uint16_t offset[3];         // 零电流偏置（计数）
+    float gain[3];              // 增益修正（相对A相，默认1）
+    float ia;                   // A相电流（A，流出逆变器为正）
+    float ib;                   // B相电流（A）
+    float ic;                   // C相电流（A）
+    uint8_t reconstructed;      // 本次由基尔霍夫定律重构的相（bit0=A, bit1=B, bit2=C），
+                                // 单电阻无法采样时为0x07，三相保持上一次结果
+    uint32_t count;             // 采样计数
+} MYADC_Current_t;
+
+// ==================== 函数声明 ====================
+
+/**
+ * @brief  ADC初始化
+ * @note   ADC1规则组由TIM3触发扫描慢速通道，DMA循环传输，等待首次发布作为滤波初值；
+ *         ADC1/ADC2 注入组同步模式采样相电流，由PWM定时器触发，转换完成中断更新结果；
+ *         单电阻时只用ADC1注入组，每个PWM周期触发两次
+ * @retval 无
+ */
+void MYADC_Init(void);
+
+/**
+ * @brief  获取滤波后的母线电压
+ * @retval 母线电压（V）
+ */
+float MYADC_GetVbus(void);
+
+/**
+ * @brief  获取母线电压倒数
+ * @note   每次发布只做一次除法，调制器归一化时用乘法代替除法
+ * @retval 1 / 母线电压（1/V），母线电压低于 MYADC_VBUS_MIN 时按下限计算
+ */
+float MYADC_GetVbusInv(void);
+
+/**
+ * @brief  获取慢速通道结果
+ * @note   返回当前有效的一份缓冲，指针在下一次发布（4ms）前保持一致
+ * @retval 结果指针（只读）
+ */
+const MYADC_Slow_t* MYADC_GetSlow(void);
+
+/**
+ * @brief  获取相电流采样结果
+ * @retval 采样结果指针（只读，注入组转换完成中断中更新）
+ */
+const MYADC_Current_t* MYADC_GetCurrent(void);
+
+/**
+ * @brief  设置电流采样校准值
+ * @note   偏置和增益一起更新，换算系数在此预先乘好，中断内不增加运算
+ * @param  offset: 各通道零电流偏置（计数）
+ * @param  gain: 各通道增益修正
+ * @retval 无
+ */
+void MYADC_SetCalibration(const uint16_t offset[3], const float gain[3]);
+
+/**
+ * @brief  开始累加注入组原始结果（校准用）
+ * @note   接下来的 samples 次注入组转换只累加各通道原始计数（不去偏置），
+ *         期间不更新电流、不调用回调；单电阻时只有通道0
+ * @param  samples: 累加次数
+ * @retval 无
+ */
+void MYADC_StartAccumulate(uint16_t samples);
+
+/**
+ * @brief  获取累加结果
+ * @param  mean: 各通道平均原始计数（输出，未使用的通道为0）
+ * @retval 1: 累加完成, 0: 仍在进行
+ */
+uint8_t MYADC_GetAccumulate(float mean[3]);
+
+/**
+ * @brief  设置过流保护阈值并使能模拟看门狗
+ * @note   ADC1（及两电阻/三电阻时的ADC2）监视全部注入通道，
+ *         阈值 = 偏置 ± trip / 换算系数，校准值更新时自动重算
+ * @param  trip: 过流阈值（A），0 表示关闭保护
+ * @retval 无
+ */
+void MYADC_SetOvercurrent(float trip);
+
+/**
+ * @brief  获取过流故障
+ * @retval 1: 发生过流且未清除, 0: 无故障
+ */
+uint8_t MYADC_GetFault(void);
+
+/**
+ * @brief  清除过流故障并重新使能看门狗中断
+ * @note   只清除锁存，PWM输出保持禁用；电流仍越限时会在下一次转换再次触发
+ * @retval 无
+ */
+void MYADC_ClearFault(void);
+
+/**
+ * @brief  设置不可采样相
+ * @note   由调制器每周期提供（下管导通时间不足采样窗口的相），
+ *         三电阻时下一次采样用其余两相重构该相
+ * @param  mask: 不可采样相掩码（bit0=A, bit1=B, bit2=C）
+ * @retval 无
+ */
+void MYADC_SetUnsampled(uint8_t mask);
+
+/**
+ * @brief  ADC中断处理
+ * @note   在 ADC1_2_IRQHandler 中调用，先处理过流（模拟看门狗），再处理注入组结果
+ * @retval 无
+ */
+void MYADC_IRQHandler(void);
+
+/**
+ * @brief  慢速通道DMA中断处理
+ * @note   在 DMA1_Channel1_IRQHandler 中调用，半传输/传输完成各处理一半缓冲
+ * @retval 无
+ */
+void MYADC_DMA_IRQHandler(void);
+
+/**
+ * @brief  电流采样完成回调（弱定义，用户重写）
+ * @note   在注入组转换完成中断中调用，每个PWM周期一次
+ *         （单电阻时在第二次采样后调用，采样被中断推迟的周期不调用）
+ * @retval 无
+ */
+void MYADC_CurrentCallback(void);
+
+#endif
@@ -4,8 +4,19 @@
 // ==================== 静态变量（用于速度计算） ====================
 static uint16_t last_angle = 0;      // 上次角度值
 static int32_t total_turns = 0;       // 总圈数（累计）
+static int32_t total_counts = 0;      // 累计角度（计数，整数累加不丢精度）
 static float total_angle = 0.0f;      // 累计角度（浮点数）
 
+// ==================== 静态变量（单传感器异步读取） ====================
+static uint8_t async_buf[2];          // 异步读取缓冲区
+static uint8_t async_started = 0;     // 本轮是否成功启动
+
+// ==================== 静态变量（双传感器） ====================
+static uint8_t dual_buf[MYI2C_BUS_NUM][2];   // 异步读取缓冲区
+static uint8_t dual_started[MYI2C_BUS_NUM];  // 本轮是否成功启动
+static int16_t dual_offset = 0;              // 传感器2安装偏差（计数）
+static uint8_t dual_reverse = 0;             // 传感器2反向安装
+
 // ==================== 基础函数 ====================
 
 /**
@@ -29,6 +40,7 @@ uint8_t AS5600_Init(void)
 	if(AS5600_GetRawAngle(&angle) == AS5600_OK)
 	{
 		last_angle = angle;
+		total_counts = angle;
 		total_angle = (float)angle / AS5600_RESOLUTION;  // 初始化累计角度
 	}
 	
@@ -68,6 +80,49 @@ uint8_t AS5600_GetRawAngle(uint16_t *angle)
 	return AS5600_OK;
 }
 
+/**
+  * @brief  启动原始角度异步读取（中断 + DMA，不阻塞）
+  * @note   控制中断内使用：本周期启动，下周期由 AS5600_GetReadResult 取结果
+  * @retval AS5600_OK: 已启动, AS5600_ERROR: 启动失败（总线忙或故障）
+  */
+uint8_t AS5600_StartRead(void)
+{
+	async_started = (I2C_BusReadAsync(MYI2C_BUS1, AS5600_ADDR, AS5600_REG_RAW_H, async_buf, 2) == I2C_SUCCESS);
+	
+	return async_started ? AS5600_OK : AS5600_ERROR;
+}
+
+/**
+  * @brief  取上次异步读取的原始角度
+  * @note   传输未完成视为本次失败并复位总线，以免影响下一次启动
+  * @param  angle: 角度值指针（0-4095）
+  * @retval AS5600_OK: 成功, AS5600_ERROR: 未启动、未完成或传输出错
+  */
+uint8_t AS5600_GetReadResult(uint16_t *angle)
+{
+	uint8_t state;
+	
+	if(!async_started)
+	{
+		return AS5600_ERROR;
+	}
+	async_started = 0;
+	
+	state = I2C_BusGetAsyncState(MYI2C_BUS1);
+	if(state != MYI2C_ASYNC_DONE)
+	{
+		if(state == MYI2C_ASYNC_BUSY)
+		{
+			I2C_BusAbortAsync(MYI2C_BUS1);
+		}
+		return AS5600_ERROR;
+	}
+	
+	*angle = (((uint16_t)async_buf[0] << 8) | async_buf[1]) & 0x0FFF;
+	
+	return AS5600_OK;
+}
+
 /**
   * @brief  读取滤波后角度（平滑，低速推荐）
   * @param  angle: 角度值指针（0-4095）
@@ -140,6 +195,31 @@ int16_t AS5600_GetAngleDiff(uint16_t angle1, uint16_t angle2)
 
 // ==================== 速度计算 ====================
 
+/**
+  * @brief  更新多圈累计角度（需要周期调用）
+  * @note   两次调用之间转过的角度须小于半圈；
+  *         AS5600_CalculateSpeed 内部已调用，只需累计角度时单独调用本函数
+  * @param  current_angle: 当前角度（0-4095）
+  * @retval 本次角度变化量（计数，-2048 到 2047）
+  */
+int16_t AS5600_UpdateTotalAngle(uint16_t current_angle)
+{
+	// 计算角度差（处理跳变）
+	int16_t angle_diff = AS5600_GetAngleDiff(current_angle, last_angle);
+	
+	// 整数累计计数，再换算为圈数（浮点累加小增量会随圈数增大丢失精度）
+	total_counts += angle_diff;
+	total_angle = (float)total_counts / AS5600_RESOLUTION;
+	
+	// 计算整数圈数
+	total_turns = (int32_t)(total_angle);
+	
+	// 更新上次角度
+	last_angle = current_angle;
+	
+	return angle_diff;
+}
+
 /**
   * @brief  计算电机转速（需要周期调用）
   * @note   内部会累计总圈数，可以计算多圈旋转
@@ -154,17 +234,8 @@ int16_t AS5600_GetAngleDiff(uint16_t angle1, uint16_t angle2)
   */
 int32_t AS5600_CalculateSpeed(uint16_t current_angle, uint32_t dt_us)
 {
-	// 计算角度差（处理跳变）
-	int16_t angle_diff = AS5600_GetAngleDiff(current_angle, last_angle);
-	
-	// 累计角度（浮点数，精确累计）
-	total_angle += (float)angle_diff / AS5600_RESOLUTION;
-	
-	// 计算整数圈数
-	total_turns = (int32_t)(total_angle);
-	
-	// 更新上次角度
-	last_angle = current_angle;
+	// 累计多圈角度
+	int16_t angle_diff = AS5600_UpdateTotalAngle(current_angle);
 	
 	// 计算角速度（角度/秒）
 	// angle_diff: 角度变化量（单位：1/4096圈）
@@ -183,6 +254,114 @@ int32_t AS5600_CalculateSpeed(uint16_t current_angle, uint32_t dt_us)
 	return rpm;
 }
 
+/**
+  * @brief  M/T法测速器初始化
+  * @param  est: 测速器指针
+  * @param  angle: 当前角度（0-4095）
+  * @param  time_us: 当前时间戳（us）
+  * @retval 无
+  */
+void AS5600_SpeedEst_Init(AS5600_SpeedEst_t *est, uint16_t angle, uint32_t time_us)
+{
+	est->last_angle = angle;
+	est->window_counts = 0;
+	est->window_start_us = time_us;
+	est->last_edge_us = time_us;
+	est->speed_rpm = 0.0f;
+	est->method = AS5600_SPEED_METHOD_T;
+}
+
+/**
+  * @brief  M/T法测速器更新（每次采样角度后调用）
+  * @note   窗口从一次计数变化开始，到窗口时间已满后的第一次计数变化结束，
+  *         转速 = 窗口计数 / 两次计数变化的间隔：
+  *         - 高速：每个采样都有计数变化，窗口按时关闭，即M法
+  *         - 低速：计数变化间隔大于窗口，窗口延长到下一次变化，即T法
+  *         窗口未关闭时，用"至少要到下一次变化"的上限约束估计值，
+  *         减速到静止时转速平滑衰减到0，不会保持旧值
+  * @param  est: 测速器指针
+  * @param  angle: 当前角度（0-4095）
+  * @param  time_us: 采样时间戳（us）
+  * @retval 转速（RPM，正值为正转，负值为反转）
+  */
+float AS5600_SpeedEst_Update(AS5600_SpeedEst_t *est, uint16_t angle, uint32_t time_us)
+{
+	int16_t diff = AS5600_GetAngleDiff(angle, est->last_angle);
+	uint32_t elapsed;
+	
+	est->last_angle = angle;
+	
+	if(diff != 0)
+	{
+		est->window_counts += diff;
+		est->last_edge_us = time_us;
+		
+		elapsed = time_us - est->window_start_us;
+		if(elapsed >= AS5600_MT_WINDOW_US)
+		{
+			int32_t counts = est->window_counts;
+			int32_t abs_counts = (counts < 0) ? -counts : counts;
+			
+			// RPM = counts * 60 * 10^6 / (4096 * elapsed)
+			est->speed_rpm = (float)counts * 14648.4375f / (float)elapsed;
+			
+			// 方法标志带回差，避免在阈值附近来回跳动
+			if(abs_counts < AS5600_MT_T_ENTER || elapsed > 2 * AS5600_MT_WINDOW_US)
+			{
+				est->method = AS5600_SPEED_METHOD_T;
+			}
+			else if(abs_counts > AS5600_MT_M_ENTER)
+			{
+				est->method = AS5600_SPEED_METHOD_M;
+			}
+			
+			// 新窗口从本次计数变化开始
+			est->window_counts = 0;
+			est->window_start_us = time_us;
+		}
+		return est->speed_rpm;
+	}
+	
+	elapsed = time_us - est->last_edge_us;
+	if(elapsed >= AS5600_MT_TIMEOUT_US)
+	{
+		// 长时间无变化：静止
+		est->speed_rpm = 0.0f;
+		est->window_counts = 0;
+		est->window_start_us = time_us;
+		est->last_edge_us = time_us;
+		est->method = AS5600_SPEED_METHOD_T;
+	}
+	else if(elapsed > 0)
+	{
+		// 下一次变化至少还需 elapsed，转速不可能超过 1计数/elapsed
+		float limit = 14648.4375f / (float)elapsed;
+		
+		if(est->speed_rpm > limit)
+		{
+			est->speed_rpm = limit;
+			est->method = AS5600_SPEED_METHOD_T;
+		}
+		else if(est->speed_rpm < -limit)
+		{
+			est->speed_rpm = -limit;
+			est->method = AS5600_SPEED_METHOD_T;
+		}
+	}
+	
+	return est->speed_rpm;
+}
+
+/**
+  * @brief  获取当前测速方法
+  * @param  est: 测速器指针
+  * @retval AS5600_SPEED_METHOD_M 或 AS5600_SPEED_METHOD_T
+  */
+uint8_t AS5600_SpeedEst_GetMethod(const AS5600_SpeedEst_t *est)
+{
+	return est->method;
+}
+
 /**
   * @brief  获取累计圈数
   * @param  无
@@ -368,6 +547,203 @@ uint8_t AS5600_ReadAll(AS5600_Data_t *data)
 	return AS5600_OK;
 }
 
+// ==================== 双传感器冗余 ====================
+
+/**
+  * @brief  传感器2读数对齐到传感器1坐标
+  * @param  raw: 传感器2原始角度（0-4095）
+  * @retval 对齐后角度（0-4095）
+  */
+static uint16_t AS5600_Dual_Align(uint16_t raw)
+{
+	int32_t angle = dual_reverse ? (AS5600_RESOLUTION - (int32_t)raw) : (int32_t)raw;
+	
+	angle += dual_offset;
+	
+	return (uint16_t)(angle & AS5600_MAX_ANGLE);
+}
+
+/**
+  * @brief  双传感器初始化（I2C1 + I2C2）
+  * @note   I2C1: PB6/PB7，I2C2: PB10/PB11
+  * @retval AS5600_OK: 至少一路存在, AS5600_ERROR: 两路均不存在
+  */
+uint8_t AS5600_Dual_Init(void)
+{
+	uint8_t status;
+	uint8_t present = 0;
+	
+	MYI2C_BusInit(MYI2C_BUS1);
+	MYI2C_BusInit(MYI2C_BUS2);
+	
+	if(I2C_BusReadByte(MYI2C_BUS1, AS5600_ADDR, AS5600_REG_STATUS, &status) == I2C_SUCCESS) present |= 0x01;
+	if(I2C_BusReadByte(MYI2C_BUS2, AS5600_ADDR, AS5600_REG_STATUS, &status) == I2C_SUCCESS) present |= 0x02;
+	
+	return present ? AS5600_OK : AS5600_ERROR;
+}
+
+/**
+  * @brief  设置传感器2相对传感器1的安装对齐参数
+  * @param  offset: 角度偏差（计数，加到传感器2读数上）
+  * @param  reverse: 1: 传感器2反向安装
+  * @retval 无
+  */
+void AS5600_Dual_SetAlignment(int16_t offset, uint8_t reverse)
+{
+	dual_offset = offset;
+	dual_reverse = reverse;
+}
+
+/**
+  * @brief  静止状态下标定传感器2的安装偏差
+  * @note   需先通过 AS5600_Dual_SetAlignment() 设置安装方向
+  * @retval AS5600_OK: 成功, 其他: 错误代码
+  */
+uint8_t AS5600_Dual_CalibrateOffset(void)
+{
+	uint8_t data1[2], data2[2];
+	uint16_t angle1, angle2;
+	
+	if(I2C_BusRead(MYI2C_BUS1, AS5600_ADDR, AS5600_REG_RAW_H, data1, 2) != I2C_SUCCESS) return AS5600_ERROR;
+	if(I2C_BusRead(MYI2C_BUS2, AS5600_ADDR, AS5600_REG_RAW_H, data2, 2) != I2C_SUCCESS) return AS5600_ERROR;
+	
+	angle1 = (((uint16_t)data1[0] << 8) | data1[1]) & 0x0FFF;
+	angle2 = (((uint16_t)data2[0] << 8) | data2[1]) & 0x0FFF;
+	
+	dual_offset = 0;
+	dual_offset = AS5600_GetAngleDiff(angle1, AS5600_Dual_Align(angle2));
+	
+	return AS5600_OK;
+}
+
+/**
+  * @brief  同时启动两路异步读取（中断 + DMA，不阻塞）
+  * @note   两条总线并行传输，总延迟与单传感器读取相同
+  * @retval AS5600_OK: 至少一路已启动, AS5600_ERROR: 两路均启动失败
+  */
+uint8_t AS5600_Dual_StartRead(void)
+{
+	uint8_t bus;
+	uint8_t started = 0;
+	
+	for(bus = 0; bus < MYI2C_BUS_NUM; bus++)
+	{
+		dual_started[bus] = (I2C_BusReadAsync(bus, AS5600_ADDR, AS5600_REG_RAW_H, dual_buf[bus], 2) == I2C_SUCCESS);
+		started |= dual_started[bus];
+	}
+	
+	return started ? AS5600_OK : AS5600_ERROR;
+}
+
+/**
+  * @brief  查询异步读取是否结束
+  * @retval 1: 两路均已结束（成功或失败）, 0: 仍在传输
+  */
+uint8_t AS5600_Dual_IsReadDone(void)
+{
+	uint8_t bus;
+	
+	for(bus = 0; bus < MYI2C_BUS_NUM; bus++)
+	{
+		if(dual_started[bus] && I2C_BusGetAsyncState(bus) == MYI2C_ASYNC_BUSY)
+		{
+			return 0;
+		}
+	}
+	
+	return 1;
+}
+
+/**
+  * @brief  对两路读数交叉校验并表决
+  * @note   两路一致：取圆周平均；一路失效：降级使用另一路；
+  *         两路不一致：无法判断谁错，取接近参考角度的一路并计数上报
+  * @param  ref_angle: 参考角度（如上次表决结果或卡尔曼预测角度）
+  * @param  result: 表决结果结构体指针
+  * @retval AS5600_OK: 得到有效角度, AS5600_ERROR: 两路均失效
+  */
+uint8_t AS5600_Dual_Vote(uint16_t ref_angle, AS5600_Dual_t *result)
+{
+	uint8_t bus;
+	
+	result->valid = 0;
+	for(bus = 0; bus < MYI2C_BUS_NUM; bus++)
+	{
+		if(dual_started[bus] && I2C_BusGetAsyncState(bus) == MYI2C_ASYNC_DONE)
+		{
+			uint16_t raw = (((uint16_t)dual_buf[bus][0] << 8) | dual_buf[bus][1]) & 0x0FFF;
+			result->sensor_angle[bus] = (bus == MYI2C_BUS1) ? raw : AS5600_Dual_Align(raw);
+			result->valid |= (1 << bus);
+		}
+		else
+		{
+			// 未完成的传输视为失败，复位总线以免影响下一轮
+			if(dual_started[bus] && I2C_BusGetAsyncState(bus) == MYI2C_ASYNC_BUSY)
+			{
+				I2C_BusAbortAsync(bus);
+			}
+			result->fail_count[bus]++;
+		}
+		dual_started[bus] = 0;
+	}
+	
+	switch(result->valid)
+	{
+		case 0x03:
+			result->disagreement = AS5600_GetAngleDiff(result->sensor_angle[1], result->sensor_angle[0]);
+			if(result->disagreement <= AS5600_DUAL_TOLERANCE && result->disagreement >= -AS5600_DUAL_TOLERANCE)
+			{
+				result->angle = (result->sensor_angle[0] + result->disagreement / 2) & AS5600_MAX_ANGLE;
+				result->status = AS5600_DUAL_BOTH;
+			}
+			else
+			{
+				int16_t err1 = AS5600_GetAngleDiff(result->sensor_angle[0], ref_angle);
+				int16_t err2 = AS5600_GetAngleDiff(result->sensor_angle[1], ref_angle);
+				if(err1 < 0) err1 = -err1;
+				if(err2 < 0) err2 = -err2;
+				result->angle = (err1 <= err2) ? result->sensor_angle[0] : result->sensor_angle[1];
+				result->status = AS5600_DUAL_MISMATCH;
+				result->mismatch_count++;
+			}
+			return AS5600_OK;
+			
+		case 0x01:
+			result->angle = result->sensor_angle[0];
+			result->status = AS5600_DUAL_SINGLE1;
+			return AS5600_OK;
+			
+		case 0x02:
+			result->angle = result->sensor_angle[1];
+			result->status = AS5600_DUAL_SINGLE2;
+			return AS5600_OK;
+			
+		default:
+			result->status = AS5600_DUAL_FAIL;
+			return AS5600_ERROR;
+	}
+}
+
+/**
+  * @brief  并行读取两路角度并表决（启动 + 等待 + 表决）
+  * @param  ref_angle: 参考角度
+  * @param  result: 表决结果结构体指针
+  * @retval AS5600_OK: 得到有效角度, AS5600_ERROR: 两路均失效
+  */
+uint8_t AS5600_Dual_Read(uint16_t ref_angle, AS5600_Dual_t *result)
+{
+	uint32_t timeout = AS5600_DUAL_TIMEOUT;
+	
+	AS5600_Dual_StartRead();
+	
+	while(!AS5600_Dual_IsReadDone())
+	{
+		if(--timeout == 0) break;
+	}
+	
+	return AS5600_Dual_Vote(ref_angle, result);
+}
+
 /**
   * @brief  获取错误描述字符串
   * @param  error_code: 错误代码
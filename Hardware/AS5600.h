@@ -48,6 +48,28 @@
 #define AS5600_MAG_WEAK     3       // 磁铁太弱
 #define AS5600_MAG_STRONG   4       // 磁铁太强
 
+// M/T法测速参数
+#define AS5600_MT_WINDOW_US     5000    // M法计数窗口（us）
+#define AS5600_MT_TIMEOUT_US    500000  // 超过该时间无计数变化判定为静止（us）
+#define AS5600_MT_T_ENTER       12      // 窗口计数低于该值切换到T法
+#define AS5600_MT_M_ENTER       20      // 窗口计数高于该值切换回M法
+
+// 双传感器冗余（I2C1 + I2C2，两片 AS5600 地址相同，分别挂在两条总线上）
+#define AS5600_DUAL_ENABLE      0       // 1: 主程序使用双传感器表决角度
+#define AS5600_DUAL_TOLERANCE   16      // 两传感器允许偏差（计数，约1.4°）
+#define AS5600_DUAL_TIMEOUT     0xFFFF  // 异步读取等待超时（循环次数）
+
+// 双传感器表决状态
+#define AS5600_DUAL_BOTH        0       // 两路一致，取平均
+#define AS5600_DUAL_SINGLE1     1       // 仅传感器1有效（降级运行）
+#define AS5600_DUAL_SINGLE2     2       // 仅传感器2有效（降级运行）
+#define AS5600_DUAL_MISMATCH    3       // 两路不一致，取接近参考角度的一路
+#define AS5600_DUAL_FAIL        4       // 两路均失效
+
+// 测速方法
+#define AS5600_SPEED_METHOD_M   0       // M法：定窗计数（高速）
+#define AS5600_SPEED_METHOD_T   1       // T法：计数变化间隔计时（低速）
+
 // ==================== 数据结构 ====================
 /**
  * @brief AS5600 完整状态结构体
@@ -64,6 +86,34 @@ typedef struct {
     uint8_t error_code;       // 错误代码
 } AS5600_Data_t;
 
+/**
+ * @brief M/T法测速器状态结构体
+ * @note  窗口起止均对齐到角度计数变化的时刻，高速时等效M法，
+ *        低速时窗口自动延长到下一次计数变化，等效T法，两者公式一致，切换无跳变
+ */
+typedef struct {
+    uint16_t last_angle;      // 上次角度（0-4095）
+    int32_t window_counts;    // 当前窗口累计计数
+    uint32_t window_start_us; // 窗口起点（计数变化时刻，us）
+    uint32_t last_edge_us;    // 最近一次计数变化时刻（us）
+    float speed_rpm;          // 转速估计（RPM）
+    uint8_t method;           // 当前测速方法（AS5600_SPEED_METHOD_M/T）
+} AS5600_SpeedEst_t;
+
+/**
+ * @brief 双传感器表决结果结构体
+ * @note  统计计数在多次表决之间累计，调用方应长期保存该结构体
+ */
+typedef struct {
+    uint16_t angle;           // 表决后角度（0-4095）
+    uint16_t sensor_angle[2]; // 各传感器角度（传感器2已按安装偏差对齐）
+    int16_t disagreement;     // 传感器2 - 传感器1（计数）
+    uint8_t valid;            // bit0: 传感器1有效, bit1: 传感器2有效
+    uint8_t status;           // 表决状态（AS5600_DUAL_xxx）
+    uint32_t mismatch_count;  // 累计不一致次数
+    uint32_t fail_count[2];   // 各传感器累计读取失败次数
+} AS5600_Dual_t;
+
 // ==================== 基础函数 ====================
 /**
  * @brief  AS5600 初始化
@@ -85,6 +135,19 @@ uint8_t AS5600_IsConnected(void);
  */
 uint8_t AS5600_GetRawAngle(uint16_t *angle);
 
+/**
+ * @brief  启动原始角度异步读取（中断 + DMA，不阻塞）
+ * @retval AS5600_OK: 已启动, AS5600_ERROR: 启动失败
+ */
+uint8_t AS5600_StartRead(void);
+
+/**
+ * @brief  取上次异步读取的原始角度（未完成视为失败）
+ * @param  angle: 角度值指针（0-4095）
+ * @retval AS5600_OK: 成功, AS5600_ERROR: 未启动、未完成或传输出错
+ */
+uint8_t AS5600_GetReadResult(uint16_t *angle);
+
 /**
  * @brief  读取滤波后角度（平滑，低速推荐）
  * @param  angle: 角度值指针（0-4095）
@@ -116,6 +179,13 @@ float AS5600_RawToRadian(uint16_t raw_angle);
 int16_t AS5600_GetAngleDiff(uint16_t angle1, uint16_t angle2);
 
 // ==================== 速度计算 ====================
+/**
+ * @brief  更新多圈累计角度（需要周期调用，两次调用之间转过的角度须小于半圈）
+ * @param  current_angle: 当前角度（0-4095）
+ * @retval 本次角度变化量（计数，-2048 到 2047）
+ */
+int16_t AS5600_UpdateTotalAngle(uint16_t current_angle);
+
 /**
  * @brief  计算电机转速（需要周期调用）
  * @param  current_angle: 当前角度（0-4095）
@@ -124,6 +194,31 @@ int16_t AS5600_GetAngleDiff(uint16_t angle1, uint16_t angle2);
  */
 int32_t AS5600_CalculateSpeed(uint16_t current_angle, uint32_t dt_us);
 
+/**
+ * @brief  M/T法测速器初始化
+ * @param  est: 测速器指针
+ * @param  angle: 当前角度（0-4095）
+ * @param  time_us: 当前时间戳（us）
+ * @retval 无
+ */
+void AS5600_SpeedEst_Init(AS5600_SpeedEst_t *est, uint16_t angle, uint32_t time_us);
+
+/**
+ * @brief  M/T法测速器更新（每次采样角度后调用）
+ * @param  est: 测速器指针
+ * @param  angle: 当前角度（0-4095）
+ * @param  time_us: 采样时间戳（us）
+ * @retval 转速（RPM，正值为正转，负值为反转）
+ */
+float AS5600_SpeedEst_Update(AS5600_SpeedEst_t *est, uint16_t angle, uint32_t time_us);
+
+/**
+ * @brief  获取当前测速方法
+ * @param  est: 测速器指针
+ * @retval AS5600_SPEED_METHOD_M 或 AS5600_SPEED_METHOD_T
+ */
+uint8_t AS5600_SpeedEst_GetMethod(const AS5600_SpeedEst_t *est);
+
 /**
  * @brief  获取累计圈数
  * @param  无
@@ -186,6 +281,55 @@ uint8_t AS5600_GetAGC(uint8_t *agc);
  */
 uint8_t AS5600_ReadAll(AS5600_Data_t *data);
 
+// ==================== 双传感器冗余 ====================
+/**
+ * @brief  双传感器初始化（I2C1 + I2C2）
+ * @retval AS5600_OK: 至少一路存在, AS5600_ERROR: 两路均不存在
+ */
+uint8_t AS5600_Dual_Init(void);
+
+/**
+ * @brief  设置传感器2相对传感器1的安装对齐参数
+ * @param  offset: 角度偏差（计数，加到传感器2读数上）
+ * @param  reverse: 1: 传感器2反向安装
+ * @retval 无
+ */
+void AS5600_Dual_SetAlignment(int16_t offset, uint8_t reverse);
+
+/**
+ * @brief  静止状态下标定传感器2的安装偏差
+ * @retval AS5600_OK: 成功, 其他: 错误代码
+ */
+uint8_t AS5600_Dual_CalibrateOffset(void);
+
+/**
+ * @brief  同时启动两路异步读取（中断 + DMA，不阻塞）
+ * @retval AS5600_OK: 至少一路已启动, AS5600_ERROR: 两路均启动失败
+ */
+uint8_t AS5600_Dual_StartRead(void);
+
+/**
+ * @brief  查询异步读取是否结束
+ * @retval 1: 两路均已结束（成功或失败）, 0: 仍在传输
+ */
+uint8_t AS5600_Dual_IsReadDone(void);
+
+/**
+ * @brief  对两路读数交叉校验并表决
+ * @param  ref_angle: 参考角度（如上次表决结果或卡尔曼预测角度），两路不一致时择近
+ * @param  result: 表决结果结构体指针
+ * @retval AS5600_OK: 得到有效角度, AS5600_ERROR: 两路均失效
+ */
+uint8_t AS5600_Dual_Vote(uint16_t ref_angle, AS5600_Dual_t *result);
+
+/**
+ * @brief  并行读取两路角度并表决（启动 + 等待 + 表决）
+ * @param  ref_angle: 参考角度
+ * @param  result: 表决结果结构体指针
+ * @retval AS5600_OK: 得到有效角度, AS5600_ERROR: 两路均失效
+ */
+uint8_t AS5600_Dual_Read(uint16_t ref_angle, AS5600_Dual_t *result);
+
 /**
  * @brief  获取错误描述字符串
  * @param  error_code: 错误代码
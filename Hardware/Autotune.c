@@ -0,0 +1,206 @@
+#include "Autotune.h"
+#include "FOC.h"
+#include "Delay.h"
+#include "USART.h"
+
+/**
+ * @brief  等待转速稳定在目标附近
+ * @param  target: 目标转速（RPM）
+ * @param  band: 稳定判据（RPM）
+ * @param  hold_ms: 需连续保持在判据内的时间（ms）
+ * @param  timeout_ms: 超时（ms）
+ * @retval 1: 已稳定, 0: 超时或故障
+ */
+static uint8_t Autotune_WaitSettle(float target, float band, uint32_t hold_ms, uint32_t timeout_ms)
+{
+    FOC_Control_t *foc = FOC_GetControlStatus();
+    uint32_t start = Delay_GetTick();
+    uint32_t inside = start;
+    
+    while (Delay_GetTick() - start < timeout_ms) {
+        float error = foc->speed_rpm - target;
+        
+        if (foc->fault || !foc->enable) {
+            return 0;
+        }
+        if (error > band || error < -band) {
+            inside = Delay_GetTick();
+        } else if (Delay_GetTick() - inside >= hold_ms) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief  按整定规则计算PI增益
+ */
+static void Autotune_Rule(uint8_t rule, float ku, float tu, float *kp, float *ki)
+{
+    if (rule == AUTOTUNE_RULE_ZN) {
+        *kp = 0.45f * ku;
+        *ki = *kp * 1.2f / tu;
+    } else {
+        *kp = ku / 3.2f;
+        *ki = *kp / (2.2f * tu);
+    }
+}
+
+/**
+ * @brief  阶跃校验：工作点上叠加一个转速阶跃（经轨迹平滑），测量超调和稳定时间
+ * @param  setpoint: 工作点转速（RPM）
+ * @param  result: 写入 overshoot / settle_ms
+ * @retval 1: 通过, 0: 超调过大、未稳定或故障
+ */
+static uint8_t Autotune_StepTest(float setpoint, Autotune_Result_t *result)
+{
+    FOC_Control_t *foc = FOC_GetControlStatus();
+    float step = (setpoint >= 0.0f ? setpoint : -setpoint) * AUTOTUNE_STEP_RATIO;
+    float target, band, peak = 0.0f;
+    uint32_t start, tick, last_out;
+    
+    if (step < AUTOTUNE_STEP_MIN) {
+        step = AUTOTUNE_STEP_MIN;
+    }
+    if (setpoint < 0.0f) {
+        step = -step;
+    }
+    target = setpoint + step;
+    band = step * AUTOTUNE_STEP_BAND;
+    if (band < 0.0f) {
+        band = -band;
+    }
+    if (band < AUTOTUNE_RELAY_HYST) {
+        band = AUTOTUNE_RELAY_HYST;
+    }
+    
+    FOC_SetControl(target, foc->direction);
+    start = Delay_GetTick();
+    last_out = start;
+    tick = start;
+    while (tick - start < AUTOTUNE_STEP_MS) {
+        float speed = foc->speed_rpm;
+        float over = (speed - target) / step;
+        
+        if (foc->fault || !foc->enable) {
+            return 0;
+        }
+        if (over > peak) {
+            peak = over;
+        }
+        if (speed - target > band || speed - target < -band) {
+            last_out = tick;
+        }
+        while (Delay_GetTick() == tick);
+        tick = Delay_GetTick();
+    }
+    
+    result->overshoot = peak;
+    result->settle_ms = (uint16_t)(last_out - start);
+    
+    // 回到工作点
+    FOC_SetControl(setpoint, foc->direction);
+    Autotune_WaitSettle(setpoint, AUTOTUNE_SETTLE_BAND, AUTOTUNE_SETTLE_MS, AUTOTUNE_SPINUP_TIMEOUT_MS);
+    
+    // 观察窗口最后 1/5 内仍在稳定带外视为未稳定
+    return peak <= AUTOTUNE_MAX_OVERSHOOT && result->settle_ms < AUTOTUNE_STEP_MS * 4 / 5;
+}
+
+/**
+ * @brief  速度环继电反馈自整定（阻塞，约数秒）
+ * @param  setpoint: 工作点转速（RPM）
+ * @param  rule: 整定规则（AUTOTUNE_RULE_x）
+ * @param  result: 结果输出
+ * @retval AUTOTUNE_OK 或错误码
+ */
+uint8_t Autotune_Run(float setpoint, uint8_t rule, Autotune_Result_t *result)
+{
+    FOC_Control_t *foc = FOC_GetControlStatus();
+    uint8_t units = (foc->current_loop && foc->mode == FOC_MODE_FOC) ? 1 : 0;
+    float kp_old = foc->speed_kp[units];
+    float ki_old = foc->speed_ki[units];
+    float amplitude = units ? AUTOTUNE_RELAY_CURRENT : AUTOTUNE_RELAY_VOLTAGE;
+    float period_sum = 0.0f, amp_sum = 0.0f, speed_amp, error;
+    uint16_t seen = 0, n = 0;
+    uint32_t start;
+    
+    result->current_units = units;
+    result->rule = rule;
+    
+    if (!foc->enable || foc->fault || foc->ctrl_mode != FOC_CTRL_SPEED) {
+        USART1_Printf("Autotune: FOC not ready\r\n");
+        return AUTOTUNE_ERR_STATE;
+    }
+    if (foc->gain_sched[units].count) {
+        // 调度表会覆盖整定得到的固定增益
+        USART1_Printf("Autotune: gain schedule active\r\n");
+        return AUTOTUNE_ERR_STATE;
+    }
+    
+    // 1. 起转到工作点
+    USART1_Printf("Autotune: spin up to %.0f RPM (%s)\r\n", setpoint, units ? "current" : "voltage");
+    FOC_SetControl(setpoint, foc->direction);
+    if (!Autotune_WaitSettle(setpoint, AUTOTUNE_SETTLE_BAND, AUTOTUNE_SETTLE_MS, AUTOTUNE_SPINUP_TIMEOUT_MS)) {
+        USART1_Printf("Autotune: spin up failed\r\n");
+        return AUTOTUNE_ERR_SPINUP;
+    }
+    
+    // 2. 继电实验：丢弃起振周期后平均周期和振幅
+    USART1_Printf("Autotune: relay d=%.2f, hyst=%.1f RPM\r\n", amplitude, AUTOTUNE_RELAY_HYST);
+    FOC_StartRelay(setpoint, amplitude, AUTOTUNE_RELAY_HYST);
+    start = Delay_GetTick();
+    while (n < AUTOTUNE_AVG_CYCLES) {
+        error = foc->speed_rpm - setpoint;
+        if (foc->fault || !foc->enable || error > AUTOTUNE_MAX_DEV || error < -AUTOTUNE_MAX_DEV ||
+            Delay_GetTick() - start >= AUTOTUNE_RELAY_TIMEOUT_MS) {
+            FOC_StopRelay();
+            USART1_Printf("Autotune: relay failed (%d cycles, dev %.0f RPM)\r\n", seen, error);
+            return AUTOTUNE_ERR_RELAY;
+        }
+        if (foc->relay.cycles != seen) {
+            seen = foc->relay.cycles;
+            USART1_Printf("Autotune: cycle %d, Tu %.3f s, a %.1f RPM\r\n",
+                          seen, foc->relay.period, foc->relay.speed_amp);
+            if (seen > AUTOTUNE_SKIP_CYCLES) {
+                period_sum += foc->relay.period;
+                amp_sum += foc->relay.speed_amp;
+                n++;
+            }
+        }
+    }
+    FOC_StopRelay();
+    
+    // 3. 临界增益和周期（滞环修正）
+    result->tu = period_sum / n;
+    speed_amp = amp_sum / n;
+    if (speed_amp <= AUTOTUNE_RELAY_HYST) {
+        USART1_Printf("Autotune: amplitude %.1f RPM below hysteresis\r\n", speed_amp);
+        return AUTOTUNE_ERR_RELAY;
+    }
+    result->ku = 4.0f * amplitude / (PI * sqrtf(speed_amp * speed_amp - AUTOTUNE_RELAY_HYST * AUTOTUNE_RELAY_HYST));
+    USART1_Printf("Autotune: Ku %.5f, Tu %.3f s\r\n", result->ku, result->tu);
+    
+    // 4. 计算并应用PI，阶跃校验；ZN不通过时改用TL重试一次
+    while (1) {
+        Autotune_Rule(result->rule, result->ku, result->tu, &result->kp, &result->ki);
+        FOC_SetSpeedGain(units, result->kp, result->ki);
+        USART1_Printf("Autotune: rule %s, Kp %.5f, Ki %.5f\r\n",
+                      result->rule == AUTOTUNE_RULE_ZN ? "ZN" : "TL", result->kp, result->ki);
+        
+        if (Autotune_StepTest(setpoint, result)) {
+            USART1_Printf("Autotune: step OK, overshoot %.0f%%, settle %d ms\r\n",
+                          result->overshoot * 100.0f, result->settle_ms);
+            return AUTOTUNE_OK;
+        }
+        USART1_Printf("Autotune: step failed, overshoot %.0f%%, settle %d ms\r\n",
+                      result->overshoot * 100.0f, result->settle_ms);
+        if (result->rule == AUTOTUNE_RULE_TL || foc->fault) {
+            break;
+        }
+        result->rule = AUTOTUNE_RULE_TL;
+    }
+    
+    FOC_SetSpeedGain(units, kp_old, ki_old);
+    USART1_Printf("Autotune: restored previous gains\r\n");
+    return AUTOTUNE_ERR_STEP;
+}
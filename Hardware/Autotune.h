@@ -0,0 +1,70 @@
+#ifndef __AUTOTUNE_H
+#define __AUTOTUNE_H
+
+#include <stdint.h>
+
+// ==================== 配置参数 ====================
+// 继电反馈自整定：速度环输出改为 bias ± d 的继电器，转速自激振荡，
+// 振幅 a、周期 Tu 给出临界增益 Ku = 4d / (π·√(a² - ε²))（ε 为滞环），再按整定规则计算PI
+#define AUTOTUNE_AT_STARTUP        0       // 1: 上电时当前控制模式的速度环未整定则自动整定（电机会转动）
+#define AUTOTUNE_SETPOINT          300.0f  // 整定工作点转速（RPM）
+
+#define AUTOTUNE_RELAY_CURRENT     0.3f    // 继电器幅值（电流模式，A）
+#define AUTOTUNE_RELAY_VOLTAGE     1.0f    // 继电器幅值（电压模式，V）
+#define AUTOTUNE_RELAY_HYST        5.0f    // 继电器滞环（RPM），大于转速噪声
+#define AUTOTUNE_SKIP_CYCLES       2       // 丢弃的起振周期数
+#define AUTOTUNE_AVG_CYCLES        4       // 参与平均的振荡周期数
+#define AUTOTUNE_MAX_DEV           200.0f  // 转速偏离工作点上限（RPM），超出中止实验
+#define AUTOTUNE_RELAY_TIMEOUT_MS  5000    // 继电实验超时（ms）
+
+#define AUTOTUNE_SETTLE_BAND       10.0f   // 起转稳定判据（RPM）
+#define AUTOTUNE_SETTLE_MS         300     // 起转后需保持在判据内的时间（ms）
+#define AUTOTUNE_SPINUP_TIMEOUT_MS 3000    // 起转超时（ms）
+
+#define AUTOTUNE_STEP_RATIO        0.2f    // 阶跃校验幅度（相对工作点）
+#define AUTOTUNE_STEP_MIN          50.0f   // 阶跃校验最小幅度（RPM）
+#define AUTOTUNE_STEP_MS           1000    // 阶跃校验观察时间（ms）
+#define AUTOTUNE_STEP_BAND         0.05f   // 稳定带（相对阶跃幅度）
+#define AUTOTUNE_MAX_OVERSHOOT     0.3f    // 允许的最大超调（相对阶跃幅度）
+
+// 整定规则
+#define AUTOTUNE_RULE_ZN           0       // Ziegler-Nichols：Kp = 0.45·Ku，Ti = Tu / 1.2（响应快，超调大）
+#define AUTOTUNE_RULE_TL           1       // Tyreus-Luyben：Kp = Ku / 3.2，Ti = 2.2·Tu（保守，超调小）
+
+// 返回值定义
+#define AUTOTUNE_OK                0       // 成功，新增益已生效
+#define AUTOTUNE_ERR_STATE         1       // 未使能、有故障、处于位置控制或该组增益有调度表
+#define AUTOTUNE_ERR_SPINUP        2       // 起转未能稳定在工作点
+#define AUTOTUNE_ERR_RELAY         3       // 未形成稳定振荡（超时、偏离过大或振幅小于滞环）
+#define AUTOTUNE_ERR_STEP          4       // 阶跃校验未通过，已恢复原增益
+
+// ==================== 数据结构 ====================
+/**
+ * @brief 自整定结果结构体
+ */
+typedef struct {
+    uint8_t current_units;      // 整定的增益组：1=电流输出（A/RPM），0=电压输出（V/RPM）
+    uint8_t rule;               // 最终采用的整定规则
+    float ku;                   // 临界增益（输出单位/RPM）
+    float tu;                   // 临界周期（s）
+    float kp;                   // 比例增益
+    float ki;                   // 积分增益（1/s）
+    float overshoot;            // 阶跃校验超调（相对阶跃幅度）
+    uint16_t settle_ms;         // 阶跃校验稳定时间（ms）
+} Autotune_Result_t;
+
+// ==================== 函数声明 ====================
+/**
+ * @brief  速度环继电反馈自整定（阻塞，约数秒）
+ * @note   须在FOC使能、速度控制下从主循环调用；依次起转到工作点、继电实验、
+ *         按规则计算PI、阶跃校验。ZN规则校验不通过时改用TL规则重试一次；
+ *         成功后新增益保持生效，结束时转速回到工作点。过程和结果经 USART1 输出。
+ *         结果不写Flash（擦写期间中断停顿），由调用者停机后保存
+ * @param  setpoint: 工作点转速（RPM）
+ * @param  rule: 整定规则（AUTOTUNE_RULE_x）
+ * @param  result: 结果输出
+ * @retval AUTOTUNE_OK 或错误码
+ */
+uint8_t Autotune_Run(float setpoint, uint8_t rule, Autotune_Result_t *result);
+
+#endif
@@ -1,10 +1,438 @@
 #include "FOC.h"
 #include "MS8313.h"
 #include "AS5600.h"
+#include "ADC.h"
+#include "Delay.h"
+#include "stm32f10x.h"
 
 // ==================== 静态变量 ====================
 static FOC_Control_t foc_control;
 static uint8_t foc_initialized = 0;
+static uint32_t timing_version = 0;         // 已同步的PWM时序版本
+static float control_freq = FOC_CONTROL_FREQ;  // 当前控制频率（Hz）
+static int16_t sixstep_advance = 1024;         // 六步换相电压矢量相对d轴的角度（计数）：电压模式沿q轴（90°），
+                                               // 从电流模式切换时取当时的电压矢量方向
+// 四分之一周期正弦表：sin(k·π/2048)，k = 0~1024，按12位电角度查表（一周 4096 计数）
+static const float foc_sin_table[1025] = {
+    0.000000000f, 0.001533980f, 0.003067957f, 0.004601926f, 0.006135885f, 0.007669829f, 0.009203755f, 0.010737659f,
+    0.012271538f, 0.013805389f, 0.015339206f, 0.016872988f, 0.018406730f, 0.019940429f, 0.021474080f, 0.023007681f,
+    0.024541229f, 0.026074718f, 0.027608146f, 0.029141509f, 0.030674803f, 0.032208025f, 0.033741172f, 0.035274239f,
+    0.036807223f, 0.038340120f, 0.039872928f, 0.041405641f, 0.042938257f, 0.044470772f, 0.046003182f, 0.047535484f,
+    0.049067674f, 0.050599749f, 0.052131705f, 0.053663538f, 0.055195244f, 0.056726821f, 0.058258265f, 0.059789571f,
+    0.061320736f, 0.062851758f, 0.064382631f, 0.065913353f, 0.067443920f, 0.068974328f, 0.070504573f, 0.072034653f,
+    0.073564564f, 0.075094301f, 0.076623861f, 0.078153242f, 0.079682438f, 0.081211447f, 0.082740265f, 0.084268888f,
+    0.085797312f, 0.087325535f, 0.088853553f, 0.090381361f, 0.091908956f, 0.093436336f, 0.094963495f, 0.096490431f,
+    0.098017140f, 0.099543619f, 0.101069863f, 0.102595869f, 0.104121634f, 0.105647154f, 0.107172425f, 0.108697444f,
+    0.110222207f, 0.111746711f, 0.113270952f, 0.114794927f, 0.116318631f, 0.117842062f, 0.119365215f, 0.120888087f,
+    0.122410675f, 0.123932975f, 0.125454983f, 0.126976696f, 0.128498111f, 0.130019223f, 0.131540029f, 0.133060525f,
+    0.134580709f, 0.136100575f, 0.137620122f, 0.139139344f, 0.140658239f, 0.142176804f, 0.143695033f, 0.145212925f,
+    0.146730474f, 0.148247679f, 0.149764535f, 0.151281038f, 0.152797185f, 0.154312973f, 0.155828398f, 0.157343456f,
+    0.158858143f, 0.160372457f, 0.161886394f, 0.163399949f, 0.164913120f, 0.166425904f, 0.167938295f, 0.169450291f,
+    0.170961889f, 0.172473084f, 0.173983873f, 0.175494253f, 0.177004220f, 0.178513771f, 0.180022901f, 0.181531608f,
+    0.183039888f, 0.184547737f, 0.186055152f, 0.187562129f, 0.189068664f, 0.190574755f, 0.192080397f, 0.193585587f,
+    0.195090322f, 0.196594598f, 0.198098411f, 0.199601758f, 0.201104635f, 0.202607039f, 0.204108966f, 0.205610413f,
+    0.207111376f, 0.208611852f, 0.210111837f, 0.211611327f, 0.213110320f, 0.214608811f, 0.216106797f, 0.217604275f,
+    0.219101240f, 0.220597690f, 0.222093621f, 0.223589029f, 0.225083911f, 0.226578264f, 0.228072083f, 0.229565366f,
+    0.231058108f, 0.232550307f, 0.234041959f, 0.235533059f, 0.237023606f, 0.238513595f, 0.240003022f, 0.241491885f,
+    0.242980180f, 0.244467903f, 0.245955050f, 0.247441619f, 0.248927606f, 0.250413007f, 0.251897818f, 0.253382037f,
+    0.254865660f, 0.256348682f, 0.257831102f, 0.259312915f, 0.260794118f, 0.262274707f, 0.263754679f, 0.265234030f,
+    0.266712757f, 0.268190857f, 0.269668326f, 0.271145160f, 0.272621355f, 0.274096910f, 0.275571819f, 0.277046080f,
+    0.278519689f, 0.279992643f, 0.281464938f, 0.282936570f, 0.284407537f, 0.285877835f, 0.287347460f, 0.288816408f,
+    0.290284677f, 0.291752263f, 0.293219163f, 0.294685372f, 0.296150888f, 0.297615707f, 0.299079826f, 0.300543241f,
+    0.302005949f, 0.303467947f, 0.304929230f, 0.306389795f, 0.307849640f, 0.309308760f, 0.310767153f, 0.312224814f,
+    0.313681740f, 0.315137929f, 0.316593376f, 0.318048077f, 0.319502031f, 0.320955232f, 0.322407679f, 0.323859367f,
+    0.325310292f, 0.326760452f, 0.328209844f, 0.329658463f, 0.331106306f, 0.332553370f, 0.333999651f, 0.335445147f,
+    0.336889853f, 0.338333767f, 0.339776884f, 0.341219202f, 0.342660717f, 0.344101426f, 0.345541325f, 0.346980411f,
+    0.348418680f, 0.349856130f, 0.351292756f, 0.352728556f, 0.354163525f, 0.355597662f, 0.357030961f, 0.358463421f,
+    0.359895037f, 0.361325806f, 0.362755724f, 0.364184790f, 0.365612998f, 0.367040346f, 0.368466830f, 0.369892447f,
+    0.371317194f, 0.372741067f, 0.374164063f, 0.375586178f, 0.377007410f, 0.378427755f, 0.379847209f, 0.381265769f,
+    0.382683432f, 0.384100195f, 0.385516054f, 0.386931006f, 0.388345047f, 0.389758174f, 0.391170384f, 0.392581674f,
+    0.393992040f, 0.395401479f, 0.396809987f, 0.398217562f, 0.399624200f, 0.401029897f, 0.402434651f, 0.403838458f,
+    0.405241314f, 0.406643217f, 0.408044163f, 0.409444149f, 0.410843171f, 0.412241227f, 0.413638312f, 0.415034424f,
+    0.416429560f, 0.417823716f, 0.419216888f, 0.420609074f, 0.422000271f, 0.423390474f, 0.424779681f, 0.426167889f,
+    0.427555093f, 0.428941292f, 0.430326481f, 0.431710658f, 0.433093819f, 0.434475961f, 0.435857080f, 0.437237174f,
+    0.438616239f, 0.439994271f, 0.441371269f, 0.442747228f, 0.444122145f, 0.445496017f, 0.446868840f, 0.448240612f,
+    0.449611330f, 0.450980989f, 0.452349587f, 0.453717121f, 0.455083587f, 0.456448982f, 0.457813304f, 0.459176548f,
+    0.460538711f, 0.461899791f, 0.463259784f, 0.464618686f, 0.465976496f, 0.467333209f, 0.468688822f, 0.470043332f,
+    0.471396737f, 0.472749032f, 0.474100215f, 0.475450282f, 0.476799230f, 0.478147056f, 0.479493758f, 0.480839331f,
+    0.482183772f, 0.483527079f, 0.484869248f, 0.486210276f, 0.487550160f, 0.488888897f, 0.490226483f, 0.491562916f,
+    0.492898192f, 0.494232309f, 0.495565262f, 0.496897049f, 0.498227667f, 0.499557113f, 0.500885383f, 0.502212474f,
+    0.503538384f, 0.504863109f, 0.506186645f, 0.507508991f, 0.508830143f, 0.510150097f, 0.511468850f, 0.512786401f,
+    0.514102744f, 0.515417878f, 0.516731799f, 0.518044504f, 0.519355990f, 0.520666254f, 0.521975293f, 0.523283103f,
+    0.524589683f, 0.525895027f, 0.527199135f, 0.528502002f, 0.529803625f, 0.531104001f, 0.532403128f, 0.533701002f,
+    0.534997620f, 0.536292979f, 0.537587076f, 0.538879909f, 0.540171473f, 0.541461766f, 0.542750785f, 0.544038527f,
+    0.545324988f, 0.546610167f, 0.547894059f, 0.549176662f, 0.550457973f, 0.551737988f, 0.553016706f, 0.554294121f,
+    0.555570233f, 0.556845037f, 0.558118531f, 0.559390712f, 0.560661576f, 0.561931121f, 0.563199344f, 0.564466242f,
+    0.565731811f, 0.566996049f, 0.568258953f, 0.569520519f, 0.570780746f, 0.572039629f, 0.573297167f, 0.574553355f,
+    0.575808191f, 0.577061673f, 0.578313796f, 0.579564559f, 0.580813958f, 0.582061990f, 0.583308653f, 0.584553943f,
+    0.585797857f, 0.587040394f, 0.588281548f, 0.589521319f, 0.590759702f, 0.591996695f, 0.593232295f, 0.594466499f,
+    0.595699304f, 0.596930708f, 0.598160707f, 0.599389298f, 0.600616479f, 0.601842247f, 0.603066599f, 0.604289531f,
+    0.605511041f, 0.606731127f, 0.607949785f, 0.609167012f, 0.610382806f, 0.611597164f, 0.612810082f, 0.614021559f,
+    0.615231591f, 0.616440175f, 0.617647308f, 0.618852988f, 0.620057212f, 0.621259977f, 0.622461279f, 0.623661118f,
+    0.624859488f, 0.626056388f, 0.627251815f, 0.628445767f, 0.629638239f, 0.630829230f, 0.632018736f, 0.633206755f,
+    0.634393284f, 0.635578320f, 0.636761861f, 0.637943904f, 0.639124445f, 0.640303482f, 0.641481013f, 0.642657034f,
+    0.643831543f, 0.645004537f, 0.646176013f, 0.647345969f, 0.648514401f, 0.649681307f, 0.650846685f, 0.652010531f,
+    0.653172843f, 0.654333618f, 0.655492853f, 0.656650546f, 0.657806693f, 0.658961293f, 0.660114342f, 0.661265838f,
+    0.662415778f, 0.663564159f, 0.664710978f, 0.665856234f, 0.666999922f, 0.668142041f, 0.669282588f, 0.670421560f,
+    0.671558955f, 0.672694769f, 0.673829000f, 0.674961646f, 0.676092704f, 0.677222170f, 0.678350043f, 0.679476320f,
+    0.680600998f, 0.681724074f, 0.682845546f, 0.683965412f, 0.685083668f, 0.686200312f, 0.687315341f, 0.688428753f,
+    0.689540545f, 0.690650714f, 0.691759258f, 0.692866175f, 0.693971461f, 0.695075114f, 0.696177131f, 0.697277511f,
+    0.698376249f, 0.699473345f, 0.700568794f, 0.701662595f, 0.702754744f, 0.703845241f, 0.704934080f, 0.706021261f,
+    0.707106781f, 0.708190637f, 0.709272826f, 0.710353347f, 0.711432196f, 0.712509371f, 0.713584869f, 0.714658688f,
+    0.715730825f, 0.716801279f, 0.717870045f, 0.718937122f, 0.720002508f, 0.721066199f, 0.722128194f, 0.723188489f,
+    0.724247083f, 0.725303972f, 0.726359155f, 0.727412629f, 0.728464390f, 0.729514438f, 0.730562769f, 0.731609381f,
+    0.732654272f, 0.733697438f, 0.734738878f, 0.735778589f, 0.736816569f, 0.737852815f, 0.738887324f, 0.739920095f,
+    0.740951125f, 0.741980412f, 0.743007952f, 0.744033744f, 0.745057785f, 0.746080074f, 0.747100606f, 0.748119380f,
+    0.749136395f, 0.750151646f, 0.751165132f, 0.752176850f, 0.753186799f, 0.754194975f, 0.755201377f, 0.756206001f,
+    0.757208847f, 0.758209910f, 0.759209189f, 0.760206682f, 0.761202385f, 0.762196298f, 0.763188417f, 0.764178741f,
+    0.765167266f, 0.766153990f, 0.767138912f, 0.768122029f, 0.769103338f, 0.770082837f, 0.771060524f, 0.772036397f,
+    0.773010453f, 0.773982691f, 0.774953107f, 0.775921699f, 0.776888466f, 0.777853404f, 0.778816512f, 0.779777788f,
+    0.780737229f, 0.781694832f, 0.782650596f, 0.783604519f, 0.784556597f, 0.785506830f, 0.786455214f, 0.787401747f,
+    0.788346428f, 0.789289253f, 0.790230221f, 0.791169330f, 0.792106577f, 0.793041960f, 0.793975478f, 0.794907126f,
+    0.795836905f, 0.796764810f, 0.797690841f, 0.798614995f, 0.799537269f, 0.800457662f, 0.801376172f, 0.802292796f,
+    0.803207531f, 0.804120377f, 0.805031331f, 0.805940391f, 0.806847554f, 0.807752818f, 0.808656182f, 0.809557642f,
+    0.810457198f, 0.811354847f, 0.812250587f, 0.813144415f, 0.814036330f, 0.814926329f, 0.815814411f, 0.816700573f,
+    0.817584813f, 0.818467130f, 0.819347520f, 0.820225983f, 0.821102515f, 0.821977115f, 0.822849781f, 0.823720511f,
+    0.824589303f, 0.825456154f, 0.826321063f, 0.827184027f, 0.828045045f, 0.828904115f, 0.829761234f, 0.830616400f,
+    0.831469612f, 0.832320868f, 0.833170165f, 0.834017501f, 0.834862875f, 0.835706284f, 0.836547727f, 0.837387202f,
+    0.838224706f, 0.839060237f, 0.839893794f, 0.840725375f, 0.841554977f, 0.842382600f, 0.843208240f, 0.844031895f,
+    0.844853565f, 0.845673247f, 0.846490939f, 0.847306639f, 0.848120345f, 0.848932055f, 0.849741768f, 0.850549481f,
+    0.851355193f, 0.852158902f, 0.852960605f, 0.853760301f, 0.854557988f, 0.855353665f, 0.856147328f, 0.856938977f,
+    0.857728610f, 0.858516224f, 0.859301818f, 0.860085390f, 0.860866939f, 0.861646461f, 0.862423956f, 0.863199422f,
+    0.863972856f, 0.864744258f, 0.865513624f, 0.866280954f, 0.867046246f, 0.867809497f, 0.868570706f, 0.869329871f,
+    0.870086991f, 0.870842063f, 0.871595087f, 0.872346059f, 0.873094978f, 0.873841843f, 0.874586652f, 0.875329403f,
+    0.876070094f, 0.876808724f, 0.877545290f, 0.878279792f, 0.879012226f, 0.879742593f, 0.880470889f, 0.881197113f,
+    0.881921264f, 0.882643340f, 0.883363339f, 0.884081259f, 0.884797098f, 0.885510856f, 0.886222530f, 0.886932119f,
+    0.887639620f, 0.888345033f, 0.889048356f, 0.889749586f, 0.890448723f, 0.891145765f, 0.891840709f, 0.892533555f,
+    0.893224301f, 0.893912945f, 0.894599486f, 0.895283921f, 0.895966250f, 0.896646470f, 0.897324581f, 0.898000580f,
+    0.898674466f, 0.899346237f, 0.900015892f, 0.900683429f, 0.901348847f, 0.902012144f, 0.902673318f, 0.903332368f,
+    0.903989293f, 0.904644091f, 0.905296759f, 0.905947298f, 0.906595705f, 0.907241978f, 0.907886116f, 0.908528119f,
+    0.909167983f, 0.909805708f, 0.910441292f, 0.911074734f, 0.911706032f, 0.912335185f, 0.912962190f, 0.913587048f,
+    0.914209756f, 0.914830312f, 0.915448716f, 0.916064966f, 0.916679060f, 0.917290997f, 0.917900776f, 0.918508394f,
+    0.919113852f, 0.919717146f, 0.920318277f, 0.920917242f, 0.921514039f, 0.922108669f, 0.922701128f, 0.923291417f,
+    0.923879533f, 0.924465474f, 0.925049241f, 0.925630831f, 0.926210242f, 0.926787474f, 0.927362526f, 0.927935395f,
+    0.928506080f, 0.929074581f, 0.929640896f, 0.930205023f, 0.930766961f, 0.931326709f, 0.931884266f, 0.932439629f,
+    0.932992799f, 0.933543773f, 0.934092550f, 0.934639130f, 0.935183510f, 0.935725689f, 0.936265667f, 0.936803442f,
+    0.937339012f, 0.937872376f, 0.938403534f, 0.938932484f, 0.939459224f, 0.939983753f, 0.940506071f, 0.941026175f,
+    0.941544065f, 0.942059740f, 0.942573198f, 0.943084437f, 0.943593458f, 0.944100258f, 0.944604837f, 0.945107193f,
+    0.945607325f, 0.946105232f, 0.946600913f, 0.947094366f, 0.947585591f, 0.948074586f, 0.948561350f, 0.949045882f,
+    0.949528181f, 0.950008245f, 0.950486074f, 0.950961666f, 0.951435021f, 0.951906137f, 0.952375013f, 0.952841648f,
+    0.953306040f, 0.953768190f, 0.954228095f, 0.954685755f, 0.955141168f, 0.955594334f, 0.956045251f, 0.956493919f,
+    0.956940336f, 0.957384501f, 0.957826413f, 0.958266071f, 0.958703475f, 0.959138622f, 0.959571513f, 0.960002146f,
+    0.960430519f, 0.960856633f, 0.961280486f, 0.961702077f, 0.962121404f, 0.962538468f, 0.962953267f, 0.963365800f,
+    0.963776066f, 0.964184064f, 0.964589793f, 0.964993253f, 0.965394442f, 0.965793359f, 0.966190003f, 0.966584374f,
+    0.966976471f, 0.967366292f, 0.967753837f, 0.968139105f, 0.968522094f, 0.968902805f, 0.969281235f, 0.969657385f,
+    0.970031253f, 0.970402839f, 0.970772141f, 0.971139158f, 0.971503891f, 0.971866337f, 0.972226497f, 0.972584369f,
+    0.972939952f, 0.973293246f, 0.973644250f, 0.973992962f, 0.974339383f, 0.974683511f, 0.975025345f, 0.975364885f,
+    0.975702130f, 0.976037079f, 0.976369731f, 0.976700086f, 0.977028143f, 0.977353900f, 0.977677358f, 0.977998515f,
+    0.978317371f, 0.978633924f, 0.978948175f, 0.979260123f, 0.979569766f, 0.979877104f, 0.980182136f, 0.980484862f,
+    0.980785280f, 0.981083391f, 0.981379193f, 0.981672686f, 0.981963869f, 0.982252741f, 0.982539302f, 0.982823551f,
+    0.983105487f, 0.983385110f, 0.983662419f, 0.983937413f, 0.984210092f, 0.984480455f, 0.984748502f, 0.985014231f,
+    0.985277642f, 0.985538735f, 0.985797509f, 0.986053963f, 0.986308097f, 0.986559910f, 0.986809402f, 0.987056571f,
+    0.987301418f, 0.987543942f, 0.987784142f, 0.988022017f, 0.988257568f, 0.988490793f, 0.988721692f, 0.988950265f,
+    0.989176510f, 0.989400428f, 0.989622017f, 0.989841278f, 0.990058210f, 0.990272812f, 0.990485084f, 0.990695025f,
+    0.990902635f, 0.991107914f, 0.991310860f, 0.991511473f, 0.991709754f, 0.991905700f, 0.992099313f, 0.992290591f,
+    0.992479535f, 0.992666142f, 0.992850414f, 0.993032350f, 0.993211949f, 0.993389211f, 0.993564136f, 0.993736722f,
+    0.993906970f, 0.994074879f, 0.994240449f, 0.994403680f, 0.994564571f, 0.994723121f, 0.994879331f, 0.995033199f,
+    0.995184727f, 0.995333912f, 0.995480755f, 0.995625256f, 0.995767414f, 0.995907229f, 0.996044701f, 0.996179829f,
+    0.996312612f, 0.996443051f, 0.996571146f, 0.996696895f, 0.996820299f, 0.996941358f, 0.997060070f, 0.997176437f,
+    0.997290457f, 0.997402130f, 0.997511456f, 0.997618435f, 0.997723067f, 0.997825350f, 0.997925286f, 0.998022874f,
+    0.998118113f, 0.998211003f, 0.998301545f, 0.998389737f, 0.998475581f, 0.998559074f, 0.998640218f, 0.998719012f,
+    0.998795456f, 0.998869550f, 0.998941293f, 0.999010686f, 0.999077728f, 0.999142419f, 0.999204759f, 0.999264747f,
+    0.999322385f, 0.999377670f, 0.999430605f, 0.999481187f, 0.999529418f, 0.999575296f, 0.999618822f, 0.999659997f,
+    0.999698819f, 0.999735288f, 0.999769405f, 0.999801170f, 0.999830582f, 0.999857641f, 0.999882347f, 0.999904701f,
+    0.999924702f, 0.999942350f, 0.999957645f, 0.999970586f, 0.999981175f, 0.999989411f, 0.999995294f, 0.999998823f,
+    1.000000000f
+};
+
+// ==================== 私有函数声明 ====================
+static void FOC_UpdateTiming(uint8_t force);
+static void FOC_SpeedPI_Config(uint8_t current_units, float preset);
+static void FOC_GainSchedule_Update(float speed);
+static void FOC_PositionControl(void);
+static float FOC_Relay_Update(float speed_rpm);
+static uint8_t FOC_CalAccumulate(uint16_t samples, float mean[3], uint32_t start);
+static uint8_t FOC_CheckFault(void);
+static void FOC_VoltageFF_Update(void);
+static void FOC_TorqueFF_Update(void);
+static void FOC_Feedforward_Update(void);
+static void FOC_DOB_Update(float speed_rpm);
+
+/**
+ * @brief  同步PWM时序
+ * @note   PWM频率修改生效后，按实际控制频率更新速度环、位置环和轨迹的更新周期，
+ *         按新PWM频率更新电流环采样周期，按新周期值重算死区补偿计数
+ * @param  force: 1=忽略版本号强制同步
+ */
+static void FOC_UpdateTiming(uint8_t force)
+{
+    const MS8313_Timing_t *timing = MS8313_GetTiming();
+    
+    if (!force && timing->version == timing_version) {
+        return;
+    }
+    timing_version = timing->version;
+    
+    control_freq = timing->control_freq;
+    PID_SetDt(&foc_control.speed_pi, 1.0f / control_freq);
+    Traj_SetDt(&foc_control.traj, 1.0f / control_freq);
+    PID_SetDt(&foc_control.pos_pi, FOC_POS_DIVIDER / control_freq);
+    
+    // 电流环参数由更高优先级的电流采样中断使用，整组更新
+    NVIC_DisableIRQ(ADC1_2_IRQn);
+    PID_SetDt(&foc_control.id_pi, 1.0f / timing->pwm_freq);
+    PID_SetDt(&foc_control.iq_pi, 1.0f / timing->pwm_freq);
+    
+    foc_control.dead_time.comp_counts = foc_control.dead_time.error_ns * 1e-9f
+                                        * timing->pwm_freq * timing->period;
+    
+    FOC_SetSampleWindow(foc_control.sampling.window_ns, foc_control.sampling.min_pulse_ns);
+    NVIC_EnableIRQ(ADC1_2_IRQn);
+}
+
+/**
+ * @brief  刷新故障码
+ * @note   硬件关断已在过流/刹车中断中完成，这里锁存到控制结构体并停止控制，
+ *         避免输出关断后积分器继续累积。由控制周期（禁用时也执行）、电流环和 FOC_Enable 调用
+ * @retval 当前故障码
+ */
+static uint8_t FOC_CheckFault(void)
+{
+    if (MYADC_GetFault()) {
+        foc_control.fault |= FOC_FAULT_OVERCURRENT;
+    }
+    if (MS8313_GetFault()) {
+        foc_control.fault |= FOC_FAULT_BREAK;
+    }
+    if (foc_control.fault) {
+        foc_control.enable = 0;
+    }
+    return foc_control.fault;
+}
+
+/**
+ * @brief  计算电压前馈
+ * @note   电流模式：vd_ff = -ω·Lq·iq，vq_ff = ω·(λ + Ld·id)，随电流采样在电流环中更新；
+ *         电压模式和六步换相只有反电势项 vq_ff = ω·λ，叠加扰动观测器的补偿电压，
+ *         随速度环在控制周期中更新
+ */
+static void FOC_VoltageFF_Update(void)
+{
+    if (!foc_control.ff_enable) {
+        foc_control.vd_ff = 0.0f;
+        foc_control.vq_ff = 0.0f;
+    } else if (foc_control.current_loop && foc_control.mode == FOC_MODE_FOC) {
+        foc_control.vd_ff = -foc_control.omega_e * foc_control.motor.lq * foc_control.iq;
+        foc_control.vq_ff = foc_control.omega_e * (foc_control.motor.flux + foc_control.motor.ld * foc_control.id);
+    } else {
+        foc_control.vd_ff = 0.0f;
+        foc_control.vq_ff = foc_control.omega_e * foc_control.motor.flux;
+    }
+    
+    if (!(foc_control.current_loop && foc_control.mode == FOC_MODE_FOC)) {
+        foc_control.vq_ff += foc_control.dob.iq_comp * foc_control.motor.rs;
+    }
+}
+
+/**
+ * @brief  计算转矩前馈（控制频率）
+ * @note   仅电流模式：按轨迹 iq_ff = (J·α + B·ω) / Kt，Kt = 1.5·p·λ，
+ *         叠加扰动观测器的补偿电流；轨迹和观测器每个控制周期更新一次
+ */
+static void FOC_TorqueFF_Update(void)
+{
+    float kt = 1.5f * foc_control.motor.pole_pairs * foc_control.motor.flux;
+    
+    foc_control.iq_ff = 0.0f;
+    if (!(foc_control.current_loop && foc_control.mode == FOC_MODE_FOC)) {
+        return;
+    }
+    if (foc_control.ff_enable && kt > 0.0f) {
+        foc_control.iq_ff = (foc_control.motor.inertia * foc_control.traj.acc
+                             + foc_control.motor.friction * foc_control.traj.vel) * (2.0f * PI) / kt;
+    }
+    foc_control.iq_ff += foc_control.dob.iq_comp;
+}
+
+/**
+ * @brief  计算全部模型前馈
+ * @note   模式切换和前馈开关时预置积分用；电流模式下调用者须屏蔽电流采样中断
+ */
+static void FOC_Feedforward_Update(void)
+{
+    FOC_VoltageFF_Update();
+    FOC_TorqueFF_Update();
+}
+
+/**
+ * @brief  负载转矩扰动观测器（控制频率）
+ * @note   J·dω/dt = Te - B·ω - Tl，一阶低通 dT̂/dt = g·(Tl - T̂)；
+ *         令 z = T̂ + g·J·ω 消去 dω/dt：dz/dt = g·(Te - B·ω + g·J·ω - z)。
+ *         Te 取上一周期的转矩指令（本周期转速是它作用的结果）：
+ *         电流模式 Kt·iq_ref，电压模式 Kt·(V - ω·λ) / Rs（忽略电感）
+ * @param  speed_rpm: 实际转速（RPM）
+ */
+static void FOC_DOB_Update(float speed_rpm)
+{
+    FOC_DOB_t *dob = &foc_control.dob;
+    float kt = 1.5f * foc_control.motor.pole_pairs * foc_control.motor.flux;
+    float j = foc_control.motor.inertia;
+    float omega = speed_rpm * (2.0f * PI / 60.0f);
+    float iq_cmd, gdt;
+    
+    if (!dob->enable || kt <= 0.0f || j <= 0.0f || foc_control.motor.rs <= 0.0f) {
+        dob->initialized = 0;
+        dob->torque = 0.0f;
+        dob->iq_comp = 0.0f;
+        return;
+    }
+    
+    if (foc_control.current_loop && foc_control.mode == FOC_MODE_FOC) {
+        iq_cmd = foc_control.iq_ref;
+    } else {
+        iq_cmd = (foc_control.voltage_ref - foc_control.omega_e * foc_control.motor.flux) / foc_control.motor.rs;
+    }
+    
+    if (!dob->initialized) {
+        dob->z = dob->g * j * omega;
+        dob->initialized = 1;
+    }
+    gdt = dob->g / control_freq;
+    if (gdt > 1.0f) {
+        gdt = 1.0f;
+    }
+    dob->z += gdt * (kt * iq_cmd - foc_control.motor.friction * omega + dob->g * j * omega - dob->z);
+    dob->torque = dob->z - dob->g * j * omega;
+    
+    dob->iq_comp = FOC_LimitVoltage(dob->gain * dob->torque / kt, -FOC_MAX_CURRENT, FOC_MAX_CURRENT);
+}
+
+/**
+ * @brief  配置速度环输出单位
+ * @note   电流模式下速度环输出 iq 参考（A），电压模式和六步换相下输出电压（V）；
+ *         切换时预置积分项为当前输出，实现无扰切换
+ * @param  current_units: 1=电流（A）, 0=电压（V）
+ * @param  preset: 积分项预置值
+ */
+static void FOC_SpeedPI_Config(uint8_t current_units, float preset)
+{
+    if (current_units) {
+        PID_Init(&foc_control.speed_pi, foc_control.speed_kp[1], foc_control.speed_ki[1], 0.0f,
+                 1.0f / control_freq, FOC_MAX_CURRENT, -FOC_MAX_CURRENT);
+    } else {
+        PID_Init(&foc_control.speed_pi, foc_control.speed_kp[0], foc_control.speed_ki[0], 0.0f,
+                 1.0f / control_freq, PI_SPEED_MAX, PI_SPEED_MIN);
+    }
+    PID_Reset(&foc_control.speed_pi, preset);
+}
+
+/**
+ * @brief  速度环增益调度（控制频率）
+ * @note   按当前输出单位选表；区间索引从上次位置移动，插值用预计算斜率，
+ *         增益不变（两端之外、转速不变）时不调用 PID_SetGains
+ * @param  speed: 调度转速（RPM，绝对值）
+ */
+static void FOC_GainSchedule_Update(float speed)
+{
+    FOC_GainSched_t *gs = &foc_control.gain_sched[foc_control.current_loop && foc_control.mode == FOC_MODE_FOC];
+    uint8_t i = gs->index;
+    float ds, kp, ki;
+    
+    if (gs->count < 2) {
+        return;
+    }
+    
+    while (i > 0 && speed < gs->speed[i]) {
+        i--;
+    }
+    while (i < gs->count - 2 && speed >= gs->speed[i + 1]) {
+        i++;
+    }
+    gs->index = i;
+    
+    // 两端之外保持端点增益
+    if (speed <= gs->speed[i]) {
+        ds = 0.0f;
+    } else if (speed >= gs->speed[i + 1]) {
+        ds = gs->speed[i + 1] - gs->speed[i];
+    } else {
+        ds = speed - gs->speed[i];
+    }
+    kp = gs->kp[i] + gs->kp_slope[i] * ds;
+    ki = gs->ki[i] + gs->ki_slope[i] * ds;
+    
+    if (kp != foc_control.speed_pi.kp || ki != foc_control.speed_pi.ki) {
+        PID_SetGains(&foc_control.speed_pi, kp, ki, 0.0f);
+    }
+}
+
+/**
+ * @brief  继电反馈实验（控制频率）
+ * @note   误差超出滞环时切换继电器；输出从负切到正时一个振荡周期结束，
+ *         记录周期和本周期转速峰峰值的一半
+ * @param  speed_rpm: 实际转速（RPM）
+ * @retval 速度环输出（A 或 V，不含前馈）
+ */
+static float FOC_Relay_Update(float speed_rpm)
+{
+    FOC_Relay_t *relay = &foc_control.relay;
+    float error = relay->setpoint - speed_rpm;
+    
+    relay->count++;
+    if (speed_rpm > relay->speed_max) {
+        relay->speed_max = speed_rpm;
+    }
+    if (speed_rpm < relay->speed_min) {
+        relay->speed_min = speed_rpm;
+    }
+    
+    if (relay->state > 0 && error < -relay->hysteresis) {
+        relay->state = -1;
+    } else if (relay->state < 0 && error > relay->hysteresis) {
+        relay->state = 1;
+        if (relay->last_rise) {
+            relay->period = (relay->count - relay->last_rise) / control_freq;
+            relay->speed_amp = (relay->speed_max - relay->speed_min) * 0.5f;
+            relay->cycles++;
+        }
+        relay->last_rise = relay->count;
+        relay->speed_max = speed_rpm;
+        relay->speed_min = speed_rpm;
+    }
+    
+    return relay->bias + relay->state * relay->amplitude;
+}
+
+/**
+ * @brief  位置环（控制频率 / FOC_POS_DIVIDER）
+ * @note   跟踪轨迹位置，输出叠加到轨迹速度前馈上的转速修正；
+ *         轨迹结束后误差在死区内不修正，避免传感器噪声引起来回抖动；
+ *         FOC_HOLD_SPEED 到位后不再修正位置，由速度环保持零速
+ */
+static void FOC_PositionControl(void)
+{
+    float error;
+    
+    if (++foc_control.pos_count < FOC_POS_DIVIDER) {
+        return;
+    }
+    foc_control.pos_count = 0;
+    
+    error = foc_control.traj.pos - foc_control.pos_actual;
+    if (!foc_control.traj.done) {
+        foc_control.in_position = 0;
+    } else if (foc_control.hold_mode == FOC_HOLD_SPEED) {
+        foc_control.in_position |= (fabsf(error) <= foc_control.pos_deadband);
+    } else {
+        foc_control.in_position = (fabsf(error) <= foc_control.pos_deadband);
+    }
+    
+    if (foc_control.in_position) {
+        foc_control.pos_corr = 0.0f;
+        return;
+    }
+    foc_control.pos_corr = PID_Update(&foc_control.pos_pi, foc_control.traj.pos, foc_control.pos_actual, 0.0f);
+}
 
 // ==================== 初始化函数 ====================
 
@@ -16,26 +444,112 @@ void FOC_Init(void)
 {
     // 初始化控制结构体
     foc_control.angle = 0;
+    foc_control.angle_offset = 0;
+    foc_control.loop_count = 0;
     foc_control.speed_rpm = 0.0f;
     foc_control.speed_ref = 0.0f;
+    foc_control.speed_target = 0.0f;
     foc_control.voltage_ref = 0.0f;
+    foc_control.vbus = MYADC_VBUS_NOMINAL;
+    foc_control.vbus_inv = 1.0f / MYADC_VBUS_NOMINAL;
     foc_control.theta = 0.0f;
     foc_control.valpha = 0.0f;
     foc_control.vbeta = 0.0f;
     foc_control.vd = 0.0f;
     foc_control.vq = 0.0f;
+    foc_control.current_loop = FOC_CURRENT_LOOP;
+    foc_control.ialpha = 0.0f;
+    foc_control.ibeta = 0.0f;
+    foc_control.id = 0.0f;
+    foc_control.iq = 0.0f;
+    foc_control.id_ref = 0.0f;
+    foc_control.iq_ref = 0.0f;
     foc_control.pwm_a = 0;
     foc_control.pwm_b = 0;
     foc_control.pwm_c = 0;
     foc_control.enable = 0;
     foc_control.direction = 0;
+    foc_control.mode = FOC_MODE_FOC;
+    foc_control.fault = FOC_FAULT_NONE;
+    foc_control.omega_e = 0.0f;
+    foc_control.vd_ff = 0.0f;
+    foc_control.vq_ff = 0.0f;
+    foc_control.iq_ff = 0.0f;
+    foc_control.ff_enable = FOC_FEEDFORWARD;
+    foc_control.dob.enable = FOC_DOB_ENABLE;
+    foc_control.dob.cutoff = FOC_DOB_CUTOFF;
+    foc_control.dob.g = 2.0f * PI * FOC_DOB_CUTOFF;
+    foc_control.dob.gain = FOC_DOB_GAIN;
+    foc_control.dob.initialized = 0;
+    foc_control.dob.torque = 0.0f;
+    foc_control.dob.iq_comp = 0.0f;
+    foc_control.motor.rs = FOC_MOTOR_RS;
+    foc_control.motor.ld = FOC_MOTOR_LD;
+    foc_control.motor.lq = FOC_MOTOR_LQ;
+    foc_control.motor.flux = FOC_MOTOR_FLUX;
+    foc_control.motor.inertia = FOC_MOTOR_INERTIA;
+    foc_control.motor.friction = FOC_MOTOR_FRICTION;
+    foc_control.motor.pole_pairs = FOC_MOTOR_POLE_PAIRS;
+    foc_control.sixstep_enter_rpm = FOC_SIXSTEP_ENTER_RPM;
+    foc_control.sixstep_exit_rpm = FOC_SIXSTEP_EXIT_RPM;
+    
+    // 初始化速度环PI控制器（输出单位随控制模式）
+    foc_control.speed_kp[0] = PI_SPEED_KP;
+    foc_control.speed_ki[0] = PI_SPEED_KI;
+    foc_control.speed_kp[1] = PI_SPEED_IQ_KP;
+    foc_control.speed_ki[1] = PI_SPEED_IQ_KI;
+    foc_control.gain_sched[0].count = 0;
+    foc_control.gain_sched[1].count = 0;
+    foc_control.relay.active = 0;
+    control_freq = FOC_CONTROL_FREQ;
+    FOC_SpeedPI_Config(foc_control.current_loop, 0.0f);
+    
+    // 初始化转速轨迹
+    Traj_Init(&foc_control.traj, 1.0f / FOC_CONTROL_FREQ, FOC_MAX_SPEED / 60.0f,
+              FOC_TRAJ_ACCEL / 60.0f, FOC_TRAJ_DECEL / 60.0f, FOC_TRAJ_JERK / 60.0f);
+    
+    // 初始化位置环（默认速度控制）
+    foc_control.ctrl_mode = FOC_CTRL_SPEED;
+    foc_control.hold_mode = FOC_POS_HOLD;
+    foc_control.in_position = 0;
+    foc_control.pos_count = 0;
+    foc_control.pos_target = 0.0f;
+    foc_control.pos_actual = 0.0f;
+    foc_control.pos_deadband = FOC_POS_DEADBAND;
+    foc_control.pos_move_speed = FOC_POS_MOVE_SPEED;
+    foc_control.pos_corr = 0.0f;
+    PID_Init(&foc_control.pos_pi, FOC_POS_KP, FOC_POS_KI, 0.0f, (float)FOC_POS_DIVIDER / FOC_CONTROL_FREQ,
+             FOC_POS_MAX_CORR, -FOC_POS_MAX_CORR);
     
-    // 初始化速度环PI控制器
-    FOC_PI_Init(&foc_control.speed_pi, PI_SPEED_KP, PI_SPEED_KI, PI_SPEED_MAX, PI_SPEED_MIN);
+    // 初始化d/q电流环PI控制器（输出电压）
+    PID_Init(&foc_control.id_pi, PI_CURRENT_KP, PI_CURRENT_KI, 0.0f, 1.0f / MS8313_PWM_FREQ,
+             FOC_MAX_VOLTAGE, -FOC_MAX_VOLTAGE);
+    PID_Init(&foc_control.iq_pi, PI_CURRENT_KP, PI_CURRENT_KI, 0.0f, 1.0f / MS8313_PWM_FREQ,
+             FOC_MAX_VOLTAGE, -FOC_MAX_VOLTAGE);
+    
+    // 初始化死区补偿
+    foc_control.dead_time.current_band = FOC_DT_CURRENT_BAND;
+    foc_control.dead_time.est_band = FOC_DT_EST_BAND;
+    foc_control.dead_time.current_valid = 0;
+    foc_control.dead_time.comp_a = 0.0f;
+    foc_control.dead_time.comp_b = 0.0f;
+    foc_control.dead_time.comp_c = 0.0f;
+    FOC_DeadTime_Config(FOC_DT_DEADTIME_NS, FOC_DT_TON_DELAY_NS, FOC_DT_TOFF_DELAY_NS, FOC_DT_EST_LAG);
+    foc_control.dead_time.enable = 1;
+    
+    // 初始化采样窗口（计数在 MS8313_Init 之后按PWM时序换算）
+    foc_control.sampling.window_ns = FOC_SAMPLE_WINDOW_NS;
+    foc_control.sampling.min_pulse_ns = FOC_MIN_PULSE_NS;
+    foc_control.sampling.ss_window_ns = FOC_SS_WINDOW_NS;
+    foc_control.sampling.ss_sample_ns = FOC_SS_SAMPLE_NS;
+    foc_control.sampling.unsampled = 0;
     
     // 初始化MS8313
     MS8313_Init();
     
+    // 采样周期同步到当前PWM时序
+    FOC_UpdateTiming(1);
+    
     // 标记已初始化
     foc_initialized = 1;
 }
@@ -117,9 +631,9 @@ uint8_t FOC_SVPWM_GetSector(float valpha, float vbeta)
             }
         } else {
             if (vbeta <= -SQRT3 * valpha) {
-                sector = 2;
-            } else {
                 sector = 3;
+            } else {
+                sector = 2;
             }
         }
     } else {
@@ -143,8 +657,10 @@ uint8_t FOC_SVPWM_GetSector(float valpha, float vbeta)
 
 /**
  * @brief  SVPWM矢量时间计算
- * @param  valpha: α轴电压
- * @param  vbeta: β轴电压
+ * @note   输入已乘以 √3·周期值/Vbus，有效矢量作用时间直接为计数：
+ *         扇区n内 t1 = |V|·sin(60° - φ)，t2 = |V|·sin(φ)，φ为相对扇区起始边的角度
+ * @param  valpha: α轴电压（已按 √3·周期值/Vbus 归一化为计数）
+ * @param  vbeta: β轴电压（已归一化为计数）
  * @param  sector: 扇区号
  * @param  t1: 矢量1时间指针
  * @param  t2: 矢量2时间指针
@@ -155,38 +671,39 @@ void FOC_SVPWM_CalculateTimes(float valpha, float vbeta, uint8_t sector,
                               float *t1, float *t2, float *t0)
 {
     float x, y, z;
+    float period;
     
-    // 计算中间变量
+    // 计算中间变量（|V|·sin(θ)、|V|·sin(θ + 60°)、|V|·sin(θ - 60°)）
     x = vbeta;
-    y = (SQRT3 * valpha - vbeta) * 0.5f;
-    z = (-SQRT3 * valpha - vbeta) * 0.5f;
+    y = (SQRT3 * valpha + vbeta) * 0.5f;
+    z = (-SQRT3 * valpha + vbeta) * 0.5f;
     
     // 根据扇区计算时间
     switch (sector) {
         case 1:
-            *t1 = z;
-            *t2 = y;
+            *t1 = -z;
+            *t2 = x;
             break;
         case 2:
             *t1 = y;
-            *t2 = -x;
+            *t2 = z;
             break;
         case 3:
-            *t1 = -z;
-            *t2 = x;
+            *t1 = x;
+            *t2 = -y;
             break;
         case 4:
-            *t1 = -x;
-            *t2 = z;
+            *t1 = z;
+            *t2 = -x;
             break;
         case 5:
-            *t1 = x;
-            *t2 = -y;
-            break;
-        case 6:
             *t1 = -y;
             *t2 = -z;
             break;
+        case 6:
+            *t1 = -x;
+            *t2 = y;
+            break;
         default:
             *t1 = 0;
             *t2 = 0;
@@ -194,11 +711,12 @@ void FOC_SVPWM_CalculateTimes(float valpha, float vbeta, uint8_t sector,
     }
     
     // 计算零矢量时间
-    *t0 = FOC_PWM_PERIOD - *t1 - *t2;
+    period = MS8313_GetTiming()->period;
+    *t0 = period - *t1 - *t2;
     
     // 时间限制
     if (*t0 < 0) {
-        float scale = FOC_PWM_PERIOD / (*t1 + *t2);
+        float scale = period / (*t1 + *t2);
         *t1 *= scale;
         *t2 *= scale;
         *t0 = 0;
@@ -207,6 +725,9 @@ void FOC_SVPWM_CalculateTimes(float valpha, float vbeta, uint8_t sector,
 
 /**
  * @brief  SVPWM PWM生成
+ * @note   七段式对称调制：零矢量时间在 V0(000) 和 V7(111) 间平分，
+ *         每相导通时间 = 该相参与的有效矢量时间 + t0/2；
+ *         中心对齐PWM使各相脉冲自动以周期中点对称
  * @param  sector: 扇区号
  * @param  t1: 矢量1时间
  * @param  t2: 矢量2时间
@@ -220,43 +741,44 @@ void FOC_SVPWM_GeneratePWM(uint8_t sector, float t1, float t2, float t0,
                           uint16_t *pwm_a, uint16_t *pwm_b, uint16_t *pwm_c)
 {
     float ta, tb, tc;
+    float half_t0 = t0 * 0.5f;
     
     // 根据扇区计算PWM时间
     switch (sector) {
         case 1:
-            ta = (t1 + t2 + t0) * 0.5f;
-            tb = (t2 + t0) * 0.5f;
-            tc = t0 * 0.5f;
+            ta = t1 + t2 + half_t0;
+            tb = t2 + half_t0;
+            tc = half_t0;
             break;
         case 2:
-            ta = (t1 + t0) * 0.5f;
-            tb = (t1 + t2 + t0) * 0.5f;
-            tc = t0 * 0.5f;
+            ta = t1 + half_t0;
+            tb = t1 + t2 + half_t0;
+            tc = half_t0;
             break;
         case 3:
-            ta = t0 * 0.5f;
-            tb = (t1 + t2 + t0) * 0.5f;
-            tc = (t2 + t0) * 0.5f;
+            ta = half_t0;
+            tb = t1 + t2 + half_t0;
+            tc = t2 + half_t0;
             break;
         case 4:
-            ta = t0 * 0.5f;
-            tb = (t1 + t0) * 0.5f;
-            tc = (t1 + t2 + t0) * 0.5f;
+            ta = half_t0;
+            tb = t1 + half_t0;
+            tc = t1 + t2 + half_t0;
             break;
         case 5:
-            ta = (t2 + t0) * 0.5f;
-            tb = t0 * 0.5f;
-            tc = (t1 + t2 + t0) * 0.5f;
+            ta = t2 + half_t0;
+            tb = half_t0;
+            tc = t1 + t2 + half_t0;
             break;
         case 6:
-            ta = (t1 + t2 + t0) * 0.5f;
-            tb = t0 * 0.5f;
-            tc = (t1 + t0) * 0.5f;
+            ta = t1 + t2 + half_t0;
+            tb = half_t0;
+            tc = t1 + half_t0;
             break;
         default:
-            ta = FOC_PWM_PERIOD * 0.5f;
-            tb = FOC_PWM_PERIOD * 0.5f;
-            tc = FOC_PWM_PERIOD * 0.5f;
+            ta = MS8313_GetTiming()->period * 0.5f;
+            tb = ta;
+            tc = ta;
             break;
     }
     
@@ -266,27 +788,216 @@ void FOC_SVPWM_GeneratePWM(uint8_t sector, float t1, float t2, float t0,
     *pwm_c = (uint16_t)tc;
 }
 
+/**
+ * @brief  采样窗口与最小脉宽整形
+ * @note   PWM2中心对齐下，占空比d的相在谷点附近下管导通 (周期 - d) 个计数。
+ *         1. 最大相超出 周期-窗口 时整体下移；最小相会低于0则放弃最大相，只保证中间相，
+ *            仍不行则下移到最小相为0（此时能采样的相尽量多）；
+ *         2. 最小相落在 (0, 最小脉宽) 内时继续下移到0，该相本周期不开关；
+ *         3. 其余窄脉冲就近取整到0或最小脉宽，上限留出最小脉宽给下管（自举充电）
+ * @param  pwm_a: A相PWM指针（输入输出）
+ * @param  pwm_b: B相PWM指针（输入输出）
+ * @param  pwm_c: C相PWM指针（输入输出）
+ * @retval 无法采样的相（FOC_PHASE_MASK_x 组合）
+ */
+uint8_t FOC_SVPWM_ApplyWindow(uint16_t *pwm_a, uint16_t *pwm_b, uint16_t *pwm_c)
+{
+    int32_t period = MS8313_GetTiming()->period;
+    int32_t window = foc_control.sampling.window;
+    int32_t min_pulse = foc_control.sampling.min_pulse;
+    int32_t top = period - window;  // 可采样的最大占空比
+    int32_t d[3];
+    int32_t shift = 0;
+    uint8_t i_max, i_mid, i_min, tmp;
+    uint8_t mask = 0;
+    uint8_t i;
+    
+    d[0] = *pwm_a;
+    d[1] = *pwm_b;
+    d[2] = *pwm_c;
+    
+    // 排序
+    i_max = 0; i_mid = 1; i_min = 2;
+    if (d[i_max] < d[i_mid]) { tmp = i_max; i_max = i_mid; i_mid = tmp; }
+    if (d[i_mid] < d[i_min]) { tmp = i_mid; i_mid = i_min; i_min = tmp; }
+    if (d[i_max] < d[i_mid]) { tmp = i_max; i_max = i_mid; i_mid = tmp; }
+    
+    // 1. 零序下移保证采样窗口
+    if (d[i_max] > top) {
+        shift = d[i_max] - top;
+        if (d[i_min] - shift < 0) {
+            shift = d[i_mid] - top;
+            if (shift < 0) shift = 0;
+            if (d[i_min] - shift < 0) shift = d[i_min];
+        }
+    }
+    
+    // 2. 最小相窄脉冲：继续下移到0（下移不影响采样）
+    if (d[i_min] - shift > 0 && d[i_min] - shift < min_pulse) {
+        shift = d[i_min];
+    }
+    
+    // 3. 最小脉宽与下管最短导通
+    for (i = 0; i < 3; i++) {
+        d[i] -= shift;
+        if (d[i] > 0 && d[i] < min_pulse) {
+            d[i] = (d[i] < min_pulse / 2) ? 0 : min_pulse;
+        }
+        if (d[i] > period - min_pulse) {
+            d[i] = period - min_pulse;
+        }
+        if (d[i] > top) {
+            mask |= (uint8_t)(1 << i);
+        }
+    }
+    
+    *pwm_a = (uint16_t)d[0];
+    *pwm_b = (uint16_t)d[1];
+    *pwm_c = (uint16_t)d[2];
+    
+    return mask;
+}
+
+#if MYADC_SHUNT_NUM == 1
+/**
+ * @brief  单电阻采样移相整形并输出
+ * @note   PWM2中心对齐下，占空比d的相在上半周期 CNT = 周期 - d 时打开高边：
+ *         最大相先导通（窗口1，母线电流 = +i_max），中间相随后导通（窗口2，母线电流 = -i_min）。
+ *         窗口不足时最大相上半周期多导通 s、下半周期少导通 s（最小相反之），
+ *         触发点取各窗口结束前一个采样时间；移相受周期限幅无法满足时本周期不采样
+ * @param  pwm_a: A相PWM（平均占空比）
+ * @param  pwm_b: B相PWM
+ * @param  pwm_c: C相PWM
+ * @retval 无法采样的相（FOC_PHASE_MASK_x 组合）
+ */
+uint8_t FOC_SVPWM_SingleShunt(uint16_t pwm_a, uint16_t pwm_b, uint16_t pwm_c)
+{
+    int32_t period = MS8313_GetTiming()->period;
+    int32_t window = foc_control.sampling.ss_window;
+    int32_t sample = foc_control.sampling.ss_sample;
+    int32_t top = period - foc_control.sampling.min_pulse;
+    int32_t d[3], up[3], down[3];
+    uint16_t up_out[3], down_out[3];
+    int32_t shift, trigger1, trigger2;
+    uint8_t i_max, i_mid, i_min, tmp;
+    uint8_t valid;
+    uint8_t i;
+    
+    d[0] = pwm_a;
+    d[1] = pwm_b;
+    d[2] = pwm_c;
+    
+    // 排序
+    i_max = 0; i_mid = 1; i_min = 2;
+    if (d[i_max] < d[i_mid]) { tmp = i_max; i_max = i_mid; i_mid = tmp; }
+    if (d[i_mid] < d[i_min]) { tmp = i_mid; i_mid = i_min; i_min = tmp; }
+    if (d[i_max] < d[i_mid]) { tmp = i_max; i_max = i_mid; i_mid = tmp; }
+    
+    // 下管至少导通最小脉宽（自举充电）
+    for (i = 0; i < 3; i++) {
+        if (d[i] > top) {
+            d[i] = top;
+        }
+        up[i] = d[i];
+        down[i] = d[i];
+    }
+    
+    // 窗口1：最大相提前导通
+    shift = window - (d[i_max] - d[i_mid]);
+    if (shift > 0) {
+        up[i_max] = d[i_max] + shift;
+        if (up[i_max] > period) up[i_max] = period;
+        down[i_max] = 2 * d[i_max] - up[i_max];
+    }
+    
+    // 窗口2：最小相推后导通
+    shift = window - (d[i_mid] - d[i_min]);
+    if (shift > 0) {
+        up[i_min] = d[i_min] - shift;
+        if (up[i_min] < 0) up[i_min] = 0;
+        down[i_min] = 2 * d[i_min] - up[i_min];
+    }
+    
+    for (i = 0; i < 3; i++) {
+        if (down[i] < 0) down[i] = 0;
+        if (down[i] > period) down[i] = period;
+        up_out[i] = (uint16_t)up[i];
+        down_out[i] = (uint16_t)down[i];
+    }
+    
+    trigger1 = period - up[i_mid] - sample;
+    trigger2 = period - up[i_min] - sample;
+    valid = (up[i_max] - up[i_mid] >= window) && (up[i_mid] - up[i_min] >= window)
+            && (trigger1 > 0);
+    
+    MS8313_SetAsymmetricDuty(up_out, down_out, (uint16_t)trigger1, (uint16_t)trigger2,
+                             valid ? MYADC_SS_TAG(i_max, i_min) : 0);
+    
+    foc_control.pwm_a = (uint16_t)d[0];
+    foc_control.pwm_b = (uint16_t)d[1];
+    foc_control.pwm_c = (uint16_t)d[2];
+    
+    return valid ? 0 : (FOC_PHASE_MASK_A | FOC_PHASE_MASK_B | FOC_PHASE_MASK_C);
+}
+#endif
+
+/**
+ * @brief  设置采样窗口与最小脉宽
+ * @note   按当前PWM时序换算为计数，PWM频率修改后自动重算
+ * @param  window_ns: 采样窗口（ns）
+ * @param  min_pulse_ns: 最小脉宽（ns）
+ * @retval 无
+ */
+void FOC_SetSampleWindow(float window_ns, float min_pulse_ns)
+{
+    const MS8313_Timing_t *timing = MS8313_GetTiming();
+    float counts_per_ns = 1e-9f * timing->pwm_freq * timing->period;
+    
+    foc_control.sampling.window_ns = window_ns;
+    foc_control.sampling.min_pulse_ns = min_pulse_ns;
+    foc_control.sampling.window = (uint16_t)(window_ns * counts_per_ns + 0.5f);
+    foc_control.sampling.min_pulse = (uint16_t)(min_pulse_ns * counts_per_ns + 0.5f);
+    
+    // 单电阻窗口只在半个周期内计时，每计数时间减半
+    foc_control.sampling.ss_window = (uint16_t)(foc_control.sampling.ss_window_ns * 2.0f * counts_per_ns + 0.5f);
+    foc_control.sampling.ss_sample = (uint16_t)(foc_control.sampling.ss_sample_ns * 2.0f * counts_per_ns + 0.5f);
+}
+
 /**
  * @brief  SVPWM主函数
- * @param  valpha: α轴电压
- * @param  vbeta: β轴电压
+ * @note   用母线电压倒数把 α/β 电压归一化为计数，母线电压变化时调制增益不变
+ * @param  valpha: α轴电压（V）
+ * @param  vbeta: β轴电压（V）
  * @retval 无
  */
 void FOC_SVPWM_Generate(float valpha, float vbeta)
 {
     uint8_t sector;
     float t1, t2, t0;
+    float scale;
     uint16_t pwm_a, pwm_b, pwm_c;
     
     // 1. 扇区判断
     sector = FOC_SVPWM_GetSector(valpha, vbeta);
     
-    // 2. 矢量时间计算
-    FOC_SVPWM_CalculateTimes(valpha, vbeta, sector, &t1, &t2, &t0);
+    // 2. 矢量时间计算（电压 → 计数）
+    scale = SQRT3 * MS8313_GetTiming()->period * foc_control.vbus_inv;
+    FOC_SVPWM_CalculateTimes(valpha * scale, vbeta * scale, sector, &t1, &t2, &t0);
     
     // 3. PWM生成
     FOC_SVPWM_GeneratePWM(sector, t1, t2, t0, &pwm_a, &pwm_b, &pwm_c);
     
+    // 死区/驱动延迟补偿
+    FOC_DeadTime_Compensate(valpha, vbeta, &pwm_a, &pwm_b, &pwm_c);
+    
+#if MYADC_SHUNT_NUM == 1
+    // 单电阻：两个有效矢量移相后分半周期输出
+    foc_control.sampling.unsampled = FOC_SVPWM_SingleShunt(pwm_a, pwm_b, pwm_c);
+#else
+    // 采样窗口与最小脉宽
+    foc_control.sampling.unsampled = FOC_SVPWM_ApplyWindow(&pwm_a, &pwm_b, &pwm_c);
+    MYADC_SetUnsampled(foc_control.sampling.unsampled);
+    
     // 4. 输出PWM
     MS8313_SetThreePhaseDuty(pwm_a, pwm_b, pwm_c);
     
@@ -294,79 +1005,167 @@ void FOC_SVPWM_Generate(float valpha, float vbeta)
     foc_control.pwm_a = pwm_a;
     foc_control.pwm_b = pwm_b;
     foc_control.pwm_c = pwm_c;
+#endif
 }
 
-// ==================== PI控制器函数 ====================
-
 /**
- * @brief  PI控制器初始化
- * @param  pi: PI控制器结构体指针
- * @param  kp: 比例增益
- * @param  ki: 积分增益
- * @param  output_max: 输出上限
- * @param  output_min: 输出下限
+ * @brief  开环输出电压矢量（控制禁用时）
+ * @note   供参数辨识等实验直接给定 α/β 电压；FOC使能时忽略。
+ *         每次调用刷新母线电压倒数，调用前须已用 MS8313_EnableOutput 打开输出
+ * @param  valpha: α轴电压（V）
+ * @param  vbeta: β轴电压（V）
  * @retval 无
  */
-void FOC_PI_Init(PI_Controller_t *pi, float kp, float ki, float output_max, float output_min)
+void FOC_SetOpenLoopVoltage(float valpha, float vbeta)
 {
-    pi->kp = kp;
-    pi->ki = ki;
-    pi->integral = 0.0f;
-    pi->output_max = output_max;
-    pi->output_min = output_min;
-    pi->last_error = 0.0f;
+    if (!foc_initialized || foc_control.enable) {
+        return;
+    }
+    
+    foc_control.vbus_inv = MYADC_GetVbusInv();
+    foc_control.valpha = valpha;
+    foc_control.vbeta = vbeta;
+    FOC_SVPWM_Generate(valpha, vbeta);
 }
 
+// ==================== 死区补偿函数 ====================
+
 /**
- * @brief  PI控制器计算
- * @param  pi: PI控制器结构体指针
- * @param  error: 误差值
- * @retval PI控制器输出
+ * @brief  带线性区的电流符号
+ * @param  current: 电流
+ * @param  band_inv: 线性区半宽的倒数（0 时为纯符号函数），三相共用一次除法
+ * @retval -1.0 ~ 1.0
  */
-float FOC_PI_Calculate(PI_Controller_t *pi, float error)
+static float FOC_DeadTime_Sign(float current, float band_inv)
 {
-    float output;
+    float s;
     
-    // 比例项
-    output = pi->kp * error;
-    
-    // 积分项
-    pi->integral += pi->ki * error;
-    
-    // 积分限制
-    if (pi->integral > pi->output_max) {
-        pi->integral = pi->output_max;
-    } else if (pi->integral < pi->output_min) {
-        pi->integral = pi->output_min;
+    if (band_inv <= 0.0f) {
+        return (current > 0.0f) ? 1.0f : ((current < 0.0f) ? -1.0f : 0.0f);
     }
     
-    // 总输出
-    output += pi->integral;
-    
-    // 输出限制
-    if (output > pi->output_max) {
-        output = pi->output_max;
-    } else if (output < pi->output_min) {
-        output = pi->output_min;
-    }
+    s = current * band_inv;
+    if (s > 1.0f) s = 1.0f;
+    if (s < -1.0f) s = -1.0f;
+    return s;
+}
+
+/**
+ * @brief  配置死区补偿参数
+ * @note   每个PWM周期内，电流方向决定的那个开关沿被推迟 (死区 + 开通延迟 - 关断延迟)，
+ *         占空比满量程 周期值 对应一个PWM周期，
+ *         故补偿量（计数）= 误差时间 * PWM频率 * 周期值，PWM频率修改后自动重算
+ * @param  deadtime_ns: 死区时间（ns）
+ * @param  ton_delay_ns: 开通传播延迟（ns）
+ * @param  toff_delay_ns: 关断传播延迟（ns）
+ * @param  est_lag: 估计电流相对电压矢量的滞后角（弧度）
+ * @retval 无
+ */
+void FOC_DeadTime_Config(float deadtime_ns, float ton_delay_ns, float toff_delay_ns, float est_lag)
+{
+    const MS8313_Timing_t *timing = MS8313_GetTiming();
     
-    // 保存上次误差
-    pi->last_error = error;
+    foc_control.dead_time.error_ns = deadtime_ns + ton_delay_ns - toff_delay_ns;
+    foc_control.dead_time.comp_counts = foc_control.dead_time.error_ns * 1e-9f
+                                        * timing->pwm_freq * timing->period;
+    foc_control.dead_time.est_cos = cosf(est_lag);
+    foc_control.dead_time.est_sin = sinf(est_lag);
+}
+
+/**
+ * @brief  使能/禁用死区补偿
+ * @param  enable: 1=使能, 0=禁用
+ * @retval 无
+ */
+void FOC_DeadTime_Enable(uint8_t enable)
+{
+    foc_control.dead_time.enable = enable;
     
-    return output;
+    if (!enable) {
+        foc_control.dead_time.comp_a = 0.0f;
+        foc_control.dead_time.comp_b = 0.0f;
+        foc_control.dead_time.comp_c = 0.0f;
+    }
 }
 
 /**
- * @brief  PI控制器重置
- * @param  pi: PI控制器结构体指针
+ * @brief  输入实测相电流（有电流采样时每周期调用）
+ * @param  ia: A相电流（A，流出逆变器为正）
+ * @param  ib: B相电流（A）
+ * @param  ic: C相电流（A）
  * @retval 无
  */
-void FOC_PI_Reset(PI_Controller_t *pi)
+void FOC_DeadTime_SetCurrent(float ia, float ib, float ic)
 {
-    pi->integral = 0.0f;
-    pi->last_error = 0.0f;
+    foc_control.dead_time.ia = ia;
+    foc_control.dead_time.ib = ib;
+    foc_control.dead_time.ic = ic;
+    foc_control.dead_time.current_valid = 1;
 }
 
+/**
+ * @brief  对三相占空比施加死区补偿
+ * @note   电流流出逆变器时死区内由下管续流，相电压偏低，占空比加补偿量；
+ *         流入时相反。无电流采样时按电压矢量方向（滞后 est_lag）估计各相电流，
+ *         过零附近线性过渡以免补偿在正负之间抖动
+ * @param  valpha: α轴电压指令（用于估计电流方向）
+ * @param  vbeta: β轴电压指令
+ * @param  pwm_a: A相PWM指针（输入输出）
+ * @param  pwm_b: B相PWM指针（输入输出）
+ * @param  pwm_c: C相PWM指针（输入输出）
+ * @retval 无
+ */
+void FOC_DeadTime_Compensate(float valpha, float vbeta,
+                             uint16_t *pwm_a, uint16_t *pwm_b, uint16_t *pwm_c)
+{
+    FOC_DeadTime_t *dt = &foc_control.dead_time;
+    int32_t period = MS8313_GetTiming()->period;
+    float sa, sb, sc;
+    float band_inv = 0.0f;
+    int32_t da, db, dc;
+    
+    if (!dt->enable) {
+        return;
+    }
+    
+    if (dt->current_valid) {
+        // 实测电流符号
+        if (dt->current_band > 0.0f) {
+            band_inv = 1.0f / dt->current_band;
+        }
+        sa = FOC_DeadTime_Sign(dt->ia, band_inv);
+        sb = FOC_DeadTime_Sign(dt->ib, band_inv);
+        sc = FOC_DeadTime_Sign(dt->ic, band_inv);
+    } else {
+        // 由电压矢量估计电流方向：旋转滞后角后做逆Clarke变换
+        float ialpha = valpha * dt->est_cos + vbeta * dt->est_sin;
+        float ibeta = vbeta * dt->est_cos - valpha * dt->est_sin;
+        float band = sqrtf(ialpha * ialpha + ibeta * ibeta) * dt->est_band;
+        
+        if (band > 0.0f) {
+            band_inv = 1.0f / band;
+        }
+        sa = FOC_DeadTime_Sign(ialpha, band_inv);
+        sb = FOC_DeadTime_Sign(-0.5f * ialpha + 0.5f * SQRT3 * ibeta, band_inv);
+        sc = FOC_DeadTime_Sign(-0.5f * ialpha - 0.5f * SQRT3 * ibeta, band_inv);
+    }
+    
+    dt->comp_a = sa * dt->comp_counts;
+    dt->comp_b = sb * dt->comp_counts;
+    dt->comp_c = sc * dt->comp_counts;
+    
+    // 叠加补偿并限幅到 [0, 周期]
+    da = (int32_t)*pwm_a + (int32_t)(dt->comp_a + ((dt->comp_a >= 0.0f) ? 0.5f : -0.5f));
+    db = (int32_t)*pwm_b + (int32_t)(dt->comp_b + ((dt->comp_b >= 0.0f) ? 0.5f : -0.5f));
+    dc = (int32_t)*pwm_c + (int32_t)(dt->comp_c + ((dt->comp_c >= 0.0f) ? 0.5f : -0.5f));
+    
+    *pwm_a = (uint16_t)((da < 0) ? 0 : ((da > period) ? period : da));
+    *pwm_b = (uint16_t)((db < 0) ? 0 : ((db > period) ? period : db));
+    *pwm_c = (uint16_t)((dc < 0) ? 0 : ((dc > period) ? period : dc));
+}
+
+// ==================== PI控制器函数 ====================
+
 // ==================== 控制函数 ====================
 
 /**
@@ -378,63 +1177,722 @@ void FOC_PI_Reset(PI_Controller_t *pi)
  */
 void FOC_SpeedControl(float speed_ref, float speed_actual, float *voltage_ref)
 {
-    // 计算速度误差
-    float speed_error = speed_ref - speed_actual;
+    float voltage_max = foc_control.vbus * SQRT3_INV;  // SVPWM线性区上限
+    
+    if (voltage_max > FOC_MAX_VOLTAGE) {
+        voltage_max = FOC_MAX_VOLTAGE;
+    }
     
-    // PI控制器计算
-    *voltage_ref = FOC_PI_Calculate(&foc_control.speed_pi, speed_error);
+    // PI控制器计算 + 反电势前馈
+    FOC_VoltageFF_Update();
+    *voltage_ref = PID_Update(&foc_control.speed_pi, speed_ref, speed_actual, foc_control.vq_ff);
     
-    // 限制电压范围
-    *voltage_ref = FOC_LimitVoltage(*voltage_ref, FOC_MIN_VOLTAGE, FOC_MAX_VOLTAGE);
+    // 限制电压范围，限幅结果反馈给速度环抗饱和
+    *voltage_ref = FOC_LimitVoltage(*voltage_ref, FOC_MIN_VOLTAGE, voltage_max);
+    PID_Saturation(&foc_control.speed_pi, *voltage_ref, foc_control.vq_ff);
 }
 
 /**
  * @brief  FOC主控制循环（闭环）
+ * @note   每个控制周期调用；控制禁用时也更新角度和转速并锁存故障码
  * @param  angle: 位置角度（0-4095）
  * @param  speed_rpm: 实际转速（RPM）
  * @retval 无
  */
 void FOC_MainLoop(uint16_t angle, float speed_rpm)
 {
-    if (!foc_initialized || !foc_control.enable) {
+    // 角度和转速在禁用时也更新（开环实验、滑行测速）
+    foc_control.angle = angle;
+    foc_control.speed_rpm = speed_rpm;
+    foc_control.loop_count++;
+    
+    if (!foc_initialized || FOC_CheckFault() || !foc_control.enable) {
         return;
     }
     
+    // PWM频率修改后重算时间常数
+    FOC_UpdateTiming(0);
+    
     // 1. 更新控制参数
-    foc_control.angle = angle;
-    foc_control.speed_rpm = speed_rpm;
+    foc_control.omega_e = speed_rpm * (2.0f * PI / 60.0f) * foc_control.motor.pole_pairs;
+    foc_control.vbus = MYADC_GetVbus();
+    foc_control.vbus_inv = MYADC_GetVbusInv();
     
-    // 2. 计算电角度
-    foc_control.theta = FOC_AngleToRadian(angle);
+    // 2. 计算电角度（d轴）
+    foc_control.theta = FOC_AngleToRadian(FOC_AngleToElectrical(angle));
     
-    // 3. 速度环控制（闭环）
-    FOC_SpeedControl(foc_control.speed_ref, speed_rpm, &foc_control.voltage_ref);
+    // 负载转矩观测（用上一周期的转矩指令），补偿量经前馈进入本周期速度环输出
+    FOC_DOB_Update(speed_rpm);
     
-    // 4. 生成三相电压指令
-    float va = foc_control.voltage_ref * cosf(foc_control.theta);
-    float vb = foc_control.voltage_ref * cosf(foc_control.theta - 2.0f * PI / 3.0f);
-    float vc = foc_control.voltage_ref * cosf(foc_control.theta + 2.0f * PI / 3.0f);
+    // 3. 轨迹与位置环：速度参考 = 轨迹速度前馈 + 位置环修正
+    foc_control.pos_actual = AS5600_GetTotalAngle();
+    Traj_Update(&foc_control.traj);
+    if (foc_control.ctrl_mode == FOC_CTRL_POSITION) {
+        FOC_PositionControl();
+    }
+    foc_control.speed_ref = foc_control.traj.vel * 60.0f + foc_control.pos_corr;
     
-    // 5. Clarke变换
-    FOC_Clarke_Transform(va, vb, vc, &foc_control.valpha, &foc_control.vbeta);
+    // 4. 速度环控制（闭环）：电流模式输出 iq 参考（叠加加速转矩前馈），由电流环完成调制；
+    //    继电反馈实验时速度环输出由继电器给出
+    if (foc_control.relay.active) {
+        float output = FOC_Relay_Update(speed_rpm);
+        
+        if (foc_control.current_loop && foc_control.mode == FOC_MODE_FOC) {
+            foc_control.iq_ref = FOC_LimitVoltage(output, -FOC_MAX_CURRENT, FOC_MAX_CURRENT);
+        } else {
+            float voltage_max = foc_control.vbus * SQRT3_INV;
+            
+            if (voltage_max > FOC_MAX_VOLTAGE) {
+                voltage_max = FOC_MAX_VOLTAGE;
+            }
+            FOC_VoltageFF_Update();
+            foc_control.voltage_ref = FOC_LimitVoltage(output + foc_control.vq_ff, FOC_MIN_VOLTAGE, voltage_max);
+        }
+    } else if (foc_control.current_loop && foc_control.mode == FOC_MODE_FOC) {
+        FOC_GainSchedule_Update(fabsf(foc_control.speed_ref));
+        FOC_TorqueFF_Update();
+        foc_control.iq_ref = PID_Update(&foc_control.speed_pi, foc_control.speed_ref, speed_rpm,
+                                        foc_control.iq_ff);
+    } else {
+        FOC_GainSchedule_Update(fabsf(foc_control.speed_ref));
+        FOC_SpeedControl(foc_control.speed_ref, speed_rpm, &foc_control.voltage_ref);
+    }
+    
+    // 运行模式切换（转速滞环）；电压模式下两种模式共用速度环输出，电压矢量方向一致，切换无跳变；
+    // 电流模式下切换时速度环改变输出单位，以当前电压幅值/电流预置积分，
+    // 六步换相按切换时的电压矢量方向超前换相。
+    // 电流环在更高优先级的电流采样中断中运行，切换期间关闭该中断，电流环看到的模式与预置值一致
+    if (foc_control.sixstep_enter_rpm > 0.0f) {
+        float speed_abs = (speed_rpm >= 0.0f) ? speed_rpm : -speed_rpm;
+        
+        if (foc_control.mode == FOC_MODE_FOC && speed_abs > foc_control.sixstep_enter_rpm) {
+            NVIC_DisableIRQ(ADC1_2_IRQn);
+            foc_control.mode = FOC_MODE_SIXSTEP;
+            if (foc_control.current_loop) {
+                FOC_Feedforward_Update();
+                FOC_SpeedPI_Config(0, foc_control.voltage_ref - foc_control.vq_ff);
+                sixstep_advance = (int16_t)(atan2f(foc_control.vq, foc_control.vd) * (4096.0f / (2.0f * PI)));
+            }
+            NVIC_EnableIRQ(ADC1_2_IRQn);
+        } else if (foc_control.mode == FOC_MODE_SIXSTEP && speed_abs < foc_control.sixstep_exit_rpm) {
+            NVIC_DisableIRQ(ADC1_2_IRQn);
+            foc_control.mode = FOC_MODE_FOC;
+            if (foc_control.current_loop) {
+                float advance = sixstep_advance * (2.0f * PI / 4096.0f);
+                
+                FOC_Feedforward_Update();
+                FOC_SpeedPI_Config(1, foc_control.iq - foc_control.iq_ff);
+                foc_control.iq_ref = foc_control.iq;
+                foc_control.id_pi.integral = foc_control.voltage_ref * cosf(advance) - foc_control.vd_ff;
+                foc_control.iq_pi.integral = foc_control.voltage_ref * sinf(advance) - foc_control.vq_ff;
+            }
+            sixstep_advance = 1024;
+            NVIC_EnableIRQ(ADC1_2_IRQn);
+        }
+    } else {
+        foc_control.mode = FOC_MODE_FOC;
+    }
+    
+    if (foc_control.mode == FOC_MODE_SIXSTEP) {
+        FOC_SixStep((uint16_t)(FOC_AngleToElectrical(angle) + sixstep_advance) & 0x0FFF, foc_control.voltage_ref);
+        // 六步换相不做采样窗口整形，电流按不可采样处理
+        foc_control.sampling.unsampled = FOC_PHASE_MASK_A | FOC_PHASE_MASK_B | FOC_PHASE_MASK_C;
+        MYADC_SetUnsampled(foc_control.sampling.unsampled);
+        return;
+    }
+    
+    if (foc_control.current_loop) {
+        return;
+    }
+    
+    // 5. 电压模式：电压矢量沿q轴（与反电势同向），逆Park得到 α/β 电压
+    foc_control.vd = 0.0f;
+    foc_control.vq = foc_control.voltage_ref;
+    FOC_InvPark_Transform(foc_control.vd, foc_control.vq, foc_control.theta,
+                          &foc_control.valpha, &foc_control.vbeta);
+    
+    // 6. SVPWM生成
+    FOC_SVPWM_Generate(foc_control.valpha, foc_control.vbeta);
+}
+
+/**
+ * @brief  d/q电流环（PWM频率）
+ * @note   在电流采样完成中断中调用：测量电流 Clarke/Park 变换，
+ *         d/q 两个PI输出电压，矢量限幅到 Vbus/√3 后逆Park并SVPWM输出；
+ *         Park与逆Park共用一次查表得到的正余弦。测量电流同时用于死区补偿的电流符号
+ * @param  ia: A相电流（A）
+ * @param  ib: B相电流（A）
+ * @param  ic: C相电流（A）
+ * @param  angle: 位置角度（0-4095，宜用预测到采样时刻的角度）
+ * @retval 无
+ */
+void FOC_CurrentLoop(float ia, float ib, float ic, uint16_t angle)
+{
+    float cos_theta, sin_theta;
+    float vmax, vmag;
+    
+    if (!foc_initialized || FOC_CheckFault() || !foc_control.enable ||
+        !foc_control.current_loop || foc_control.mode != FOC_MODE_FOC) {
+        return;
+    }
+    
+    // 1. 电角度（d轴），查表取正余弦；theta（弧度）由控制周期刷新，仅供显示
+    FOC_SinCos(FOC_AngleToElectrical(angle), &sin_theta, &cos_theta);
+    
+    // 2. Clarke/Park变换
+    FOC_Clarke_Transform(ia, ib, ic, &foc_control.ialpha, &foc_control.ibeta);
+    foc_control.id = foc_control.ialpha * cos_theta + foc_control.ibeta * sin_theta;
+    foc_control.iq = -foc_control.ialpha * sin_theta + foc_control.ibeta * cos_theta;
+    FOC_DeadTime_SetCurrent(ia, ib, ic);
+    
+    // 3. d/q电流PI + 交叉耦合/反电势前馈（转矩前馈已由控制周期叠加到 iq_ref）
+    FOC_VoltageFF_Update();
+    foc_control.vd = PID_Update(&foc_control.id_pi, foc_control.id_ref, foc_control.id, foc_control.vd_ff);
+    foc_control.vq = PID_Update(&foc_control.iq_pi, foc_control.iq_ref, foc_control.iq, foc_control.vq_ff);
+    
+    // 4. 电压矢量限幅（SVPWM线性区）
+    vmax = foc_control.vbus * SQRT3_INV;
+    if (vmax > FOC_MAX_VOLTAGE) {
+        vmax = FOC_MAX_VOLTAGE;
+    }
+    vmag = sqrtf(foc_control.vd * foc_control.vd + foc_control.vq * foc_control.vq);
+    if (vmag > vmax) {
+        float scale = vmax / vmag;
+        foc_control.vd *= scale;
+        foc_control.vq *= scale;
+        vmag = vmax;
+        
+        // 矢量限幅后的实际电压反馈给d/q电流环抗饱和
+        PID_Saturation(&foc_control.id_pi, foc_control.vd, foc_control.vd_ff);
+        PID_Saturation(&foc_control.iq_pi, foc_control.vq, foc_control.vq_ff);
+    }
+    foc_control.voltage_ref = vmag;
+    
+    // 5. 逆Park变换
+    foc_control.valpha = foc_control.vd * cos_theta - foc_control.vq * sin_theta;
+    foc_control.vbeta = foc_control.vd * sin_theta + foc_control.vq * cos_theta;
     
     // 6. SVPWM生成
     FOC_SVPWM_Generate(foc_control.valpha, foc_control.vbeta);
 }
 
+/**
+ * @brief  切换电流环/电压模式
+ * @note   切换时预置速度环积分，输出不跳变
+ * @param  enable: 1=电流环（转矩模式）, 0=电压模式
+ * @retval 无
+ */
+void FOC_SetCurrentLoop(uint8_t enable)
+{
+    if (enable == foc_control.current_loop) {
+        return;
+    }
+    
+    // 切换标志与电流环积分预置一起生效
+    NVIC_DisableIRQ(ADC1_2_IRQn);
+    foc_control.current_loop = enable;
+    
+    // 积分项预置为目标输出减去新模式下的前馈
+    if (foc_control.mode == FOC_MODE_FOC) {
+        FOC_Feedforward_Update();
+        if (enable) {
+            // 电压模式的电压矢量沿q轴（theta + 90°），幅值 voltage_ref
+            FOC_SpeedPI_Config(1, foc_control.iq - foc_control.iq_ff);
+            foc_control.iq_ref = foc_control.iq;
+            foc_control.id_pi.integral = -foc_control.vd_ff;
+            foc_control.iq_pi.integral = foc_control.voltage_ref - foc_control.vq_ff;
+        } else {
+            FOC_SpeedPI_Config(0, foc_control.voltage_ref - foc_control.vq_ff);
+        }
+    }
+    NVIC_EnableIRQ(ADC1_2_IRQn);
+}
+
+/**
+ * @brief  设置电机参数
+ * @param  param: 电机参数
+ * @retval 无
+ */
+void FOC_SetMotorParam(const FOC_MotorParam_t *param)
+{
+    foc_control.motor = *param;
+    if (foc_control.motor.pole_pairs == 0) {
+        foc_control.motor.pole_pairs = 1;
+    }
+}
+
+/**
+ * @brief  使能/禁用模型前馈
+ * @param  enable: 1=使能, 0=禁用
+ * @retval 无
+ */
+void FOC_SetFeedforward(uint8_t enable)
+{
+    float vd_old, vq_old, iq_old;
+    
+    // 积分项由控制回调和电流采样中断读改写，整组更新
+    NVIC_DisableIRQ(MS8313_UPDATE_IRQn);
+    NVIC_DisableIRQ(ADC1_2_IRQn);
+    vd_old = foc_control.vd_ff;
+    vq_old = foc_control.vq_ff;
+    iq_old = foc_control.iq_ff;
+    foc_control.ff_enable = enable;
+    FOC_Feedforward_Update();
+    
+    // 前馈变化量转入积分，总输出不变
+    if (foc_control.current_loop && foc_control.mode == FOC_MODE_FOC) {
+        foc_control.id_pi.integral += vd_old - foc_control.vd_ff;
+        foc_control.iq_pi.integral += vq_old - foc_control.vq_ff;
+        foc_control.speed_pi.integral += iq_old - foc_control.iq_ff;
+    } else {
+        foc_control.speed_pi.integral += vq_old - foc_control.vq_ff;
+    }
+    NVIC_EnableIRQ(ADC1_2_IRQn);
+    NVIC_EnableIRQ(MS8313_UPDATE_IRQn);
+}
+
+/**
+ * @brief  配置负载转矩扰动观测器
+ * @param  enable: 1=使能, 0=禁用
+ * @param  cutoff: 观测带宽（Hz）
+ * @param  gain: 补偿比例（0-1，0 = 只观测不补偿）
+ * @retval 无
+ */
+void FOC_SetDisturbanceObserver(uint8_t enable, float cutoff, float gain)
+{
+    FOC_DOB_t *dob = &foc_control.dob;
+    float kt = 1.5f * foc_control.motor.pole_pairs * foc_control.motor.flux;
+    float j_omega, comp_old;
+    
+    // 观测器状态和速度环积分由控制回调读改写，整组更新
+    NVIC_DisableIRQ(MS8313_UPDATE_IRQn);
+    j_omega = foc_control.motor.inertia * foc_control.speed_rpm * (2.0f * PI / 60.0f);
+    comp_old = dob->iq_comp;
+    if (enable != dob->enable) {
+        dob->enable = enable;
+        dob->initialized = 0;
+        dob->torque = 0.0f;
+    }
+    
+    // 带宽变化时保持当前估计不变
+    dob->cutoff = cutoff;
+    dob->g = 2.0f * PI * cutoff;
+    dob->z = dob->torque + dob->g * j_omega;
+    dob->gain = gain;
+    dob->iq_comp = (dob->initialized && kt > 0.0f) ?
+                   FOC_LimitVoltage(gain * dob->torque / kt, -FOC_MAX_CURRENT, FOC_MAX_CURRENT) : 0.0f;
+    
+    // 补偿量变化转入积分，总输出不变
+    if (foc_control.current_loop && foc_control.mode == FOC_MODE_FOC) {
+        foc_control.speed_pi.integral += comp_old - dob->iq_comp;
+    } else {
+        foc_control.speed_pi.integral += (comp_old - dob->iq_comp) * foc_control.motor.rs;
+    }
+    NVIC_EnableIRQ(MS8313_UPDATE_IRQn);
+}
+
+/**
+ * @brief  校准采样累加
+ * @note   等待ADC模块累加完成，超出校准总时间时放弃
+ * @param  samples: 累加次数
+ * @param  mean: 各通道平均原始计数（输出）
+ * @param  start: 校准开始时刻（ms）
+ * @retval 1: 完成, 0: 超时
+ */
+static uint8_t FOC_CalAccumulate(uint16_t samples, float mean[3], uint32_t start)
+{
+    MYADC_StartAccumulate(samples);
+    while (!MYADC_GetAccumulate(mean)) {
+        if (Delay_GetTick() - start >= FOC_CAL_TIMEOUT_MS) {
+            MYADC_StartAccumulate(0);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief  电流采样启动校准
+ * @note   零矢量下相电流为0（三相同时开关，绕组无电压），采样值即偏置；
+ *         增益校验时转子被d轴电流吸合到A相轴，反电势为0，电流只由电阻决定，
+ *         此时的位置角度即电角度零点（对齐期间主控制循环须在记录角度）
+ * @param  gain_check: 1=做增益校验
+ * @param  offset: 各通道偏置（输入为当前值，输出为校准结果）
+ * @param  gain: 各通道增益修正（输入为当前值，输出为校准结果）
+ * @param  angle_offset: 电角度零点（输入为当前值，输出为校准结果）
+ * @retval 成功的步骤（FOC_CAL_OFFSET_OK | FOC_CAL_GAIN_OK | FOC_CAL_ANGLE_OK）
+ */
+uint8_t FOC_CalibrateCurrent(uint8_t gain_check, uint16_t offset[3], float gain[3], uint16_t *angle_offset)
+{
+    uint32_t start = Delay_GetTick();
+    uint16_t half = MS8313_GetTiming()->period / 2;
+    float mean[3];
+    uint8_t result = 0;
+    uint8_t i;
+    
+    if (!foc_initialized || foc_control.enable) {
+        return 0;
+    }
+    
+    // 1. 零矢量下平均偏置
+    MS8313_SetThreePhaseDuty(half, half, half);
+    MS8313_EnableOutput();
+    while (Delay_GetTick() - start < FOC_CAL_SETTLE_MS);
+    
+    if (FOC_CalAccumulate(FOC_CAL_OFFSET_SAMPLES, mean, start)) {
+        result = FOC_CAL_OFFSET_OK;
+        for (i = 0; i < MYADC_SHUNT_NUM; i++) {
+            if (mean[i] < MYADC_CURRENT_OFFSET - FOC_CAL_OFFSET_TOL ||
+                mean[i] > MYADC_CURRENT_OFFSET + FOC_CAL_OFFSET_TOL) {
+                result = 0;
+            }
+        }
+        if (result) {
+            for (i = 0; i < MYADC_SHUNT_NUM; i++) {
+                offset[i] = (uint16_t)(mean[i] + 0.5f);
+            }
+            MYADC_SetCalibration(offset, gain);
+        }
+    }
+    
+#if MYADC_SHUNT_NUM >= 2
+    // 2. 增益校验：A相电流 ca，其余两相应为 -ca/2（单电阻只有一个通道，无需匹配）
+    if (gain_check && result) {
+        uint32_t t0 = Delay_GetTick();
+        uint32_t last = t0 - 1;
+        uint32_t t;
+        uint16_t loops = foc_control.loop_count;
+        float ca, ci, new_gain[3];
+        uint8_t ok;
+        
+        foc_control.vbus_inv = MYADC_GetVbusInv();
+        
+        // 半程线性上升，减小转子吸合时的冲击
+        while ((t = Delay_GetTick() - t0) < FOC_CAL_ALIGN_MS && Delay_GetTick() - start < FOC_CAL_TIMEOUT_MS) {
+            if (t != last) {
+                last = t;
+                FOC_SVPWM_Generate(FOC_CAL_VOLTAGE * ((t < FOC_CAL_ALIGN_MS / 2) ?
+                                   (float)t / (FOC_CAL_ALIGN_MS / 2) : 1.0f), 0.0f);
+            }
+        }
+        
+        if (t >= FOC_CAL_ALIGN_MS && FOC_CalAccumulate(FOC_CAL_GAIN_SAMPLES, mean, start)) {
+            ca = (mean[0] - offset[0]) * gain[0];
+            ok = (ca >= FOC_CAL_MIN_COUNTS || ca <= -FOC_CAL_MIN_COUNTS);
+            
+            // 电流足以吸合转子、且角度在对齐期间持续更新时，记录电角度零点
+            if (ok && foc_control.loop_count != loops) {
+                *angle_offset = foc_control.angle;
+                FOC_SetAngleOffset(*angle_offset);
+                result |= FOC_CAL_ANGLE_OK;
+            }
+            
+            new_gain[0] = gain[0];
+            for (i = 1; i < MYADC_SHUNT_NUM && ok; i++) {
+                ci = mean[i] - offset[i];
+                if (ci == 0.0f) {
+                    ok = 0;
+                    break;
+                }
+                new_gain[i] = -0.5f * ca / ci;
+                if (new_gain[i] < 1.0f - FOC_CAL_GAIN_TOL || new_gain[i] > 1.0f + FOC_CAL_GAIN_TOL) {
+                    ok = 0;
+                }
+            }
+            if (ok) {
+                for (i = 1; i < MYADC_SHUNT_NUM; i++) {
+                    gain[i] = new_gain[i];
+                }
+                MYADC_SetCalibration(offset, gain);
+                result |= FOC_CAL_GAIN_OK;
+            }
+        }
+    }
+#else
+    (void)gain_check;
+    (void)angle_offset;
+#endif
+    
+    // 3. 恢复零矢量并关闭输出
+    MS8313_SetThreePhaseDuty(half, half, half);
+    MS8313_DisableOutput();
+    
+    return result;
+}
+
+/**
+ * @brief  六步换相输出
+ * @note   第 k 步电压矢量方向为 30° + 60° * k，取 k = floor(角度 / 60°) 即与
+ *         矢量控制在同一角度下的电压矢量最接近；线电压 = √3 * 相电压幅值，
+ *         与SVPWM线性区同标度（voltage_ref = Vbus/√3 时占空比满量程）
+ * @param  angle: 电压矢量方向（电角度，0-4095）
+ * @param  voltage_ref: 电压参考值（V，与矢量控制的相电压幅值同标度）
+ * @retval 无
+ */
+void FOC_SixStep(uint16_t angle, float voltage_ref)
+{
+    uint16_t period = MS8313_GetTiming()->period;
+    float duty = voltage_ref * SQRT3 * period * foc_control.vbus_inv;
+    uint8_t step = (uint8_t)(((uint32_t)(angle & 0x0FFF) * 6) >> 12);
+    
+    if (duty < 0.0f) duty = 0.0f;
+    if (duty > period) duty = period;
+    
+    MS8313_SetSixStep(step, (uint16_t)duty);
+}
+
+/**
+ * @brief  设置六步换相切换转速（滞环）
+ * @param  enter_rpm: 转速高于此值切换到六步换相（RPM），<= 0 时禁用六步换相
+ * @param  exit_rpm: 转速低于此值切回矢量控制（RPM）
+ * @retval 无
+ */
+void FOC_SetSixStepSpeed(float enter_rpm, float exit_rpm)
+{
+    if (exit_rpm > enter_rpm) {
+        exit_rpm = enter_rpm;
+    }
+    
+    foc_control.sixstep_enter_rpm = enter_rpm;
+    foc_control.sixstep_exit_rpm = exit_rpm;
+}
+
 /**
  * @brief  设置FOC控制参数
- * @param  speed_ref: 转速参考值（RPM）
+ * @param  speed_ref: 目标转速（RPM）
  * @param  direction: 方向（0=正转，1=反转）
  * @retval 无
  */
 void FOC_SetControl(float speed_ref, uint8_t direction)
 {
-    foc_control.speed_ref = speed_ref;
+    // 控制模式、轨迹限制和目标速度由控制回调使用，整组修改完成前不能插入
+    NVIC_DisableIRQ(MS8313_UPDATE_IRQn);
+    foc_control.speed_target = speed_ref;
     foc_control.direction = direction;
     
-    // 重置PI控制器
-    FOC_PI_Reset(&foc_control.speed_pi);
+    // 退出位置控制，轨迹速度限制恢复为最大转速
+    foc_control.ctrl_mode = FOC_CTRL_SPEED;
+    foc_control.in_position = 0;
+    foc_control.pos_corr = 0.0f;
+    Traj_SetLimits(&foc_control.traj, FOC_MAX_SPEED / 60.0f, foc_control.traj.a_max,
+                   foc_control.traj.d_max, foc_control.traj.j_max);
+    Traj_SetVelocity(&foc_control.traj, speed_ref / 60.0f);
+    NVIC_EnableIRQ(MS8313_UPDATE_IRQn);
+}
+
+/**
+ * @brief  设置速度环增益
+ * @param  current_units: 1=电流输出（A/RPM）, 0=电压输出（V/RPM）
+ * @param  kp: 比例增益
+ * @param  ki: 积分增益（1/s）
+ * @retval 无
+ */
+void FOC_SetSpeedGain(uint8_t current_units, float kp, float ki)
+{
+    current_units = current_units ? 1 : 0;
+    
+    // PID_SetGains 读改写积分项，不能与控制回调中的 PID_Update 交错
+    NVIC_DisableIRQ(MS8313_UPDATE_IRQn);
+    foc_control.speed_kp[current_units] = kp;
+    foc_control.speed_ki[current_units] = ki;
+    if (current_units == (foc_control.current_loop && foc_control.mode == FOC_MODE_FOC)) {
+        PID_SetGains(&foc_control.speed_pi, kp, ki, 0.0f);
+    }
+    NVIC_EnableIRQ(MS8313_UPDATE_IRQn);
+}
+
+/**
+ * @brief  设置速度环增益调度表
+ * @param  current_units: 1=电流输出（A/RPM）, 0=电压输出（V/RPM）
+ * @param  speed: 断点转速（RPM，严格升序）
+ * @param  kp: 断点比例增益
+ * @param  ki: 断点积分增益（1/s）
+ * @param  count: 断点数（0 或 2 ~ FOC_GAIN_POINTS）
+ * @retval 1: 成功, 0: 点数或转速顺序无效，原表不变
+ */
+uint8_t FOC_SetGainSchedule(uint8_t current_units, const float speed[], const float kp[],
+                            const float ki[], uint8_t count)
+{
+    FOC_GainSched_t *gs;
+    uint8_t i;
+    
+    current_units = current_units ? 1 : 0;
+    if (count == 1 || count > FOC_GAIN_POINTS) {
+        return 0;
+    }
+    for (i = 1; i < count; i++) {
+        if (speed[i] <= speed[i - 1]) {
+            return 0;
+        }
+    }
+    
+    // 写表期间控制周期不使用该表
+    gs = &foc_control.gain_sched[current_units];
+    gs->count = 0;
+    for (i = 0; i < count; i++) {
+        gs->speed[i] = speed[i];
+        gs->kp[i] = kp[i];
+        gs->ki[i] = ki[i];
+    }
+    for (i = 0; i + 1 < count; i++) {
+        gs->kp_slope[i] = (kp[i + 1] - kp[i]) / (speed[i + 1] - speed[i]);
+        gs->ki_slope[i] = (ki[i + 1] - ki[i]) / (speed[i + 1] - speed[i]);
+    }
+    gs->index = 0;
+    gs->count = count;
+    
+    // 取消调度：正在使用的一组恢复固定增益
+    NVIC_DisableIRQ(MS8313_UPDATE_IRQn);
+    if (count == 0 && current_units == (foc_control.current_loop && foc_control.mode == FOC_MODE_FOC)) {
+        PID_SetGains(&foc_control.speed_pi, foc_control.speed_kp[current_units],
+                     foc_control.speed_ki[current_units], 0.0f);
+    }
+    NVIC_EnableIRQ(MS8313_UPDATE_IRQn);
+    return 1;
+}
+
+/**
+ * @brief  开始速度环继电反馈实验
+ * @param  setpoint: 转速设定值（RPM）
+ * @param  amplitude: 继电器幅值（当前速度环输出单位：A 或 V）
+ * @param  hysteresis: 切换滞环（RPM）
+ * @retval 无
+ */
+void FOC_StartRelay(float setpoint, float amplitude, float hysteresis)
+{
+    FOC_Relay_t *relay = &foc_control.relay;
+    
+    // 控制回调读取继电器状态并使用速度环输出，整组设置完成前不能插入
+    NVIC_DisableIRQ(MS8313_UPDATE_IRQn);
+    relay->setpoint = setpoint;
+    relay->bias = foc_control.speed_pi.output;
+    relay->amplitude = amplitude;
+    relay->hysteresis = hysteresis;
+    relay->state = (setpoint >= foc_control.speed_rpm) ? 1 : -1;
+    relay->speed_max = foc_control.speed_rpm;
+    relay->speed_min = foc_control.speed_rpm;
+    relay->count = 0;
+    relay->last_rise = 0;
+    relay->period = 0.0f;
+    relay->speed_amp = 0.0f;
+    relay->cycles = 0;
+    relay->active = 1;
+    NVIC_EnableIRQ(MS8313_UPDATE_IRQn);
+}
+
+/**
+ * @brief  结束继电反馈实验
+ * @retval 无
+ */
+void FOC_StopRelay(void)
+{
+    // PID_Reset 读改写速度环状态，不能与控制回调中的 PID_Update 交错
+    NVIC_DisableIRQ(MS8313_UPDATE_IRQn);
+    if (foc_control.relay.active) {
+        foc_control.relay.active = 0;
+        PID_Reset(&foc_control.speed_pi, foc_control.relay.bias);
+    }
+    NVIC_EnableIRQ(MS8313_UPDATE_IRQn);
+}
+
+/**
+ * @brief  设置转速轨迹的加速度限制
+ * @param  accel: 最大加速度（RPM/s）
+ * @param  decel: 最大减速度（RPM/s）
+ * @param  jerk: 最大加加速度（RPM/s²，即 rev/min/s²）
+ * @retval 无
+ */
+void FOC_SetAccelLimits(float accel, float decel, float jerk)
+{
+    // RPM/s → rev/s²，RPM/s² → rev/s³；限制由控制回调中的轨迹使用，整组修改
+    NVIC_DisableIRQ(MS8313_UPDATE_IRQn);
+    Traj_SetLimits(&foc_control.traj, foc_control.traj.v_max,
+                   accel / 60.0f, decel / 60.0f, jerk / 60.0f);
+    NVIC_EnableIRQ(MS8313_UPDATE_IRQn);
+}
+
+/**
+ * @brief  移动到绝对位置（切换到位置控制）
+ * @param  position: 目标位置（圈，AS5600多圈累计角度）
+ * @retval 无
+ */
+void FOC_MoveTo(float position)
+{
+    // 轨迹和位置环由控制回调更新，整组修改完成前不能插入
+    NVIC_DisableIRQ(MS8313_UPDATE_IRQn);
+    if (foc_control.ctrl_mode != FOC_CTRL_POSITION) {
+        // 轨迹位置对齐实际位置，保留当前速度，从速度控制无扰衔接
+        Traj_Reset(&foc_control.traj, AS5600_GetTotalAngle(), foc_control.traj.vel);
+        PID_Reset(&foc_control.pos_pi, 0.0f);
+        foc_control.pos_count = 0;
+        foc_control.pos_corr = 0.0f;
+        foc_control.ctrl_mode = FOC_CTRL_POSITION;
+    }
+    
+    Traj_SetLimits(&foc_control.traj, foc_control.pos_move_speed / 60.0f, foc_control.traj.a_max,
+                   foc_control.traj.d_max, foc_control.traj.j_max);
+    foc_control.pos_target = position;
+    foc_control.in_position = 0;
+    Traj_SetPosition(&foc_control.traj, position);
+    NVIC_EnableIRQ(MS8313_UPDATE_IRQn);
+}
+
+/**
+ * @brief  相对移动（切换到位置控制）
+ * @param  distance: 移动距离（圈，正值为正转方向）
+ * @retval 无
+ */
+void FOC_MoveBy(float distance)
+{
+    // 控制模式和目标位置只在主循环中修改，FOC_MoveTo 屏蔽控制回调完成切换
+    if (foc_control.ctrl_mode == FOC_CTRL_POSITION) {
+        FOC_MoveTo(foc_control.pos_target + distance);
+    } else {
+        FOC_MoveTo(AS5600_GetTotalAngle() + distance);
+    }
+}
+
+/**
+ * @brief  设置位置控制参数
+ * @param  move_speed: 移动最大转速（RPM）
+ * @param  deadband: 到位死区（圈）
+ * @param  hold_mode: 到位保持方式（FOC_HOLD_SERVO / FOC_HOLD_SPEED）
+ * @retval 无
+ */
+void FOC_SetPositionParam(float move_speed, float deadband, uint8_t hold_mode)
+{
+    NVIC_DisableIRQ(MS8313_UPDATE_IRQn);
+    foc_control.pos_move_speed = move_speed;
+    foc_control.pos_deadband = deadband;
+    foc_control.hold_mode = hold_mode;
+    
+    if (foc_control.ctrl_mode == FOC_CTRL_POSITION) {
+        Traj_SetLimits(&foc_control.traj, move_speed / 60.0f, foc_control.traj.a_max,
+                       foc_control.traj.d_max, foc_control.traj.j_max);
+    }
+    NVIC_EnableIRQ(MS8313_UPDATE_IRQn);
+}
+
+/**
+ * @brief  设置位置环增益（无扰）
+ * @param  kp: 比例增益（RPM/圈）
+ * @param  ki: 积分增益（RPM/(圈·s)）
+ * @retval 无
+ */
+void FOC_SetPositionGain(float kp, float ki)
+{
+    NVIC_DisableIRQ(MS8313_UPDATE_IRQn);
+    PID_SetGains(&foc_control.pos_pi, kp, ki, 0.0f);
+    NVIC_EnableIRQ(MS8313_UPDATE_IRQn);
+}
+
+/**
+ * @brief  查询是否到位
+ * @retval 1: 位置控制中轨迹已结束且误差在死区内, 0: 运动中或速度控制
+ */
+uint8_t FOC_IsInPosition(void)
+{
+    return foc_control.ctrl_mode == FOC_CTRL_POSITION && foc_control.in_position;
 }
 
 /**
@@ -443,6 +1901,20 @@ void FOC_SetControl(float speed_ref, uint8_t direction)
  */
 void FOC_Enable(void)
 {
+    if (FOC_CheckFault()) {
+        return;
+    }
+    // 轨迹从当前位置静止起步，按加速度限制爬升到目标转速或移动到目标位置
+    Traj_Reset(&foc_control.traj, AS5600_GetTotalAngle(), 0.0f);
+    if (foc_control.ctrl_mode == FOC_CTRL_POSITION) {
+        Traj_SetPosition(&foc_control.traj, foc_control.pos_target);
+    }
+    PID_Reset(&foc_control.pos_pi, 0.0f);
+    foc_control.pos_corr = 0.0f;
+    foc_control.in_position = 0;
+    foc_control.dob.initialized = 0;
+    foc_control.dob.torque = 0.0f;
+    foc_control.dob.iq_comp = 0.0f;
     foc_control.enable = 1;
     MS8313_EnableOutput();
 }
@@ -457,6 +1929,27 @@ void FOC_Disable(void)
     MS8313_DisableOutput();
 }
 
+/**
+ * @brief  清除故障
+ * @retval 1: 全部清除, 0: 刹车输入仍有效，故障保留
+ */
+uint8_t FOC_ClearFault(void)
+{
+    MYADC_ClearFault();
+    if (MS8313_ClearFault()) {
+        foc_control.fault = FOC_FAULT_NONE;
+    } else {
+        foc_control.fault = FOC_FAULT_BREAK;
+    }
+    
+    // 积分器在故障前可能已饱和，重新使能时从0开始
+    PID_Reset(&foc_control.speed_pi, 0.0f);
+    PID_Reset(&foc_control.id_pi, 0.0f);
+    PID_Reset(&foc_control.iq_pi, 0.0f);
+    
+    return foc_control.fault == FOC_FAULT_NONE;
+}
+
 // ==================== 工具函数 ====================
 
 /**
@@ -469,6 +1962,62 @@ float FOC_AngleToRadian(uint16_t angle)
     return (float)angle * 2.0f * PI / 4096.0f;
 }
 
+/**
+ * @brief  查表计算电角度正余弦
+ * @note   四分之一周期表按象限翻转符号，分辨率 2π/4096，不调用 sinf/cosf，
+ *         供电流环中断使用
+ * @param  angle: 电角度（0-4095）
+ * @param  sin_out: 正弦输出指针
+ * @param  cos_out: 余弦输出指针
+ * @retval 无
+ */
+void FOC_SinCos(uint16_t angle, float *sin_out, float *cos_out)
+{
+    uint16_t idx = angle & 0x03FF;
+    
+    switch ((angle >> 10) & 0x03) {
+        case 0:
+            *sin_out = foc_sin_table[idx];
+            *cos_out = foc_sin_table[1024 - idx];
+            break;
+        case 1:
+            *sin_out = foc_sin_table[1024 - idx];
+            *cos_out = -foc_sin_table[idx];
+            break;
+        case 2:
+            *sin_out = -foc_sin_table[idx];
+            *cos_out = -foc_sin_table[1024 - idx];
+            break;
+        default:
+            *sin_out = -foc_sin_table[1024 - idx];
+            *cos_out = foc_sin_table[idx];
+            break;
+    }
+}
+
+/**
+ * @brief  位置角度转换为电角度
+ * @note   θe = p·(θm - 零点)，按计数取模，不经过浮点
+ * @param  angle: 位置角度（0-4095）
+ * @retval 电角度（0-4095，d轴方向）
+ */
+uint16_t FOC_AngleToElectrical(uint16_t angle)
+{
+    uint32_t mech = (uint16_t)(angle - foc_control.angle_offset) & 0x0FFF;
+    
+    return (uint16_t)((mech * foc_control.motor.pole_pairs) & 0x0FFF);
+}
+
+/**
+ * @brief  设置电角度零点
+ * @param  offset: 转子d轴对齐A相轴时的位置角度（0-4095）
+ * @retval 无
+ */
+void FOC_SetAngleOffset(uint16_t offset)
+{
+    foc_control.angle_offset = offset & 0x0FFF;
+}
+
 /**
  * @brief  限制电压值
  * @param  voltage: 电压值
@@ -485,6 +2034,7 @@ float FOC_LimitVoltage(float voltage, float min_val, float max_val)
 
 /**
  * @brief  获取FOC控制状态
+ * @note   只读取，不刷新故障码（故障由控制周期锁存）
  * @retval FOC控制结构体指针
  */
 FOC_Control_t* FOC_GetControlStatus(void)
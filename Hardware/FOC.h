@@ -3,11 +3,12 @@
 
 #include <stdint.h>
 #include <math.h>
+#include "PID.h"
+#include "Traj.h"
 
 // ==================== FOC配置参数 ====================
-#define FOC_CONTROL_FREQ       1000    // FOC控制频率（Hz）
-#define FOC_PWM_FREQ           16000    // PWM频率（Hz）
-#define FOC_PWM_PERIOD         1000    // PWM周期值
+#define FOC_CONTROL_FREQ       1000    // FOC标称控制频率（Hz）
+// PWM频率、周期值和实际控制频率由 MS8313_GetTiming() 在运行时提供
 
 // 数学常量
 #define PI                     3.14159265358979f
@@ -15,29 +16,217 @@
 #define SQRT3_INV             0.57735026918963f
 
 // FOC控制参数
-#define FOC_MAX_VOLTAGE        12.0f   // 最大电压（V）
+#define FOC_MAX_VOLTAGE        12.0f   // 最大电压（V，电机额定），同时受母线电压线性调制上限 Vbus/√3 限制
 #define FOC_MIN_VOLTAGE        0.0f    // 最小电压（V）
 #define FOC_MAX_SPEED          3000.0f // 最大转速（RPM）
 #define FOC_MIN_SPEED          0.0f    // 最小转速（RPM）
 
-// PI控制器参数
-#define PI_SPEED_KP            0.1f    // 速度环比例增益
-#define PI_SPEED_KI            0.01f   // 速度环积分增益
+// PI控制器参数（物理单位，积分增益按 1/s，与控制频率无关）
+#define PI_SPEED_KP            0.1f    // 速度环比例增益（电压模式，V/RPM）
+#define PI_SPEED_KI            10.0f   // 速度环积分增益（电压模式，V/(RPM·s)）
 #define PI_SPEED_MAX           10.0f   // 速度环输出限制
 #define PI_SPEED_MIN           -10.0f  // 速度环输出限制
 
+// 电流环（转矩模式）：速度环输出 iq 参考，d/q 电流PI在PWM频率运行
+// 电流PI按 Kp = L·ωc，Ki = R·ωc 整定，采样周期随PWM频率自动同步
+#define FOC_CURRENT_LOOP       1       // 默认控制模式：1 = 电流环（转矩模式），0 = 电压模式
+#define FOC_MAX_CURRENT        2.0f    // q轴电流限制（A）
+#define PI_SPEED_IQ_KP         0.005f  // 速度环比例增益（电流模式，A/RPM）
+#define PI_SPEED_IQ_KI         0.5f    // 速度环积分增益（电流模式，A/(RPM·s)）
+#define PI_CURRENT_KP          2.0f    // d/q电流环比例增益（V/A）
+#define PI_CURRENT_KI          3600.0f // d/q电流环积分增益（V/(A·s)）
+
+// 速度环增益调度：按 |转速参考| 在断点间线性插值 (kp, ki)，两端之外保持端点增益；
+// 两种输出单位各一张表，点数为0时使用 FOC_SetSpeedGain 的固定增益
+#define FOC_GAIN_POINTS        4       // 每张表最多断点数
+
+// 电机参数（前馈用，按实测或辨识结果填写）
+// 电角度由 FOC_AngleToElectrical 按 θe = p·(θm - angle_offset) 换算，极对数须与电机一致，
+// angle_offset 由 FOC_CalibrateCurrent / MotorID_Run 对齐标定后经 FOC_SetAngleOffset 设置
+#define FOC_MOTOR_POLE_PAIRS   1       // 极对数
+#define FOC_MOTOR_RS           1.0f    // 相电阻（Ω）
+#define FOC_MOTOR_LD           0.0005f // d轴电感（H）
+#define FOC_MOTOR_LQ           0.0005f // q轴电感（H）
+#define FOC_MOTOR_FLUX         0.0f    // 永磁磁链（V·s/rad，相电压峰值 / 电角速度），0 = 未整定，反电势前馈不起作用
+#define FOC_MOTOR_INERTIA      0.0f    // 转动惯量（kg·m²）
+#define FOC_MOTOR_FRICTION     0.0f    // 粘滞摩擦系数（N·m·s/rad）
+#define FOC_FEEDFORWARD        1       // 默认使能模型前馈
+
+// 负载转矩扰动观测器：T̂ = LPF(Kt·iq指令 - J·dω/dt - B·ω)，按名义惯量/摩擦估计，
+// 不对转速求导（内部状态 z = T̂ + g·J·ω）；补偿电流 T̂/Kt 叠加到速度环前馈，
+// 电压模式乘 Rs 换算为电压。惯量或磁链为0（未整定）时不起作用
+#define FOC_DOB_ENABLE         1       // 默认使能扰动观测器
+#define FOC_DOB_CUTOFF         20.0f   // 观测带宽（Hz），受转速估计噪声限制
+#define FOC_DOB_GAIN           1.0f    // 补偿比例（0-1）
+
+// 速度轨迹（S曲线）：转速参考按加速度/加加速度限制变化，不再阶跃
+#define FOC_TRAJ_ACCEL         3000.0f // 最大加速度（RPM/s）
+#define FOC_TRAJ_DECEL         3000.0f // 最大减速度（RPM/s）
+#define FOC_TRAJ_JERK          30000.0f // 最大加加速度（RPM/s²，即转速的二阶导数 rev/min/s²，除以60为 rev/s³）
+
+// 位置环（串级：位置 → 速度环），反馈为 AS5600 多圈累计角度（圈）
+// 速度参考 = 轨迹速度前馈 + 位置环修正，加速度前馈经 iq_ff 进入速度环输出
+#define FOC_CTRL_SPEED         0       // 控制模式：速度控制
+#define FOC_CTRL_POSITION      1       // 控制模式：位置控制
+#define FOC_HOLD_SERVO         0       // 到位后位置环继续保持（死区外修正）
+#define FOC_HOLD_SPEED         1       // 到位后停止位置修正，速度环保持零速
+#define FOC_POS_DIVIDER        4       // 位置环分频：每 N 个控制周期执行一次
+#define FOC_POS_KP             600.0f  // 位置环比例增益（RPM/圈）
+#define FOC_POS_KI             0.0f    // 位置环积分增益（RPM/(圈·s)），速度环已含积分，通常为0
+#define FOC_POS_MAX_CORR       600.0f  // 位置环修正量限制（RPM）
+#define FOC_POS_DEADBAND       0.002f  // 到位死区（圈）
+#define FOC_POS_MOVE_SPEED     600.0f  // 默认移动最大转速（RPM）
+#define FOC_POS_HOLD           FOC_HOLD_SERVO  // 默认保持方式
+
+// 运行模式
+#define FOC_MODE_FOC           0       // 矢量控制（正弦SVPWM）
+#define FOC_MODE_SIXSTEP       1       // 六步方波换相（高速低开销）
+#define FOC_SIXSTEP_ENTER_RPM  2500.0f // 转速高于此值切换到六步换相（RPM）
+#define FOC_SIXSTEP_EXIT_RPM   2200.0f // 转速低于此值切回矢量控制（RPM）
+
+// 死区/驱动延迟补偿参数（按实测调整）
+// 每个开关沿损失的伏秒 ∝ 死区 + 开通延迟 - 关断延迟，方向取决于相电流符号
+#define FOC_DT_DEADTIME_NS     300.0f  // MS8313内部死区时间（ns）
+#define FOC_DT_TON_DELAY_NS    150.0f  // 开通传播延迟（ns）
+#define FOC_DT_TOFF_DELAY_NS   100.0f  // 关断传播延迟（ns）
+#define FOC_DT_CURRENT_BAND    0.05f   // 实测电流过零线性区（A），避免符号抖动
+#define FOC_DT_EST_BAND        0.1f    // 估计电流过零线性区（相对电流幅值）
+#define FOC_DT_EST_LAG         0.0f    // 估计电流相对电压矢量的滞后角（弧度）
+
+// 低边电流采样窗口与最小脉宽（按ADC采样时间和驱动器要求调整）
+#define FOC_SAMPLE_WINDOW_NS   2000.0f // 谷点附近下管最短导通时间（ns），保证低边采样有效
+#define FOC_MIN_PULSE_NS       400.0f  // 最小脉宽（ns），更窄的脉冲取整为0；下管至少导通此时间（自举充电）
+
+// 单电阻采样窗口（MYADC_SHUNT_NUM = 1）：每个有效矢量在上半周期内至少持续
+// 稳定时间 + 采样时间；两次触发间隔不小于窗口，须覆盖一次转换（1.67us）和中断响应
+#define FOC_SS_WINDOW_NS       2500.0f // 有效矢量最短持续时间（ns）
+#define FOC_SS_SAMPLE_NS       700.0f  // 采样保持时间（ns），触发点位于窗口结束前此时间
+
+// 电流采样启动校准（总时间不超过 FOC_CAL_TIMEOUT_MS，不拖慢启动）
+#define FOC_CAL_GAIN_CHECK     1       // 1: 偏置之后做增益校验（沿A相轴注入d轴电压，转子被吸合锁定，同时标定电角度零点）
+#define FOC_CAL_TIMEOUT_MS     300     // 校准总时间上限（ms）
+#define FOC_CAL_SETTLE_MS      5       // 打开输出后等待放大器稳定（ms）
+#define FOC_CAL_ALIGN_MS       150     // 注入电压斜坡 + 转子对齐、电流稳定时间（ms）
+#define FOC_CAL_OFFSET_SAMPLES 512     // 偏置平均次数（18kHz下约28ms）
+#define FOC_CAL_GAIN_SAMPLES   512     // 增益校验平均次数
+#define FOC_CAL_VOLTAGE        1.0f    // 增益校验注入电压（V），按相电阻选取，使电流约为额定的一半
+#define FOC_CAL_OFFSET_TOL     200     // 偏置与中点 MYADC_CURRENT_OFFSET 的最大偏差（计数），超出说明放大器异常
+#define FOC_CAL_MIN_COUNTS     50.0f   // 增益校验A相最小电流（计数，约0.2A），过小时不修正增益
+#define FOC_CAL_GAIN_TOL       0.2f    // 增益修正允许范围（1 ± 此值）
+
+// 校准结果
+#define FOC_CAL_OFFSET_OK      0x01
+#define FOC_CAL_GAIN_OK        0x02
+#define FOC_CAL_ANGLE_OK       0x04
+
+// 故障码（可同时存在）
+#define FOC_FAULT_NONE         0x00
+#define FOC_FAULT_OVERCURRENT  0x01    // ADC模拟看门狗过流
+#define FOC_FAULT_BREAK        0x02    // 定时器刹车输入（仅TIM1后端）
+
+// 相位掩码
+#define FOC_PHASE_MASK_A       0x01
+#define FOC_PHASE_MASK_B       0x02
+#define FOC_PHASE_MASK_C       0x04
+
 // ==================== 数据结构 ====================
 /**
- * @brief PI控制器结构体
+ * @brief 电机参数结构体
  */
 typedef struct {
-    float kp;                   // 比例增益
-    float ki;                   // 积分增益
-    float integral;             // 积分项
-    float output_max;           // 输出上限
-    float output_min;           // 输出下限
-    float last_error;           // 上次误差
-} PI_Controller_t;
+    float rs;                   // 相电阻（Ω）
+    float ld;                   // d轴电感（H）
+    float lq;                   // q轴电感（H）
+    float flux;                 // 永磁磁链 λ（V·s/rad），即反电势常数 Ke（按电角速度）
+    float inertia;              // 转动惯量（kg·m²）
+    float friction;             // 粘滞摩擦系数（N·m·s/rad）
+    uint8_t pole_pairs;         // 极对数
+} FOC_MotorParam_t;
+
+/**
+ * @brief 死区补偿结构体
+ */
+typedef struct {
+    uint8_t enable;             // 补偿使能
+    float error_ns;             // 每周期电压误差时间（死区 + 开通延迟 - 关断延迟，ns）
+    float comp_counts;          // 每相补偿量（PWM计数，随PWM时序重算）
+    float current_band;         // 实测电流过零线性区（A）
+    float est_band;             // 估计电流过零线性区（相对幅值）
+    float est_cos;              // 估计电流滞后角余弦
+    float est_sin;              // 估计电流滞后角正弦
+    uint8_t current_valid;      // 1: 使用实测相电流, 0: 由电压指令估计
+    float ia;                   // 实测A相电流（A）
+    float ib;                   // 实测B相电流（A）
+    float ic;                   // 实测C相电流（A）
+    float comp_a;               // 本周期A相补偿量（计数）
+    float comp_b;               // 本周期B相补偿量（计数）
+    float comp_c;               // 本周期C相补偿量（计数）
+} FOC_DeadTime_t;
+
+/**
+ * @brief 采样窗口与最小脉宽结构体
+ */
+typedef struct {
+    float window_ns;            // 采样窗口（ns）
+    float min_pulse_ns;         // 最小脉宽（ns）
+    uint16_t window;            // 采样窗口（PWM计数，随PWM时序重算）
+    uint16_t min_pulse;         // 最小脉宽（PWM计数）
+    float ss_window_ns;         // 单电阻：有效矢量最短持续时间（ns）
+    float ss_sample_ns;         // 单电阻：采样保持时间（ns）
+    uint16_t ss_window;         // 单电阻：有效矢量最短持续时间（半周期内的定时器计数）
+    uint16_t ss_sample;         // 单电阻：采样保持时间（定时器计数）
+    uint8_t unsampled;          // 本周期无法采样的相（FOC_PHASE_MASK_x 组合）
+} FOC_Sampling_t;
+
+/**
+ * @brief 速度环继电反馈实验结构体
+ * @note  速度环输出替换为 bias ± amplitude 的带滞环继电器，速度在设定值附近自激振荡；
+ *        每个完整周期（输出从负切到正）记录一次周期和速度振幅
+ */
+typedef struct {
+    uint8_t active;             // 1: 实验进行中
+    int8_t state;               // 继电器状态（+1 / -1）
+    float setpoint;             // 转速设定值（RPM）
+    float bias;                 // 输出偏置（开始时速度环输出，维持工作点）
+    float amplitude;            // 继电器幅值（速度环输出单位：A 或 V）
+    float hysteresis;           // 切换滞环（RPM）
+    float speed_max;            // 本周期转速最大值（RPM）
+    float speed_min;            // 本周期转速最小值（RPM）
+    uint32_t count;             // 实验开始后的控制周期数
+    uint32_t last_rise;         // 上次切到正输出的控制周期数
+    float period;               // 最近一个振荡周期（s）
+    float speed_amp;            // 最近一个周期的转速振幅（RPM，峰峰值/2）
+    uint16_t cycles;            // 已完成的振荡周期数
+} FOC_Relay_t;
+
+/**
+ * @brief 负载转矩扰动观测器结构体
+ */
+typedef struct {
+    uint8_t enable;             // 1: 观测并补偿
+    uint8_t initialized;        // 0: 下次更新时按当前转速预置状态，估计从0开始
+    float cutoff;               // 观测带宽（Hz）
+    float g;                    // 观测带宽（rad/s）
+    float gain;                 // 补偿比例（0-1）
+    float z;                    // 内部状态（N·m）
+    float torque;               // 负载转矩估计（N·m，阻碍正转为正）
+    float iq_comp;              // 补偿电流（A，已乘补偿比例并限幅）
+} FOC_DOB_t;
+
+/**
+ * @brief 速度环增益调度表
+ * @note  区间斜率在设表时预计算；查表从上次所在区间出发，转速连续变化时
+ *        每周期最多移动一格，插值只需一次减法和每个增益一次乘加
+ */
+typedef struct {
+    uint8_t count;                      // 断点数（0 = 不调度，1 不允许）
+    uint8_t index;                      // 上次所在区间（断点 index 与 index+1 之间）
+    float speed[FOC_GAIN_POINTS];       // 断点转速（RPM，严格升序，按绝对值）
+    float kp[FOC_GAIN_POINTS];          // 断点比例增益
+    float ki[FOC_GAIN_POINTS];          // 断点积分增益（1/s）
+    float kp_slope[FOC_GAIN_POINTS];    // 区间比例增益斜率（1/RPM）
+    float ki_slope[FOC_GAIN_POINTS];    // 区间积分增益斜率
+} FOC_GainSched_t;
 
 /**
  * @brief FOC控制结构体
@@ -45,17 +234,31 @@ typedef struct {
 typedef struct {
     // 输入参数
     uint16_t angle;             // 位置角度（0-4095）
+    uint16_t angle_offset;      // 电角度零点（转子d轴对齐A相轴时的位置角度，0-4095）
+    uint16_t loop_count;        // 主控制循环调用次数（判断位置角度是否在更新）
     float speed_rpm;            // 实际转速（RPM）
-    float speed_ref;            // 转速参考值（RPM）
+    float speed_ref;            // 转速参考值（RPM，轨迹输出）
+    float speed_target;         // 目标转速（RPM，FOC_SetControl 设定）
     float voltage_ref;          // 电压参考值
+    float vbus;                 // 母线电压（V，滤波后）
+    float vbus_inv;             // 母线电压倒数（1/V）
     
     // 坐标变换
-    float theta;                // 电角度（弧度）
+    float theta;                // 电角度（弧度，d轴 = 转子磁链方向，A相轴为0）
     float valpha;               // α轴电压
     float vbeta;                // β轴电压
     float vd;                   // d轴电压
     float vq;                   // q轴电压
     
+    // 电流环
+    uint8_t current_loop;       // 1: 电流环（转矩模式）, 0: 电压模式
+    float ialpha;               // α轴电流
+    float ibeta;                // β轴电流
+    float id;                   // d轴电流（A）
+    float iq;                   // q轴电流（A）
+    float id_ref;               // d轴电流参考（A）
+    float iq_ref;               // q轴电流参考（A，速度环输出）
+    
     // PWM输出
     uint16_t pwm_a;             // A相PWM
     uint16_t pwm_b;             // B相PWM
@@ -64,9 +267,49 @@ typedef struct {
     // 控制状态
     uint8_t enable;             // 使能标志
     uint8_t direction;          // 方向（0=正转，1=反转）
+    uint8_t mode;               // 运行模式（FOC_MODE_FOC / FOC_MODE_SIXSTEP）
+    uint8_t fault;              // 锁存的故障码（FOC_FAULT_x 组合），非0时控制保持禁用
+    float sixstep_enter_rpm;    // 进入六步换相转速（RPM）
+    float sixstep_exit_rpm;     // 退出六步换相转速（RPM）
+    
+    // 模型前馈
+    FOC_MotorParam_t motor;     // 电机参数
+    uint8_t ff_enable;          // 1: 前馈使能
+    float omega_e;              // 电角速度（rad/s，观测器转速换算）
+    float vd_ff;                // d轴前馈电压（V）：-ω·Lq·iq
+    float vq_ff;                // q轴前馈电压（V）：ω·(λ + Ld·id)；电压模式为 ω·λ
+    float iq_ff;                // q轴前馈电流（A）：(J·α + B·ω) / Kt，按轨迹加速度/速度（电流模式）
+    FOC_DOB_t dob;              // 负载转矩扰动观测器（补偿量含在 iq_ff / vq_ff 中）
+    
+    // 轨迹
+    Traj_t traj;                // 转速/位置轨迹（圈、rev/s、rev/s²、rev/s³）
+    
+    // 位置环
+    uint8_t ctrl_mode;          // 控制模式（FOC_CTRL_SPEED / FOC_CTRL_POSITION）
+    uint8_t hold_mode;          // 到位保持方式（FOC_HOLD_x）
+    uint8_t in_position;        // 1: 轨迹结束且误差在死区内
+    uint8_t pos_count;          // 位置环分频计数
+    float pos_target;           // 目标位置（圈）
+    float pos_actual;           // 实际位置（圈，AS5600多圈累计）
+    float pos_deadband;         // 到位死区（圈）
+    float pos_move_speed;       // 移动最大转速（RPM）
+    float pos_corr;             // 位置环修正量（RPM）
+    PID_t pos_pi;               // 位置环控制器（输出RPM）
     
     // PI控制器
-    PI_Controller_t speed_pi;   // 速度环PI控制器
+    PID_t speed_pi;             // 速度环PI控制器
+    float speed_kp[2];          // 速度环比例增益（[0] 电压输出 V/RPM，[1] 电流输出 A/RPM）
+    float speed_ki[2];          // 速度环积分增益（[0] V/(RPM·s)，[1] A/(RPM·s)）
+    FOC_GainSched_t gain_sched[2];  // 速度环增益调度表（[0] 电压输出，[1] 电流输出）
+    FOC_Relay_t relay;          // 继电反馈实验（自整定）
+    PID_t id_pi;                // d轴电流环PI控制器
+    PID_t iq_pi;                // q轴电流环PI控制器
+    
+    // 死区补偿
+    FOC_DeadTime_t dead_time;   // 死区/驱动延迟补偿
+    
+    // 采样窗口
+    FOC_Sampling_t sampling;    // 低边采样窗口与最小脉宽
 } FOC_Control_t;
 
 // ==================== 函数声明 ====================
@@ -123,8 +366,8 @@ uint8_t FOC_SVPWM_GetSector(float valpha, float vbeta);
 
 /**
  * @brief  SVPWM矢量时间计算
- * @param  valpha: α轴电压
- * @param  vbeta: β轴电压
+ * @param  valpha: α轴电压（已按 √3·周期值/Vbus 归一化为计数）
+ * @param  vbeta: β轴电压（已归一化为计数）
  * @param  sector: 扇区号
  * @param  t1: 矢量1时间指针
  * @param  t2: 矢量2时间指针
@@ -148,6 +391,37 @@ void FOC_SVPWM_CalculateTimes(float valpha, float vbeta, uint8_t sector,
 void FOC_SVPWM_GeneratePWM(uint8_t sector, float t1, float t2, float t0,
                           uint16_t *pwm_a, uint16_t *pwm_b, uint16_t *pwm_c);
 
+/**
+ * @brief  采样窗口与最小脉宽整形
+ * @note   通过平移零序分量（三相同加减）保证下管在谷点附近导通至少一个采样窗口，
+ *         线电压不变；三相无法同时满足时优先保证两相可采样
+ * @param  pwm_a: A相PWM指针（输入输出）
+ * @param  pwm_b: B相PWM指针（输入输出）
+ * @param  pwm_c: C相PWM指针（输入输出）
+ * @retval 无法采样的相（FOC_PHASE_MASK_x 组合）
+ */
+uint8_t FOC_SVPWM_ApplyWindow(uint16_t *pwm_a, uint16_t *pwm_b, uint16_t *pwm_c);
+
+/**
+ * @brief  单电阻采样移相整形并输出
+ * @note   两个有效矢量在上半周期的持续时间即 FOC_SVPWM_CalculateTimes 的 t1/t2（含死区补偿），
+ *         不足采样窗口时把最大相上半周期的导通沿提前、最小相推后，
+ *         下半周期反向补偿，各相平均占空比不变
+ * @param  pwm_a: A相PWM（平均占空比）
+ * @param  pwm_b: B相PWM
+ * @param  pwm_c: C相PWM
+ * @retval 无法采样的相（FOC_PHASE_MASK_x 组合）
+ */
+uint8_t FOC_SVPWM_SingleShunt(uint16_t pwm_a, uint16_t pwm_b, uint16_t pwm_c);
+
+/**
+ * @brief  设置采样窗口与最小脉宽
+ * @param  window_ns: 采样窗口（ns）
+ * @param  min_pulse_ns: 最小脉宽（ns）
+ * @retval 无
+ */
+void FOC_SetSampleWindow(float window_ns, float min_pulse_ns);
+
 /**
  * @brief  SVPWM主函数
  * @param  valpha: α轴电压
@@ -156,34 +430,175 @@ void FOC_SVPWM_GeneratePWM(uint8_t sector, float t1, float t2, float t0,
  */
 void FOC_SVPWM_Generate(float valpha, float vbeta);
 
-// ==================== PI控制器函数 ====================
 /**
- * @brief  PI控制器初始化
- * @param  pi: PI控制器结构体指针
- * @param  kp: 比例增益
- * @param  ki: 积分增益
- * @param  output_max: 输出上限
- * @param  output_min: 输出下限
+ * @brief  开环输出电压矢量（控制禁用时）
+ * @note   供参数辨识等实验直接给定 α/β 电压，FOC使能时忽略；
+ *         调用前须已用 MS8313_EnableOutput 打开输出
+ * @param  valpha: α轴电压（V）
+ * @param  vbeta: β轴电压（V）
  * @retval 无
  */
-void FOC_PI_Init(PI_Controller_t *pi, float kp, float ki, float output_max, float output_min);
+void FOC_SetOpenLoopVoltage(float valpha, float vbeta);
 
+// ==================== 死区补偿函数 ====================
 /**
- * @brief  PI控制器计算
- * @param  pi: PI控制器结构体指针
- * @param  error: 误差值
- * @retval PI控制器输出
+ * @brief  配置死区补偿参数
+ * @param  deadtime_ns: 死区时间（ns）
+ * @param  ton_delay_ns: 开通传播延迟（ns）
+ * @param  toff_delay_ns: 关断传播延迟（ns）
+ * @param  est_lag: 估计电流相对电压矢量的滞后角（弧度）
+ * @retval 无
  */
-float FOC_PI_Calculate(PI_Controller_t *pi, float error);
+void FOC_DeadTime_Config(float deadtime_ns, float ton_delay_ns, float toff_delay_ns, float est_lag);
 
 /**
- * @brief  PI控制器重置
- * @param  pi: PI控制器结构体指针
+ * @brief  使能/禁用死区补偿
+ * @param  enable: 1=使能, 0=禁用
  * @retval 无
  */
-void FOC_PI_Reset(PI_Controller_t *pi);
+void FOC_DeadTime_Enable(uint8_t enable);
+
+/**
+ * @brief  输入实测相电流（有电流采样时每周期调用）
+ * @note   调用后补偿改用实测电流符号，未调用时由电压指令方向估计
+ * @param  ia: A相电流（A，流出逆变器为正）
+ * @param  ib: B相电流（A）
+ * @param  ic: C相电流（A）
+ * @retval 无
+ */
+void FOC_DeadTime_SetCurrent(float ia, float ib, float ic);
+
+/**
+ * @brief  对三相占空比施加死区补偿
+ * @param  valpha: α轴电压指令（用于估计电流方向）
+ * @param  vbeta: β轴电压指令
+ * @param  pwm_a: A相PWM指针（输入输出）
+ * @param  pwm_b: B相PWM指针（输入输出）
+ * @param  pwm_c: C相PWM指针（输入输出）
+ * @retval 无
+ */
+void FOC_DeadTime_Compensate(float valpha, float vbeta,
+                             uint16_t *pwm_a, uint16_t *pwm_b, uint16_t *pwm_c);
 
 // ==================== 控制函数 ====================
+/**
+ * @brief  设置电机参数
+ * @param  param: 电机参数
+ * @retval 无
+ */
+void FOC_SetMotorParam(const FOC_MotorParam_t *param);
+
+/**
+ * @brief  使能/禁用模型前馈
+ * @note   前馈承担反电势和d/q交叉耦合，PI只需修正模型误差，可用更低的增益；
+ *         切换时把差值转入积分，输出不跳变
+ * @param  enable: 1=使能, 0=禁用
+ * @retval 无
+ */
+void FOC_SetFeedforward(uint8_t enable);
+
+/**
+ * @brief  配置负载转矩扰动观测器
+ * @note   使能时估计从0开始，修改带宽时保持当前估计；
+ *         禁用或修改补偿比例引起的补偿量变化转入速度环积分，输出不跳变
+ * @param  enable: 1=使能, 0=禁用
+ * @param  cutoff: 观测带宽（Hz）
+ * @param  gain: 补偿比例（0-1，0 = 只观测不补偿）
+ * @retval 无
+ */
+void FOC_SetDisturbanceObserver(uint8_t enable, float cutoff, float gain);
+
+/**
+ * @brief  设置转速轨迹的加速度限制
+ * @note   运动中修改立即生效；加速和减速分开限制
+ * @param  accel: 最大加速度（RPM/s）
+ * @param  decel: 最大减速度（RPM/s）
+ * @param  jerk: 最大加加速度（RPM/s²，即 rev/min/s²，内部除以60换算为 rev/s³）
+ * @retval 无
+ */
+void FOC_SetAccelLimits(float accel, float decel, float jerk);
+
+/**
+ * @brief  移动到绝对位置（切换到位置控制）
+ * @note   运动中可重新设定目标；从速度控制切换时轨迹从当前位置和速度衔接
+ * @param  position: 目标位置（圈，AS5600多圈累计角度）
+ * @retval 无
+ */
+void FOC_MoveTo(float position);
+
+/**
+ * @brief  相对移动（切换到位置控制）
+ * @note   位置控制中相对当前目标位置，否则相对实际位置
+ * @param  distance: 移动距离（圈，正值为正转方向）
+ * @retval 无
+ */
+void FOC_MoveBy(float distance);
+
+/**
+ * @brief  设置位置控制参数
+ * @param  move_speed: 移动最大转速（RPM）
+ * @param  deadband: 到位死区（圈）
+ * @param  hold_mode: 到位保持方式（FOC_HOLD_SERVO / FOC_HOLD_SPEED）
+ * @retval 无
+ */
+void FOC_SetPositionParam(float move_speed, float deadband, uint8_t hold_mode);
+
+/**
+ * @brief  设置位置环增益（无扰）
+ * @param  kp: 比例增益（RPM/圈）
+ * @param  ki: 积分增益（RPM/(圈·s)）
+ * @retval 无
+ */
+void FOC_SetPositionGain(float kp, float ki);
+
+/**
+ * @brief  查询是否到位
+ * @retval 1: 位置控制中轨迹已结束且误差在死区内, 0: 运动中或速度控制
+ */
+uint8_t FOC_IsInPosition(void);
+
+/**
+ * @brief  设置速度环增益
+ * @note   两种输出单位各保存一组，模式切换时按当前单位选用；当前正在使用的一组无扰更新
+ * @param  current_units: 1=电流输出（A/RPM）, 0=电压输出（V/RPM）
+ * @param  kp: 比例增益
+ * @param  ki: 积分增益（1/s）
+ * @retval 无
+ */
+void FOC_SetSpeedGain(uint8_t current_units, float kp, float ki);
+
+/**
+ * @brief  设置速度环增益调度表
+ * @note   表生效后速度环每周期按 |转速参考| 插值增益并无扰更新，固定增益不再使用；
+ *         count = 0 时取消调度，当前正在使用的一组无扰恢复固定增益
+ * @param  current_units: 1=电流输出（A/RPM）, 0=电压输出（V/RPM）
+ * @param  speed: 断点转速（RPM，严格升序）
+ * @param  kp: 断点比例增益
+ * @param  ki: 断点积分增益（1/s）
+ * @param  count: 断点数（0 或 2 ~ FOC_GAIN_POINTS）
+ * @retval 1: 成功, 0: 点数或转速顺序无效，原表不变
+ */
+uint8_t FOC_SetGainSchedule(uint8_t current_units, const float speed[], const float kp[],
+                            const float ki[], uint8_t count);
+
+/**
+ * @brief  开始速度环继电反馈实验
+ * @note   以当前速度环输出为偏置，速度环输出改为 bias ± amplitude，
+ *         误差超出 ±hysteresis 时切换；FOC_GetControlStatus()->relay 读取结果
+ * @param  setpoint: 转速设定值（RPM）
+ * @param  amplitude: 继电器幅值（当前速度环输出单位：A 或 V）
+ * @param  hysteresis: 切换滞环（RPM）
+ * @retval 无
+ */
+void FOC_StartRelay(float setpoint, float amplitude, float hysteresis);
+
+/**
+ * @brief  结束继电反馈实验
+ * @note   速度环积分预置为偏置，恢复闭环时输出不跳变
+ * @retval 无
+ */
+void FOC_StopRelay(void);
+
 /**
  * @brief  速度环控制（闭环速度控制）
  * @param  speed_ref: 转速参考值（RPM）
@@ -195,15 +610,74 @@ void FOC_SpeedControl(float speed_ref, float speed_actual, float *voltage_ref);
 
 /**
  * @brief  FOC主控制循环（闭环）
+ * @note   每个控制周期调用；控制禁用时也更新角度和转速并锁存故障码
  * @param  angle: 位置角度（0-4095）
  * @param  speed_rpm: 实际转速（RPM）
  * @retval 无
  */
 void FOC_MainLoop(uint16_t angle, float speed_rpm);
 
+/**
+ * @brief  d/q电流环（PWM频率）
+ * @note   在电流采样完成中断中调用：测量电流 Clarke/Park 变换，
+ *         d/q 两个PI输出电压，矢量限幅到 Vbus/√3 后逆Park并SVPWM输出；
+ *         仅在电流模式且非六步换相时生效
+ * @param  ia: A相电流（A）
+ * @param  ib: B相电流（A）
+ * @param  ic: C相电流（A）
+ * @param  angle: 位置角度（0-4095，宜用预测到采样时刻的角度）
+ * @retval 无
+ */
+void FOC_CurrentLoop(float ia, float ib, float ic, uint16_t angle);
+
+/**
+ * @brief  切换电流环/电压模式
+ * @note   切换时预置速度环积分，输出不跳变
+ * @param  enable: 1=电流环（转矩模式）, 0=电压模式
+ * @retval 无
+ */
+void FOC_SetCurrentLoop(uint8_t enable);
+
+/**
+ * @brief  电流采样启动校准
+ * @note   须在 FOC_Enable 之前调用（控制禁用时）。
+ *         1. 三相50%（零矢量）输出，平均各通道注入组采样得到零电流偏置；
+ *         2. 可选增益校验：沿A相轴注入 FOC_CAL_VOLTAGE，转子吸合后稳态 ib = ic = -ia/2，
+ *            由此修正B/C通道相对A通道的增益（绝对标度由分流电阻和放大倍数决定，无法在线校验）；
+ *            转子d轴此时对齐A相轴，控制回调在运行时记录位置角度作为电角度零点；
+ *         各步骤共用 FOC_CAL_TIMEOUT_MS 时间上限，超时的步骤放弃，保留原校准值。
+ *         结束后恢复零矢量并关闭输出，新校准值已写入ADC模块，零点已生效
+ * @param  gain_check: 1=做增益校验
+ * @param  offset: 各通道偏置（输入为当前值，输出为校准结果）
+ * @param  gain: 各通道增益修正（输入为当前值，输出为校准结果）
+ * @param  angle_offset: 电角度零点（输入为当前值，输出为校准结果）
+ * @retval 成功的步骤（FOC_CAL_OFFSET_OK | FOC_CAL_GAIN_OK | FOC_CAL_ANGLE_OK）
+ */
+uint8_t FOC_CalibrateCurrent(uint8_t gain_check, uint16_t offset[3], float gain[3], uint16_t *angle_offset);
+
+/**
+ * @brief  六步换相输出
+ * @note   由角度直接查表得到换相步，线电压占空比取速度环电压指令，
+ *         每周期只有一次乘法和查表，不做三角函数和坐标变换
+ * @param  angle: 电压矢量方向（电角度，0-4095）
+ * @param  voltage_ref: 电压参考值（V，与矢量控制的相电压幅值同标度）
+ * @retval 无
+ */
+void FOC_SixStep(uint16_t angle, float voltage_ref);
+
+/**
+ * @brief  设置六步换相切换转速（滞环）
+ * @param  enter_rpm: 转速高于此值切换到六步换相（RPM），<= 0 时禁用六步换相
+ * @param  exit_rpm: 转速低于此值切回矢量控制（RPM）
+ * @retval 无
+ */
+void FOC_SetSixStepSpeed(float enter_rpm, float exit_rpm);
+
 /**
  * @brief  设置FOC控制参数
- * @param  speed_ref: 转速参考值（RPM）
+ * @note   目标转速经S曲线轨迹平滑后作为速度环参考，运动中可随时修改；
+ *         位置控制中调用则退出位置控制
+ * @param  speed_ref: 目标转速（RPM）
  * @param  direction: 方向（0=正转，1=反转）
  * @retval 无
  */
@@ -211,6 +685,7 @@ void FOC_SetControl(float speed_ref, uint8_t direction);
 
 /**
  * @brief  使能FOC控制
+ * @note   有未清除的故障时不使能
  * @retval 无
  */
 void FOC_Enable(void);
@@ -221,6 +696,14 @@ void FOC_Enable(void);
  */
 void FOC_Disable(void);
 
+/**
+ * @brief  清除故障
+ * @note   过流和刹车故障的硬件关断在中断中已完成，这里只清除锁存；
+ *         清除后控制保持禁用，需重新调用 FOC_Enable
+ * @retval 1: 全部清除, 0: 刹车输入仍有效，故障保留
+ */
+uint8_t FOC_ClearFault(void);
+
 // ==================== 工具函数 ====================
 /**
  * @brief  角度转换为弧度
@@ -229,6 +712,31 @@ void FOC_Disable(void);
  */
 float FOC_AngleToRadian(uint16_t angle);
 
+/**
+ * @brief  查表计算电角度正余弦
+ * @note   四分之一周期正弦表，分辨率 2π/4096，用于电流环中断代替 sinf/cosf
+ * @param  angle: 电角度（0-4095）
+ * @param  sin_out: 正弦输出指针
+ * @param  cos_out: 余弦输出指针
+ * @retval 无
+ */
+void FOC_SinCos(uint16_t angle, float *sin_out, float *cos_out);
+
+/**
+ * @brief  位置角度转换为电角度
+ * @note   θe = p·(θm - 零点)，传感器正方向须与相序一致（A → B → C）
+ * @param  angle: 位置角度（0-4095）
+ * @retval 电角度（0-4095，d轴方向）
+ */
+uint16_t FOC_AngleToElectrical(uint16_t angle);
+
+/**
+ * @brief  设置电角度零点
+ * @param  offset: 转子d轴对齐A相轴时的位置角度（0-4095）
+ * @retval 无
+ */
+void FOC_SetAngleOffset(uint16_t offset);
+
 /**
  * @brief  限制电压值
  * @param  voltage: 电压值
@@ -240,6 +748,8 @@ float FOC_LimitVoltage(float voltage, float min_val, float max_val);
 
 /**
  * @brief  获取FOC控制状态
+ * @note   无副作用；fault 由 FOC_MainLoop 每个控制周期锁存（控制禁用时也刷新），
+ *         轮询 fault 的代码须在控制回调运行时调用
  * @retval FOC控制结构体指针
  */
 FOC_Control_t* FOC_GetControlStatus(void);
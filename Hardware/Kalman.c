@@ -0,0 +1,252 @@
+#include "Kalman.h"
+
+/**
+ * @brief  定点乘法：x * gain（Q30）
+ */
+static int32_t Kalman_MulGain(int32_t x, int32_t gain)
+{
+    return (int32_t)(((int64_t)x * gain) >> KALMAN_GAIN_SHIFT);
+}
+
+/**
+ * @brief  获取默认配置
+ * @param  config: 配置结构体指针
+ * @retval 无
+ */
+void Kalman_GetDefaultConfig(Kalman_Config_t *config)
+{
+    config->sample_rate = KALMAN_DEFAULT_RATE;
+    config->r = KALMAN_DEFAULT_R;
+    config->q = KALMAN_DEFAULT_Q;
+    config->b[KALMAN_INPUT_CURRENT] = KALMAN_DEFAULT_B;
+    config->b[KALMAN_INPUT_VOLTAGE] = KALMAN_DEFAULT_B;
+    config->gain[0] = 0;
+    config->gain[1] = 0;
+    config->gain[2] = 0;
+}
+
+/**
+ * @brief  卡尔曼滤波器初始化
+ * @param  kf: 滤波器指针
+ * @param  config: 配置结构体指针
+ * @retval 无
+ */
+void Kalman_Init(Kalman_t *kf, const Kalman_Config_t *config)
+{
+    kf->theta = 0;
+    kf->omega = 0;
+    kf->accel = 0;
+    kf->innovation = 0;
+    kf->missed = 0;
+    kf->initialized = 0;
+    
+    // 增益：优先使用预计算值
+    if (config->gain[0] != 0 || config->gain[1] != 0 || config->gain[2] != 0) {
+        kf->gain[0] = config->gain[0];
+        kf->gain[1] = config->gain[1];
+        kf->gain[2] = config->gain[2];
+    } else {
+        Kalman_ComputeSteadyGains(config, kf->gain);
+    }
+    
+    // 换算系数：rev/s^2 → 角度单位/采样周期^2，角度单位/采样周期 → RPM
+    kf->sample_rate = config->sample_rate;
+    Kalman_SetInputGain(kf, KALMAN_INPUT_CURRENT, config->b[KALMAN_INPUT_CURRENT]);
+    Kalman_SetInputGain(kf, KALMAN_INPUT_VOLTAGE, config->b[KALMAN_INPUT_VOLTAGE]);
+    kf->rpm_scale = config->sample_rate * 60.0f / 4294967296.0f;
+}
+
+/**
+ * @brief  计算稳态增益（迭代离散 Riccati 方程，浮点，仅初始化时使用）
+ * @note   状态以 计数、计数/周期、计数/周期^2 为单位，增益无量纲，
+ *         与内部定点单位的缩放无关
+ *         F = [1 1 1/2; 0 1 1; 0 0 1]，H = [1 0 0]，
+ *         过程噪声按每周期加速度阶跃 G = [1/6 1/2 1]' 施加
+ * @param  config: 配置结构体指针
+ * @param  gain: 增益输出（Q30，3个）
+ * @retval 无
+ */
+void Kalman_ComputeSteadyGains(const Kalman_Config_t *config, int32_t gain[3])
+{
+    float p[3][3] = {{0}};
+    float fp[3][3];
+    float k[3] = {0};
+    float g[3] = {1.0f / 6.0f, 0.5f, 1.0f};
+    float r2 = config->r * config->r;
+    float q = config->q * 4096.0f / (config->sample_rate * config->sample_rate);
+    float q2 = q * q;
+    int i, j, n;
+    
+    // 初始协方差：角度取测量噪声，速度和加速度未知
+    p[0][0] = r2;
+    p[1][1] = 1.0e4f;
+    p[2][2] = 1.0e2f;
+    
+    for (n = 0; n < KALMAN_RICCATI_ITER; n++) {
+        // 预测：P = F P F' + Q
+        for (j = 0; j < 3; j++) {
+            fp[0][j] = p[0][j] + p[1][j] + 0.5f * p[2][j];
+            fp[1][j] = p[1][j] + p[2][j];
+            fp[2][j] = p[2][j];
+        }
+        for (i = 0; i < 3; i++) {
+            p[i][0] = fp[i][0] + fp[i][1] + 0.5f * fp[i][2] + g[i] * g[0] * q2;
+            p[i][1] = fp[i][1] + fp[i][2] + g[i] * g[1] * q2;
+            p[i][2] = fp[i][2] + g[i] * g[2] * q2;
+        }
+        
+        // 校正：K = P H' / (H P H' + R)，P = (I - K H) P
+        float s = p[0][0] + r2;
+        for (i = 0; i < 3; i++) {
+            k[i] = p[i][0] / s;
+        }
+        for (i = 0; i < 3; i++) {
+            for (j = 0; j < 3; j++) {
+                fp[i][j] = p[i][j] - k[i] * p[0][j];
+            }
+        }
+        for (i = 0; i < 3; i++) {
+            for (j = 0; j < 3; j++) {
+                p[i][j] = fp[i][j];
+            }
+        }
+    }
+    
+    for (i = 0; i < 3; i++) {
+        gain[i] = (int32_t)(k[i] * (float)(1UL << KALMAN_GAIN_SHIFT));
+    }
+}
+
+/**
+ * @brief  修改采样频率
+ * @note   速度按 1/周期、加速度按 1/周期^2 换算到新的内部单位
+ * @param  kf: 滤波器指针
+ * @param  sample_rate: 新采样频率（Hz）
+ * @param  gain: 新采样频率下的稳态增益（Q30，3个），0 = 保留原增益
+ * @retval 无
+ */
+void Kalman_SetSampleRate(Kalman_t *kf, float sample_rate, const int32_t gain[3])
+{
+    float ratio = kf->sample_rate / sample_rate;    // 新周期 / 旧周期
+    float ratio2 = ratio * ratio;
+    uint8_t i;
+    
+    kf->omega = (int32_t)((float)kf->omega * ratio);
+    kf->accel = (int32_t)((float)kf->accel * ratio2);
+    for (i = 0; i < KALMAN_INPUT_NUM; i++) {
+        kf->b_scale[i] *= ratio2;
+    }
+    kf->rpm_scale = sample_rate * 60.0f / 4294967296.0f;
+    kf->sample_rate = sample_rate;
+    
+    if (gain) {
+        kf->gain[0] = gain[0];
+        kf->gain[1] = gain[1];
+        kf->gain[2] = gain[2];
+    }
+}
+
+/**
+ * @brief  设置模型输入增益
+ * @param  kf: 滤波器指针
+ * @param  input: 输入单位（KALMAN_INPUT_CURRENT / KALMAN_INPUT_VOLTAGE）
+ * @param  b: 转矩指令到角加速度的增益（rev/s^2 每A / 每V）
+ * @retval 无
+ */
+void Kalman_SetInputGain(Kalman_t *kf, uint8_t input, float b)
+{
+    float dt = 1.0f / kf->sample_rate;
+    
+    if (input >= KALMAN_INPUT_NUM) {
+        return;
+    }
+    kf->b_scale[input] = b * dt * dt * 4294967296.0f;
+}
+
+/**
+ * @brief  预测一步（每个采样周期调用一次）
+ * @note   theta += omega + a/2，omega += a，其中 a = 扰动加速度 + b*u，b 按输入单位选取
+ * @param  kf: 滤波器指针
+ * @param  u: 转矩指令
+ * @param  input: u 的单位（KALMAN_INPUT_CURRENT: iq 参考, KALMAN_INPUT_VOLTAGE: 电压参考）
+ * @retval 无
+ */
+void Kalman_Predict(Kalman_t *kf, float u, uint8_t input)
+{
+    int32_t a = kf->accel;
+    
+    if (input < KALMAN_INPUT_NUM && kf->b_scale[input] != 0.0f) {
+        a += (int32_t)(u * kf->b_scale[input]);
+    }
+    
+    kf->theta += (uint32_t)(kf->omega + (a >> 1));
+    kf->omega += a;
+    
+    if (kf->missed < 0xFFFF) {
+        kf->missed++;
+    }
+}
+
+/**
+ * @brief  用角度测量值校正（测量失败时不调用，仅预测）
+ * @note   新息按32位有符号数计算，自动处理 0/4095 跳变
+ * @param  kf: 滤波器指针
+ * @param  angle: 测量角度（0-4095）
+ * @retval 无
+ */
+void Kalman_Update(Kalman_t *kf, uint16_t angle)
+{
+    uint32_t z = (uint32_t)(angle & 0x0FFF) << KALMAN_ANGLE_SHIFT;
+    int32_t e;
+    
+    kf->missed = 0;
+    
+    // 第一个测量值直接作为初值
+    if (!kf->initialized) {
+        kf->theta = z;
+        kf->omega = 0;
+        kf->accel = 0;
+        kf->initialized = 1;
+        return;
+    }
+    
+    e = (int32_t)(z - kf->theta);
+    kf->innovation = e;
+    
+    kf->theta += (uint32_t)Kalman_MulGain(e, kf->gain[0]);
+    kf->omega += Kalman_MulGain(e, kf->gain[1]);
+    kf->accel += Kalman_MulGain(e, kf->gain[2]);
+}
+
+/**
+ * @brief  获取角度估计
+ * @param  kf: 滤波器指针
+ * @retval 角度（0-4095）
+ */
+uint16_t Kalman_GetAngle(const Kalman_t *kf)
+{
+    return (uint16_t)((kf->theta + (1UL << (KALMAN_ANGLE_SHIFT - 1))) >> KALMAN_ANGLE_SHIFT) & 0x0FFF;
+}
+
+/**
+ * @brief  获取两次采样之间的预测角度
+ * @param  kf: 滤波器指针
+ * @param  frac_q16: 距上次预测的时间（采样周期的比例，Q16，0-65535）
+ * @retval 角度（0-4095）
+ */
+uint16_t Kalman_GetAngleAt(const Kalman_t *kf, uint32_t frac_q16)
+{
+    uint32_t theta = kf->theta + (uint32_t)(((int64_t)kf->omega * frac_q16) >> 16);
+    
+    return (uint16_t)((theta + (1UL << (KALMAN_ANGLE_SHIFT - 1))) >> KALMAN_ANGLE_SHIFT) & 0x0FFF;
+}
+
+/**
+ * @brief  获取速度估计
+ * @param  kf: 滤波器指针
+ * @retval 转速（RPM）
+ */
+float Kalman_GetSpeedRPM(const Kalman_t *kf)
+{
+    return (float)kf->omega * kf->rpm_scale;
+}
@@ -0,0 +1,143 @@
+#ifndef __KALMAN_H
+#define __KALMAN_H
+
+#include <stdint.h>
+
+// ==================== 配置参数 ====================
+// 状态量定点格式：
+//   角度 theta：uint32，2^32 = 1圈，自然回绕
+//   速度 omega：int32，单位为 角度单位/采样周期
+//   加速度 accel：int32，单位为 角度单位/采样周期^2（扰动加速度，含反电势、负载等）
+#define KALMAN_ANGLE_SHIFT      20      // AS5600 计数（12位）到内部角度单位的移位
+#define KALMAN_GAIN_SHIFT       30      // 卡尔曼增益定点格式 Q30
+#define KALMAN_RICCATI_ITER     500     // 稳态增益迭代次数
+
+// 模型输入（转矩指令）单位，各用一个增益：
+//   电流：b = Kt / (2π·J)，Kt = 1.5·p·λ
+//   电压：b = Kt / (2π·J·Rs)，按稳态 iq ≈ V / Rs（反电势阻尼由扰动加速度状态吸收）
+#define KALMAN_INPUT_CURRENT    0       // 输入为 iq 参考（A）
+#define KALMAN_INPUT_VOLTAGE    1       // 输入为电压参考（V）
+#define KALMAN_INPUT_NUM        2
+
+// 默认参数（无模型辨识结果时使用）
+#define KALMAN_DEFAULT_RATE     1000.0f // 采样频率（Hz）
+#define KALMAN_DEFAULT_R        1.0f    // 角度测量噪声标准差（计数）
+#define KALMAN_DEFAULT_Q        5.0f    // 加速度变化噪声标准差（rev/s^2 每采样周期）
+#define KALMAN_DEFAULT_B        0.0f    // 转矩指令到角加速度的增益（rev/s^2 每单位输入，0 = 无模型输入）
+
+// ==================== 数据结构 ====================
+/**
+ * @brief 卡尔曼滤波器配置结构体
+ * @note  gain[] 全为0时，初始化根据噪声参数迭代 Riccati 方程计算稳态增益；
+ *        否则直接使用给定的预计算增益（Q30），省去启动时的浮点迭代
+ */
+typedef struct {
+    float sample_rate;          // 采样频率（Hz）
+    float r;                    // 角度测量噪声标准差（计数）
+    float q;                    // 加速度变化噪声标准差（rev/s^2 每采样周期）
+    float b[KALMAN_INPUT_NUM];  // 转矩指令到角加速度的增益（rev/s^2 每A / 每V）
+    int32_t gain[3];            // 预计算稳态增益（Q30，可选）
+} Kalman_Config_t;
+
+/**
+ * @brief 卡尔曼滤波器结构体（角度/速度/扰动加速度三状态）
+ */
+typedef struct {
+    uint32_t theta;             // 角度估计（2^32 = 1圈）
+    int32_t omega;              // 速度估计（角度单位/采样周期）
+    int32_t accel;              // 扰动加速度估计（角度单位/采样周期^2）
+    int32_t gain[3];            // 稳态增益（Q30）
+    float sample_rate;          // 采样频率（Hz）
+    float b_scale[KALMAN_INPUT_NUM];  // 输入换算系数（角度单位/采样周期^2 每A / 每V）
+    float rpm_scale;            // 速度换算系数（RPM 每速度单位）
+    int32_t innovation;         // 最近一次新息（角度单位）
+    uint16_t missed;            // 连续丢失的测量次数
+    uint8_t initialized;        // 是否已用测量值初始化
+} Kalman_t;
+
+// ==================== 函数声明 ====================
+/**
+ * @brief  获取默认配置
+ * @param  config: 配置结构体指针
+ * @retval 无
+ */
+void Kalman_GetDefaultConfig(Kalman_Config_t *config);
+
+/**
+ * @brief  卡尔曼滤波器初始化
+ * @param  kf: 滤波器指针
+ * @param  config: 配置结构体指针
+ * @retval 无
+ */
+void Kalman_Init(Kalman_t *kf, const Kalman_Config_t *config);
+
+/**
+ * @brief  计算稳态增益（迭代离散 Riccati 方程，浮点，仅初始化时使用）
+ * @param  config: 配置结构体指针
+ * @param  gain: 增益输出（Q30，3个）
+ * @retval 无
+ */
+void Kalman_ComputeSteadyGains(const Kalman_Config_t *config, int32_t gain[3]);
+
+/**
+ * @brief  修改采样频率
+ * @note   速度、加速度状态和输入换算系数按新采样周期换算，估计值不跳变；
+ *         稳态增益随采样频率变化，迭代计算耗时长，不宜在中断中进行：
+ *         可先以 gain = 0 保留原增益换算状态，再在主循环中用 Kalman_ComputeSteadyGains 计算后以相同频率再次调用
+ * @param  kf: 滤波器指针
+ * @param  sample_rate: 新采样频率（Hz）
+ * @param  gain: 新采样频率下的稳态增益（Q30，3个），0 = 保留原增益
+ * @retval 无
+ */
+void Kalman_SetSampleRate(Kalman_t *kf, float sample_rate, const int32_t gain[3]);
+
+/**
+ * @brief  设置模型输入增益
+ * @note   电机参数辨识或修改后调用；与 Kalman_Predict 不在同一中断时调用者须屏蔽该中断
+ * @param  kf: 滤波器指针
+ * @param  input: 输入单位（KALMAN_INPUT_CURRENT / KALMAN_INPUT_VOLTAGE）
+ * @param  b: 转矩指令到角加速度的增益（rev/s^2 每A / 每V）
+ * @retval 无
+ */
+void Kalman_SetInputGain(Kalman_t *kf, uint8_t input, float b);
+
+/**
+ * @brief  预测一步（每个采样周期调用一次）
+ * @param  kf: 滤波器指针
+ * @param  u: 转矩指令
+ * @param  input: u 的单位（KALMAN_INPUT_CURRENT: iq 参考, KALMAN_INPUT_VOLTAGE: 电压参考）
+ * @retval 无
+ */
+void Kalman_Predict(Kalman_t *kf, float u, uint8_t input);
+
+/**
+ * @brief  用角度测量值校正（测量失败时不调用，仅预测）
+ * @param  kf: 滤波器指针
+ * @param  angle: 测量角度（0-4095）
+ * @retval 无
+ */
+void Kalman_Update(Kalman_t *kf, uint16_t angle);
+
+/**
+ * @brief  获取角度估计
+ * @param  kf: 滤波器指针
+ * @retval 角度（0-4095）
+ */
+uint16_t Kalman_GetAngle(const Kalman_t *kf);
+
+/**
+ * @brief  获取两次采样之间的预测角度
+ * @param  kf: 滤波器指针
+ * @param  frac_q16: 距上次预测的时间（采样周期的比例，Q16，0-65535）
+ * @retval 角度（0-4095）
+ */
+uint16_t Kalman_GetAngleAt(const Kalman_t *kf, uint32_t frac_q16);
+
+/**
+ * @brief  获取速度估计
+ * @param  kf: 滤波器指针
+ * @retval 转速（RPM）
+ */
+float Kalman_GetSpeedRPM(const Kalman_t *kf);
+
+#endif
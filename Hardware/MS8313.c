@@ -3,10 +3,43 @@
 
 // ==================== 静态变量 ====================
 static uint8_t output_enabled = 0;  // PWM输出状态
+static uint16_t control_count = 0;  // 控制周期分频计数
+static volatile uint8_t break_fault = 0;  // 硬件刹车故障锁存
+static volatile uint16_t pending_period = 0;  // 待生效的周期值（0 = 无）
+static volatile uint8_t asym_enabled = 0;     // 非对称图样输出中
+static MS8313_AsymPattern_t asym_buf[2];      // 图样双缓冲：当前PWM周期 / 下一个PWM周期
+static volatile uint8_t asym_index = 0;       // 当前PWM周期的图样
+static volatile uint8_t asym_new = 0;         // 另一组已写入新图样
+#if !MS8313_USE_TIM1
+static volatile uint16_t sym_ccr[2][3];       // 对称比较值双缓冲（上溢中断写入）
+static volatile uint8_t sym_index = 0;        // 最新完整的一组
+static volatile uint8_t sym_pending = 0;      // 有待写入的比较值
+#endif
+// 六步换相表：{高边相, 低边相}，第 k 步电压矢量方向为 30° + 60° * k
+static const uint8_t six_step_table[6][2] = {
+    {MS8313_PHASE_A, MS8313_PHASE_C},   // 30°
+    {MS8313_PHASE_B, MS8313_PHASE_C},   // 90°
+    {MS8313_PHASE_B, MS8313_PHASE_A},   // 150°
+    {MS8313_PHASE_C, MS8313_PHASE_A},   // 210°
+    {MS8313_PHASE_C, MS8313_PHASE_B},   // 270°
+    {MS8313_PHASE_A, MS8313_PHASE_B},   // 330°
+};
+static MS8313_Timing_t timing = {
+    MS8313_PWM_FREQ, MS8313_PWM_PERIOD, MS8313_CONTROL_DIVIDER,
+    (float)MS8313_CONTROL_FREQ, 1.0f / MS8313_PWM_PERIOD, 0
+};
 
 // ==================== 私有函数声明 ====================
 static void MS8313_GPIO_Init(void);
+static void MS8313_ApplyTiming(void);
+#if !MS8313_USE_TIM1
+static void MS8313_LatchDuty(uint16_t ccr_a, uint16_t ccr_b, uint16_t ccr_c);
+#endif
+#if MS8313_USE_TIM1
+static void MS8313_TIM1_Init(void);
+#else
 static void MS8313_TIM2_Init(void);
+#endif
 
 // ==================== 私有函数实现 ====================
 
@@ -21,6 +54,29 @@ static void MS8313_GPIO_Init(void)
     // 使能GPIO时钟
     RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA, ENABLE);
     
+#if MS8313_USE_TIM1
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB, ENABLE);
+    
+    // 配置TIM1 PWM输出引脚（3个半H桥）
+    // PB13: TIM1_CH1N (A相PWM)
+    // PB14: TIM1_CH2N (B相PWM)
+    // PB15: TIM1_CH3N (C相PWM)
+    GPIO_InitStructure.GPIO_Pin = MS8313_PWM_PINS;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;  // 复用推挽输出
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+    GPIO_Init(MS8313_PWM_PORT, &GPIO_InitStructure);
+    
+#if MS8313_TIM1_COMPLEMENTARY
+    // PA8/PA9/PA10: TIM1_CH1/CH2/CH3（互补对的另一路）
+    GPIO_InitStructure.GPIO_Pin = GPIO_Pin_8 | GPIO_Pin_9 | GPIO_Pin_10;
+    GPIO_Init(GPIOA, &GPIO_InitStructure);
+#endif
+    
+    // PB12: TIM1_BKIN，低电平有效，上拉保证悬空时不误触发
+    GPIO_InitStructure.GPIO_Pin = MS8313_BKIN_PIN;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IPU;
+    GPIO_Init(MS8313_BKIN_PORT, &GPIO_InitStructure);
+#else
     // 配置TIM2 PWM输出引脚（3个半H桥）
     // PA0: TIM2_CH1 (A相PWM)
     // PA1: TIM2_CH2 (B相PWM)
@@ -32,6 +88,7 @@ static void MS8313_GPIO_Init(void)
     
     // 注意：TIM2的PWM输出引脚需要特殊配置
     // 对于STM32F103，TIM2的PWM输出引脚配置为复用推挽输出
+#endif
     
     // 配置使能引脚
     // PA3: MS8313使能信号
@@ -44,29 +101,195 @@ static void MS8313_GPIO_Init(void)
     GPIO_ResetBits(MS8313_EN_PORT, MS8313_EN_PIN);
 }
 
+/**
+ * @brief  应用待生效的PWM周期
+ * @note   写入ARR预装载值，并把当前三相比较值按新周期等比例换算，
+ *         两者在同一次下溢更新事件装载，周期边界前后占空比（百分比）不变
+ */
+static void MS8313_ApplyTiming(void)
+{
+    uint16_t old_period = timing.period;
+    uint16_t new_period = pending_period;
+    uint32_t duty_a, duty_b, duty_c;
+    
+    pending_period = 0;
+    if(new_period == 0 || new_period == old_period)
+    {
+        return;
+    }
+    
+    // 图样按旧周期计算，恢复对称输出，等上层按新周期重新设置
+    asym_enabled = 0;
+    
+    // 比较值还原为占空比并换算到新周期
+    duty_a = (MS8313_PWM_A >= old_period) ? 0 : (old_period - MS8313_PWM_A);
+    duty_b = (MS8313_PWM_B >= old_period) ? 0 : (old_period - MS8313_PWM_B);
+    duty_c = (MS8313_PWM_C >= old_period) ? 0 : (old_period - MS8313_PWM_C);
+    duty_a = duty_a * new_period / old_period;
+    duty_b = duty_b * new_period / old_period;
+    duty_c = duty_c * new_period / old_period;
+    
+    MS8313_TIM->CR1 |= TIM_CR1_UDIS;
+    MS8313_TIM->ARR = new_period;
+    MS8313_PWM_A = new_period - duty_a;
+    MS8313_PWM_B = new_period - duty_b;
+    MS8313_PWM_C = new_period - duty_c;
+    MS8313_TIM->CR1 &= (uint16_t)~TIM_CR1_UDIS;
+    
+    // 更新时序配置
+    timing.period = new_period;
+    timing.period_inv = 1.0f / new_period;
+    timing.pwm_freq = MS8313_TIM_CLOCK / 2 / new_period;
+    timing.control_divider = (timing.pwm_freq + MS8313_CONTROL_FREQ / 2) / MS8313_CONTROL_FREQ;
+    if(timing.control_divider == 0)
+    {
+        timing.control_divider = 1;
+    }
+    timing.control_freq = (float)MS8313_TIM_CLOCK / 2.0f / new_period / timing.control_divider;
+    timing.version++;
+    control_count = 0;
+}
+
+#if !MS8313_USE_TIM1
+/**
+ * @brief  登记三相比较值，由上溢中断写入预装载寄存器
+ * @note   TIM2在上溢和下溢都装载预装载值，控制回调和电流环都在下溢一侧运行，
+ *         直接写入会在上溢生效，新占空比跨两个PWM周期各半、波形不对称。
+ *         改为上溢中断写入、下溢装载，整个PWM周期使用同一组比较值（多半个周期延迟）。
+ *         双缓冲：写入方只改另一组再切换索引，上溢中断被抢占时读到的仍是完整的一组。
+ *         定时器停止时没有中断，直接写入
+ * @param  ccr_a: A相比较值
+ * @param  ccr_b: B相比较值
+ * @param  ccr_c: C相比较值
+ */
+static void MS8313_LatchDuty(uint16_t ccr_a, uint16_t ccr_b, uint16_t ccr_c)
+{
+    uint8_t next = sym_index ^ 1;
+    
+    sym_ccr[next][0] = ccr_a;
+    sym_ccr[next][1] = ccr_b;
+    sym_ccr[next][2] = ccr_c;
+    sym_index = next;
+    sym_pending = 1;
+    
+    if(!(MS8313_TIM->CR1 & TIM_CR1_CEN))
+    {
+        MS8313_PWM_A = ccr_a;
+        MS8313_PWM_B = ccr_b;
+        MS8313_PWM_C = ccr_c;
+    }
+}
+#endif
+
+#if MS8313_USE_TIM1
+/**
+ * @brief  TIM1初始化（3个半H桥，带硬件刹车）
+ * @note   时基与TIM2后端一致（中心对齐，36MHz，ARR = 周期），PWM2模式。
+ *         BKIN有效时硬件异步清除MOE，OSSI = 1 使输出被驱动到空闲电平（低），
+ *         整个过程不经过软件；刹车中断只负责拉低使能引脚和锁存故障。
+ *         重复计数器先置0启动，由更新中断在第一次上溢时写入目标值，
+ *         保证更新事件（影子寄存器装载点）落在下溢
+ */
+static void MS8313_TIM1_Init(void)
+{
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+    TIM_OCInitTypeDef TIM_OCInitStructure;
+    TIM_BDTRInitTypeDef TIM_BDTRInitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+    
+    // 使能TIM1时钟
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_TIM1, ENABLE);
+    
+    // 配置时基（中心对齐：PWM频率 = 36MHz / (2 * ARR) = 18kHz）
+    TIM_TimeBaseStructure.TIM_Period = MS8313_PWM_PERIOD;  // 计数峰值
+    TIM_TimeBaseStructure.TIM_Prescaler = 2 - 1;  // 预分频器：72MHz/2 = 36MHz
+    TIM_TimeBaseStructure.TIM_ClockDivision = 0;  // tDTS = 1/72MHz
+    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_CenterAligned1;
+    TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;  // 启动后在上溢中断中写入目标值
+    TIM_TimeBaseInit(TIM1, &TIM_TimeBaseStructure);
+    
+    // 配置PWM输出通道（3个半H桥）
+    // 仅使能CHxN时 OCxN = OCxREF（极性高），不插入死区；
+    // 互补输出时 OCx 与 OCxN 之间由BDTR插入死区
+    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM2;
+#if MS8313_TIM1_COMPLEMENTARY
+    TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Enable;
+#else
+    TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Disable;
+#endif
+    TIM_OCInitStructure.TIM_OutputNState = TIM_OutputNState_Enable;
+    TIM_OCInitStructure.TIM_Pulse = MS8313_PWM_PERIOD;  // 初始占空比为0
+    TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_High;
+    TIM_OCInitStructure.TIM_OCNPolarity = TIM_OCNPolarity_High;
+    TIM_OCInitStructure.TIM_OCIdleState = TIM_OCIdleState_Reset;    // 刹车/MOE=0时输出低
+    TIM_OCInitStructure.TIM_OCNIdleState = TIM_OCNIdleState_Reset;
+    
+    // 配置3个PWM通道
+    TIM_OC1Init(TIM1, &TIM_OCInitStructure);
+    TIM_OC2Init(TIM1, &TIM_OCInitStructure);
+    TIM_OC3Init(TIM1, &TIM_OCInitStructure);
+    
+    // 使能预加载寄存器
+    TIM_OC1PreloadConfig(TIM1, TIM_OCPreload_Enable);
+    TIM_OC2PreloadConfig(TIM1, TIM_OCPreload_Enable);
+    TIM_OC3PreloadConfig(TIM1, TIM_OCPreload_Enable);
+    TIM_ARRPreloadConfig(TIM1, ENABLE);
+    
+    // 刹车与死区：BKIN低有效，自动输出禁止（需软件重新置位MOE），
+    // 锁定级别1保护死区/刹车配置不被运行时误改
+    TIM_BDTRInitStructure.TIM_OSSRState = TIM_OSSRState_Enable;
+    TIM_BDTRInitStructure.TIM_OSSIState = TIM_OSSIState_Enable;
+    TIM_BDTRInitStructure.TIM_LOCKLevel = TIM_LOCKLevel_1;
+    TIM_BDTRInitStructure.TIM_DeadTime = MS8313_DEADTIME_DTG;
+    TIM_BDTRInitStructure.TIM_Break = TIM_Break_Enable;
+    TIM_BDTRInitStructure.TIM_BreakPolarity = TIM_BreakPolarity_Low;
+    TIM_BDTRInitStructure.TIM_AutomaticOutput = TIM_AutomaticOutput_Disable;
+    TIM_BDTRConfig(TIM1, &TIM_BDTRInitStructure);
+    
+    // 更新中断与刹车中断
+    TIM_ClearITPendingBit(TIM1, TIM_IT_Update | TIM_IT_Break);
+    TIM_ITConfig(TIM1, TIM_IT_Update | TIM_IT_Break, ENABLE);
+    
+    NVIC_InitStructure.NVIC_IRQChannel = MS8313_UPDATE_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;  // 低于过流/电流环（ADC中断），高于I2C和串口
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    
+    NVIC_InitStructure.NVIC_IRQChannel = TIM1_BRK_IRQn;  // 输出已由硬件关断，中断仅做记录
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
+    NVIC_Init(&NVIC_InitStructure);
+    
+    // 启动定时器（MOE在 MS8313_EnableOutput 中置位）
+    TIM_Cmd(TIM1, ENABLE);
+}
+#else
 /**
  * @brief  TIM2初始化（3个半H桥）
- * @note   配置通用定时器输出3路PWM
+ * @note   配置通用定时器中心对齐模式输出3路PWM，
+ *         PWM2模式：CNT >= CCR 时输出高，高电平脉冲居中于计数峰值，
+ *         因此写入比较值为 周期 - 占空比
  */
 static void MS8313_TIM2_Init(void)
 {
     TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
     TIM_OCInitTypeDef TIM_OCInitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
     
     // 使能TIM2时钟
     RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);
     
-    // 配置时基
-    TIM_TimeBaseStructure.TIM_Period = MS8313_PWM_PERIOD - 1;  // PWM周期
-    TIM_TimeBaseStructure.TIM_Prescaler = 4 - 1;  // 预分频器：72MHz/4 = 18MHz
+    // 配置时基（中心对齐：PWM频率 = 36MHz / (2 * ARR) = 18kHz）
+    TIM_TimeBaseStructure.TIM_Period = MS8313_PWM_PERIOD;  // 计数峰值
+    TIM_TimeBaseStructure.TIM_Prescaler = 2 - 1;  // 预分频器：72MHz/2 = 36MHz
     TIM_TimeBaseStructure.TIM_ClockDivision = 0;
-    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_CenterAligned1;
     TIM_TimeBaseInit(TIM2, &TIM_TimeBaseStructure);
     
     // 配置PWM输出通道（3个半H桥）
-    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM1;
+    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM2;
     TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Enable;
-    TIM_OCInitStructure.TIM_Pulse = 0;  // 初始占空比为0
+    TIM_OCInitStructure.TIM_Pulse = MS8313_PWM_PERIOD;  // 初始占空比为0
     TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_High;
     
     // 配置3个PWM通道
@@ -78,17 +301,29 @@ static void MS8313_TIM2_Init(void)
     TIM_OC1PreloadConfig(TIM2, TIM_OCPreload_Enable);
     TIM_OC2PreloadConfig(TIM2, TIM_OCPreload_Enable);
     TIM_OC3PreloadConfig(TIM2, TIM_OCPreload_Enable);
+    TIM_ARRPreloadConfig(TIM2, ENABLE);
+    
+    // 更新中断（上溢和下溢都会产生，中断内按计数方向区分）
+    TIM_ClearITPendingBit(TIM2, TIM_IT_Update);
+    TIM_ITConfig(TIM2, TIM_IT_Update, ENABLE);
+    
+    NVIC_InitStructure.NVIC_IRQChannel = MS8313_UPDATE_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;  // 低于过流/电流环（ADC中断），高于I2C和串口
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
     
     // 启动定时器
     TIM_Cmd(TIM2, ENABLE);
 }
+#endif
 
 
 // ==================== 公共函数实现 ====================
 
 /**
  * @brief  MS8313 PWM初始化
- * @note   配置TIM1输出3路PWM（3个半H桥）
+ * @note   按 MS8313_USE_TIM1 配置TIM2或TIM1输出3路PWM（3个半H桥）
  * @retval 无
  */
 void MS8313_Init(void)
@@ -97,7 +332,11 @@ void MS8313_Init(void)
     MS8313_GPIO_Init();
     
     // 2. 定时器初始化
+#if MS8313_USE_TIM1
+    MS8313_TIM1_Init();
+#else
     MS8313_TIM2_Init();
+#endif
     
     // 3. 初始状态：禁用PWM输出
     MS8313_DisableOutput();
@@ -109,48 +348,160 @@ void MS8313_Init(void)
 /**
  * @brief  设置PWM占空比
  * @param  phase: 相别（0=A, 1=B, 2=C）
- * @param  duty: 占空比（0-1000）
+ * @param  duty: 占空比（0-周期值）
  * @retval 无
  */
 void MS8313_SetDutyCycle(uint8_t phase, uint16_t duty)
 {
+    uint16_t period = timing.period;
+#if !MS8313_USE_TIM1
+    uint16_t ccr[3];
+#endif
+    
     // 限制占空比范围
-    if(duty > MS8313_PWM_PERIOD)
+    if(duty > period)
     {
-        duty = MS8313_PWM_PERIOD;
+        duty = period;
     }
     
+#if !MS8313_USE_TIM1
+    // 在最新一组比较值上修改一相，经上溢中断写入
+    if(phase > MS8313_PHASE_C)
+    {
+        return;
+    }
+    ccr[0] = sym_ccr[sym_index][0];
+    ccr[1] = sym_ccr[sym_index][1];
+    ccr[2] = sym_ccr[sym_index][2];
+    ccr[phase] = period - duty;
+    asym_enabled = 0;
+    MS8313_LatchDuty(ccr[0], ccr[1], ccr[2]);
+#else
+    // PWM2模式：比较值 = 周期 - 占空比
     switch(phase)
     {
         case MS8313_PHASE_A:  // A相
-            MS8313_PWM_A = duty;
+            MS8313_PWM_A = period - duty;
             break;
             
         case MS8313_PHASE_B:  // B相
-            MS8313_PWM_B = duty;
+            MS8313_PWM_B = period - duty;
             break;
             
         case MS8313_PHASE_C:  // C相
-            MS8313_PWM_C = duty;
+            MS8313_PWM_C = period - duty;
             break;
             
         default:
             break;
     }
+#endif
 }
 
 /**
- * @brief  设置三相PWM占空比
- * @param  duty_a: A相占空比（0-1000）
- * @param  duty_b: B相占空比（0-1000）
- * @param  duty_c: C相占空比（0-1000）
+ * @brief  设置三相PWM占空比（原子更新）
+ * @note   TIM1写入期间置位 UDIS，三路比较值在同一次（下溢）更新事件生效；
+ *         在控制回调中调用时，下一次更新事件在半个PWM周期后，不会被屏蔽。
+ *         TIM2由上溢中断统一写入，见 MS8313_LatchDuty
+ * @param  duty_a: A相占空比（0-周期值）
+ * @param  duty_b: B相占空比（0-周期值）
+ * @param  duty_c: C相占空比（0-周期值）
  * @retval 无
  */
 void MS8313_SetThreePhaseDuty(uint16_t duty_a, uint16_t duty_b, uint16_t duty_c)
 {
-    MS8313_SetDutyCycle(MS8313_PHASE_A, duty_a);
-    MS8313_SetDutyCycle(MS8313_PHASE_B, duty_b);
-    MS8313_SetDutyCycle(MS8313_PHASE_C, duty_c);
+    uint16_t ccr_a, ccr_b, ccr_c;
+    uint16_t period = timing.period;
+    
+    // 先统一限幅并换算比较值，缩短下面禁止更新的窗口
+    ccr_a = (duty_a > period) ? 0 : (period - duty_a);
+    ccr_b = (duty_b > period) ? 0 : (period - duty_b);
+    ccr_c = (duty_c > period) ? 0 : (period - duty_c);
+    
+#if MS8313_USE_TIM1
+    asym_enabled = 0;
+    
+    // 禁止更新事件：三路预装载值要么全部在下一次更新生效，要么全部推迟一次，
+    // 不会出现一个周期内新旧占空比混用
+    MS8313_TIM->CR1 |= TIM_CR1_UDIS;
+    MS8313_PWM_A = ccr_a;
+    MS8313_PWM_B = ccr_b;
+    MS8313_PWM_C = ccr_c;
+    MS8313_TIM->CR1 &= (uint16_t)~TIM_CR1_UDIS;
+#else
+    // 先登记比较值再退出非对称图样，上溢中断不会写入一组旧值
+    MS8313_LatchDuty(ccr_a, ccr_b, ccr_c);
+    asym_enabled = 0;
+#endif
+}
+
+/**
+ * @brief  设置非对称PWM图样（两个半周期分别装载）
+ * @note   只登记到待生效图样，由更新中断在周期边界写入比较寄存器
+ * @param  up: 上半周期三相占空比（0-周期值）
+ * @param  down: 下半周期三相占空比（0-周期值）
+ * @param  trigger1: 第一个采样触发点
+ * @param  trigger2: 第二个采样触发点
+ * @param  tag: 附带信息
+ * @retval 无
+ */
+void MS8313_SetAsymmetricDuty(const uint16_t up[3], const uint16_t down[3],
+                              uint16_t trigger1, uint16_t trigger2, uint8_t tag)
+{
+    MS8313_AsymPattern_t *next = &asym_buf[asym_index ^ 1];
+    uint16_t period = timing.period;
+    uint8_t i;
+    
+    for(i = 0; i < 3; i++)
+    {
+        next->ccr_up[i] = (up[i] > period) ? 0 : (period - up[i]);
+        next->ccr_down[i] = (down[i] > period) ? 0 : (period - down[i]);
+    }
+    next->trigger[0] = trigger1;
+    next->trigger[1] = trigger2;
+    next->tag = tag;
+    asym_new = 1;
+    asym_enabled = 1;
+}
+
+/**
+ * @brief  获取当前PWM周期正在生效的非对称图样
+ * @retval 图样指针（只读），对称输出时返回NULL
+ */
+const MS8313_AsymPattern_t* MS8313_GetActivePattern(void)
+{
+    return asym_enabled ? &asym_buf[asym_index] : 0;
+}
+
+/**
+ * @brief  六步换相输出
+ * @note   MS8313三相共用一个使能引脚，不能单独关断一相，
+ *         悬空相保持在周期中点；导通两相以中点对称 ±duty/2，线电压 = duty
+ * @param  step: 换相步（0-5，电压矢量方向 30° + 60° * step）
+ * @param  duty: 线电压占空比（0-周期值）
+ * @retval 无
+ */
+void MS8313_SetSixStep(uint8_t step, uint16_t duty)
+{
+    uint16_t duty_phase[3];
+    uint16_t half = timing.period / 2;
+    
+    if(step >= 6)
+    {
+        return;
+    }
+    if(duty > 2 * half)
+    {
+        duty = 2 * half;
+    }
+    
+    duty_phase[0] = half;
+    duty_phase[1] = half;
+    duty_phase[2] = half;
+    duty_phase[six_step_table[step][0]] = half + duty / 2;
+    duty_phase[six_step_table[step][1]] = half - duty / 2;
+    
+    MS8313_SetThreePhaseDuty(duty_phase[0], duty_phase[1], duty_phase[2]);
 }
 
 /**
@@ -159,8 +510,17 @@ void MS8313_SetThreePhaseDuty(uint16_t duty_a, uint16_t duty_b, uint16_t duty_c)
  */
 void MS8313_EnableOutput(void)
 {
+    // 刹车故障未清除时不允许重新使能
+    if(break_fault)
+    {
+        return;
+    }
+    
     // 使能PWM输出
-    TIM_Cmd(TIM2, ENABLE);
+    TIM_Cmd(MS8313_TIM, ENABLE);
+#if MS8313_USE_TIM1
+    TIM_CtrlPWMOutputs(TIM1, ENABLE);  // 置位MOE
+#endif
     
     // 使能MS8313芯片
     GPIO_SetBits(MS8313_EN_PORT, MS8313_EN_PIN);
@@ -170,12 +530,16 @@ void MS8313_EnableOutput(void)
 
 /**
  * @brief  禁用PWM输出
+ * @note   TIM1后端先清除MOE，输出回到空闲电平（低）后再停止计数
  * @retval 无
  */
 void MS8313_DisableOutput(void)
 {
     // 禁用PWM输出
-    TIM_Cmd(TIM2, DISABLE);
+#if MS8313_USE_TIM1
+    TIM_CtrlPWMOutputs(TIM1, DISABLE);
+#endif
+    TIM_Cmd(MS8313_TIM, DISABLE);
     
     // 禁用MS8313芯片
     GPIO_ResetBits(MS8313_EN_PORT, MS8313_EN_PIN);
@@ -183,26 +547,127 @@ void MS8313_DisableOutput(void)
     output_enabled = 0;
 }
 
+/**
+ * @brief  关闭驱动桥、保持定时器运行（电机自由滑行）
+ * @note   EN拉低后三相输出高阻，绕组无电流；PWM计数、控制周期回调和电流采样照常进行，
+ *         用于滑行实验中继续测速。重新输出调用 MS8313_EnableOutput
+ * @retval 无
+ */
+void MS8313_Coast(void)
+{
+#if MS8313_USE_TIM1
+    TIM_CtrlPWMOutputs(TIM1, DISABLE);
+#endif
+    GPIO_ResetBits(MS8313_EN_PORT, MS8313_EN_PIN);
+    
+    output_enabled = 0;
+}
+
 /**
  * @brief  设置PWM频率
+ * @note   频率取整到控制频率的整数倍，控制周期与PWM周期保持同相位。
+ *         定时器运行时由更新中断在周期边界应用：TIM2上下溢都产生更新事件，
+ *         在上溢中断写入，下一次（下溢）更新事件装载；TIM1由重复计数器只在下溢更新，
+ *         在下溢中断写入，下一次下溢装载。定时器停止时立即生效
  * @param  freq: PWM频率（Hz）
  * @retval 无
  */
 void MS8313_SetFrequency(uint32_t freq)
 {
+    uint32_t divider;
     uint32_t period;
     
+    // 控制回调分频（四舍五入，至少为1）
+    divider = (freq + MS8313_CONTROL_FREQ / 2) / MS8313_CONTROL_FREQ;
+    if(divider == 0) divider = 1;
+    
     // 计算PWM周期值
-    // 定时器频率 = 72MHz / 4 = 18MHz
-    // 周期值 = 18MHz / PWM频率
-    period = 18000000 / freq;
+    // 定时器频率 = 72MHz / 2 = 36MHz，中心对齐一个周期计数 2 * ARR
+    // 周期值 = 18MHz / (分频 * 控制频率)
+    period = (MS8313_TIM_CLOCK / 2 + divider * MS8313_CONTROL_FREQ / 2) / (divider * MS8313_CONTROL_FREQ);
     
     // 限制周期值范围
-    if(period < 100) period = 100;
+    if(period < MS8313_PWM_PERIOD_MIN) period = MS8313_PWM_PERIOD_MIN;
     if(period > 65535) period = 65535;
     
-    // 更新TIM2周期
-    TIM2->ARR = period - 1;
+    pending_period = (uint16_t)period;
+    
+    // 定时器停止时没有更新中断，直接应用；关闭ARR预装载使新周期立即有效
+    if(!(MS8313_TIM->CR1 & TIM_CR1_CEN))
+    {
+        MS8313_ApplyTiming();
+        MS8313_TIM->CR1 &= (uint16_t)~TIM_CR1_ARPE;
+        MS8313_TIM->ARR = timing.period;
+        MS8313_TIM->CR1 |= TIM_CR1_ARPE;
+    }
+}
+
+/**
+ * @brief  配置ADC注入组触发
+ * @note   通道4作内部比较（不输出到引脚，PA3仍为使能引脚）：PWM1模式，
+ *         CNT < CCR4 时 OC4REF 有效，向下计数经过 CCR4 时产生上升沿，
+ *         经 TRGO 在谷点前 lead 个计数触发采样；与周期值无关，改频率不需重配
+ * @param  lead: 触发提前量（定时器计数，36MHz）
+ * @retval 无
+ */
+void MS8313_SetADCTrigger(uint16_t lead)
+{
+    TIM_OCInitTypeDef TIM_OCInitStructure;
+    
+    if(lead == 0)
+    {
+        lead = 1;  // CCR4 = 0 时OC4REF恒无效，不产生触发
+    }
+    
+    TIM_OCStructInit(&TIM_OCInitStructure);
+    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM1;
+    TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Disable;  // 仅内部使用
+    TIM_OCInitStructure.TIM_Pulse = lead;
+    TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_High;
+    TIM_OC4Init(MS8313_TIM, &TIM_OCInitStructure);
+    TIM_OC4PreloadConfig(MS8313_TIM, TIM_OCPreload_Enable);
+    
+    TIM_SelectOutputTrigger(MS8313_TIM, TIM_TRGOSource_OC4Ref);
+}
+
+/**
+ * @brief  配置单电阻采样触发
+ * @note   PWM2模式：向上计数经过 CCR4 时 OC4REF 上升，向下计数经过时下降；
+ *         关闭预装载后在上半周期内改写 CCR4 为更大的值，OC4REF 先变无效再在新位置上升
+ * @retval 无
+ */
+void MS8313_SetSingleShuntTrigger(void)
+{
+    TIM_OCInitTypeDef TIM_OCInitStructure;
+    
+    TIM_OCStructInit(&TIM_OCInitStructure);
+    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM2;
+    TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Disable;  // 仅内部使用
+    TIM_OCInitStructure.TIM_Pulse = timing.period / 2;
+    TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_High;
+    TIM_OC4Init(MS8313_TIM, &TIM_OCInitStructure);
+    TIM_OC4PreloadConfig(MS8313_TIM, TIM_OCPreload_Disable);
+    
+    TIM_SelectOutputTrigger(MS8313_TIM, TIM_TRGOSource_OC4Ref);
+}
+
+/**
+ * @brief  改写采样触发点（立即生效）
+ * @param  count: 触发点（向上计数的CNT值）
+ * @retval 无
+ */
+void MS8313_SetADCTriggerPoint(uint16_t count)
+{
+    MS8313_TIM->CCR4 = count;
+}
+
+/**
+ * @brief  获取当前PWM时序配置
+ * @retval 时序配置指针（只读）
+ */
+const MS8313_Timing_t* MS8313_GetTiming(void)
+{
+    return &timing;
 }
 
 /**
@@ -225,6 +690,149 @@ uint8_t MS8313_GetOutputStatus(void)
     return output_enabled;
 }
 
+/**
+ * @brief  PWM定时器更新中断处理
+ * @note   中心对齐模式下上溢和下溢都产生更新事件，
+ *         下溢后计数器转为向上计数（DIR = 0），据此只在下溢时触发控制。
+ *         TIM1后端由重复计数器滤掉上溢更新；若更新落在上溢（启动时RCR=0，
+ *         或更新被UDIS屏蔽导致相位错开），在此调整RCR，两个周期内回到下溢
+ * @retval 无
+ */
+void MS8313_TIM_IRQHandler(void)
+{
+    if(MS8313_TIM->SR & TIM_SR_UIF)
+    {
+        MS8313_TIM->SR = (uint16_t)~TIM_SR_UIF;
+        
+        if(!(MS8313_TIM->CR1 & TIM_CR1_DIR))
+        {
+#if !MS8313_USE_TIM1
+            // 上半周期的比较值刚装载，写入下半周期的值，在上溢时装载
+            if(asym_enabled)
+            {
+                MS8313_PWM_A = asym_buf[asym_index].ccr_down[0];
+                MS8313_PWM_B = asym_buf[asym_index].ccr_down[1];
+                MS8313_PWM_C = asym_buf[asym_index].ccr_down[2];
+            }
+#endif
+#if MS8313_USE_TIM1
+            if(pending_period)
+            {
+                MS8313_ApplyTiming();
+            }
+#endif
+            if(++control_count >= timing.control_divider)
+            {
+                control_count = 0;
+                MS8313_ControlCallback();
+            }
+        }
+        else
+        {
+#if MS8313_USE_TIM1
+            // 本次上溢已装载RCR：RCR为0时写入目标值，下一次下溢装载后即对齐；
+            // 否则先写0，让下一次上溢再走一遍对齐流程
+            TIM1->RCR = (TIM1->RCR == 0) ? MS8313_TIM1_REPETITION : 0;
+#else
+            // 下一个PWM周期的图样在此生效：上半周期比较值在下溢时装载，
+            // 第一个触发点此刻写入，向下计数时OC4REF先回到无效，再在向上计数时触发
+            if(asym_enabled)
+            {
+                // 电流采样中断可抢占本中断并写入图样：写入方只改另一组，这里只切换索引。
+                // 先切换再清标志，被抢占时最多丢掉一次更新（沿用上一周期的完整图样）
+                if(asym_new)
+                {
+                    asym_index ^= 1;
+                    asym_new = 0;
+                }
+                MS8313_PWM_A = asym_buf[asym_index].ccr_up[0];
+                MS8313_PWM_B = asym_buf[asym_index].ccr_up[1];
+                MS8313_PWM_C = asym_buf[asym_index].ccr_up[2];
+                MS8313_TIM->CCR4 = asym_buf[asym_index].trigger[0];
+            }
+            else if(sym_pending)
+            {
+                // 对称比较值在下溢装载，整个PWM周期不变
+                uint8_t i = sym_index;
+                
+                sym_pending = 0;
+                MS8313_PWM_A = sym_ccr[i][0];
+                MS8313_PWM_B = sym_ccr[i][1];
+                MS8313_PWM_C = sym_ccr[i][2];
+            }
+            
+            // 下一次更新事件即下溢（周期边界）
+            if(pending_period)
+            {
+                MS8313_ApplyTiming();
+            }
+#endif
+        }
+    }
+}
+
+/**
+ * @brief  刹车中断处理（仅TIM1后端）
+ * @note   硬件已异步清除MOE，输出处于空闲电平；这里补充拉低使能引脚。
+ *         BKIN保持有效时BIF无法清除，因此关闭刹车中断避免反复进入，
+ *         由 MS8313_ClearFault 重新打开
+ * @retval 无
+ */
+void MS8313_BRK_IRQHandler(void)
+{
+#if MS8313_USE_TIM1
+    if(TIM1->SR & TIM_SR_BIF)
+    {
+        TIM_ITConfig(TIM1, TIM_IT_Break, DISABLE);
+        TIM1->SR = (uint16_t)~TIM_SR_BIF;
+        
+        GPIO_ResetBits(MS8313_EN_PORT, MS8313_EN_PIN);
+        break_fault = 1;
+        output_enabled = 0;
+    }
+#endif
+}
+
+/**
+ * @brief  获取硬件刹车故障状态
+ * @retval 1: 发生过刹车且未清除, 0: 无故障（TIM2后端恒为0）
+ */
+uint8_t MS8313_GetFault(void)
+{
+    return break_fault;
+}
+
+/**
+ * @brief  清除刹车故障
+ * @note   刹车输入仍有效时清除失败；清除后输出保持禁用，需重新调用 MS8313_EnableOutput
+ * @retval 1: 清除成功, 0: 刹车输入仍有效
+ */
+uint8_t MS8313_ClearFault(void)
+{
+#if MS8313_USE_TIM1
+    // BKIN低有效
+    if(GPIO_ReadInputDataBit(MS8313_BKIN_PORT, MS8313_BKIN_PIN) == Bit_RESET)
+    {
+        return 0;
+    }
+    
+    TIM1->SR = (uint16_t)~TIM_SR_BIF;
+    TIM_ITConfig(TIM1, TIM_IT_Break, ENABLE);
+#endif
+    break_fault = 0;
+    
+    return 1;
+}
+
+/**
+ * @brief  控制周期回调（弱定义，用户重写）
+ * @retval 无
+ */
+__weak void MS8313_ControlCallback(void)
+{
+    // 默认实现：什么都不做
+}
+
 /**
  * @brief  PWM测试函数
  * @note   输出固定占空比的PWM用于测试
@@ -233,10 +841,13 @@ uint8_t MS8313_GetOutputStatus(void)
 void MS8313_TestPWM(void)
 {
     // 设置测试PWM占空比
-    MS8313_SetThreePhaseDuty(500, 300, 700);  // A:50%, B:30%, C:70%
+    MS8313_SetThreePhaseDuty(timing.period / 2, timing.period * 3 / 10, timing.period * 7 / 10);  // A:50%, B:30%, C:70%
     
     // 确保定时器运行
-    TIM_Cmd(TIM2, ENABLE);
+    TIM_Cmd(MS8313_TIM, ENABLE);
+#if MS8313_USE_TIM1
+    TIM_CtrlPWMOutputs(TIM1, ENABLE);
+#endif
     
     // 使能MS8313芯片
     GPIO_SetBits(MS8313_EN_PORT, MS8313_EN_PIN);
@@ -252,13 +863,16 @@ void MS8313_TestPWM(void)
  */
 void MS8313_ForcePWMTest(void)
 {
-    // 直接设置PWM比较值
-    TIM2->CCR1 = 500;  // A相50%
-    TIM2->CCR2 = 300;  // B相30%
-    TIM2->CCR3 = 700;  // C相70%
+    // 直接设置PWM比较值（PWM2模式：比较值 = 周期 - 占空比）
+    MS8313_TIM->CCR1 = timing.period - timing.period / 2;       // A相50%
+    MS8313_TIM->CCR2 = timing.period - timing.period * 3 / 10;  // B相30%
+    MS8313_TIM->CCR3 = timing.period - timing.period * 7 / 10;  // C相70%
     
     // 确保定时器运行
-    TIM2->CR1 |= TIM_CR1_CEN;  // 使能定时器
+    MS8313_TIM->CR1 |= TIM_CR1_CEN;  // 使能定时器
+#if MS8313_USE_TIM1
+    MS8313_TIM->BDTR |= TIM_BDTR_MOE;  // 高级定时器需置位主输出使能
+#endif
     
     // 使能MS8313芯片
     GPIO_SetBits(MS8313_EN_PORT, MS8313_EN_PIN);
@@ -277,16 +891,16 @@ void MS8313_GPIO_Test(void)
     // 先将PWM引脚配置为普通GPIO输出
     GPIO_InitTypeDef GPIO_InitStructure;
     
-    // 配置PA0, PA1, PA2为普通GPIO输出
-    GPIO_InitStructure.GPIO_Pin = GPIO_Pin_0 | GPIO_Pin_1 | GPIO_Pin_2;
+    // 配置三相PWM引脚为普通GPIO输出
+    GPIO_InitStructure.GPIO_Pin = MS8313_PWM_PINS;
     GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;  // 推挽输出
     GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-    GPIO_Init(GPIOA, &GPIO_InitStructure);
+    GPIO_Init(MS8313_PWM_PORT, &GPIO_InitStructure);
     
     // 输出测试信号
-    GPIO_SetBits(GPIOA, GPIO_Pin_0);   // PA0 = 1
-    GPIO_ResetBits(GPIOA, GPIO_Pin_1);  // PA1 = 0
-    GPIO_SetBits(GPIOA, GPIO_Pin_2);    // PA2 = 1
+    GPIO_SetBits(MS8313_PWM_PORT, MS8313_PWM_PIN_A);    // A = 1
+    GPIO_ResetBits(MS8313_PWM_PORT, MS8313_PWM_PIN_B);  // B = 0
+    GPIO_SetBits(MS8313_PWM_PORT, MS8313_PWM_PIN_C);    // C = 1
     
     // 使能MS8313芯片
     GPIO_SetBits(MS8313_EN_PORT, MS8313_EN_PIN);
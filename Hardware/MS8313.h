@@ -4,13 +4,58 @@
 #include <stdint.h>
 
 // ==================== 硬件配置 ====================
-#define MS8313_PWM_FREQ     16000   // PWM频率（Hz）
-#define MS8313_PWM_PERIOD   1000    // PWM周期值（ARR）
+#define MS8313_TIM_CLOCK    36000000    // 定时器计数时钟（72MHz / 2）
+#define MS8313_PWM_FREQ     18000       // 默认PWM频率（Hz）
+#define MS8313_PWM_PERIOD   (MS8313_TIM_CLOCK / 2 / MS8313_PWM_FREQ)    // 默认PWM周期值（ARR = 1000）
+#define MS8313_PWM_PERIOD_MIN   100     // 周期值下限（180kHz）
+#define MS8313_CONTROL_FREQ 1000        // 控制回调频率（Hz）
+
+// 中心对齐模式：计数器 0→ARR→0 为一个PWM周期
+// 高边导通脉冲居中于计数峰值，下溢（谷点）时三相均为下桥导通，
+// 下溢更新中断作为控制周期触发点，也是低边电流采样点
+#define MS8313_CONTROL_DIVIDER  (MS8313_PWM_FREQ / MS8313_CONTROL_FREQ)  // 默认每 N 个PWM周期执行一次控制回调
+
+// 定时器后端选择
+// 0: 通用定时器TIM2（PA0/PA1/PA2），无刹车输入，故障时只能由软件关断
+// 1: 高级定时器TIM1（PB13/PB14/PB15 = CH1N/CH2N/CH3N），PB12 = BKIN 硬件刹车，
+//    刹车信号异步清除MOE，输出在一个 tDTS 量级内回到空闲电平（低），不依赖软件
+#ifndef MS8313_USE_TIM1
+#define MS8313_USE_TIM1     0
+#endif
+
+#if MS8313_USE_TIM1
+// 1: 同时输出CH1/CH2/CH3（PA8/PA9/PA10）构成互补对，死区由BDTR插入，用于分立栅极驱动；
+//    PA9/PA10与USART1冲突，启用前需迁移串口
+// 0: 仅输出CHxN（MS8313为单输入半桥，内部自带死区），BDTR死区不作用于单路输出
+#define MS8313_TIM1_COMPLEMENTARY   0
+#define MS8313_DEADTIME_NS          500     // 互补输出死区时间（ns，tDTS = 1/72MHz，最大约1.7us）
+#define MS8313_DEADTIME_DTG         ((MS8313_DEADTIME_NS * 72) / 1000)
+// 重复计数器：中心对齐模式下上溢和下溢各减一次，RCR = 1 时每个PWM周期只在下溢产生一次更新，
+// 影子寄存器也只在下溢装载；RCR = 2N - 1 可把更新中断降到每 N 个周期一次
+#define MS8313_TIM1_REPETITION      1
+
+#define MS8313_TIM          TIM1
+#define MS8313_UPDATE_IRQn  TIM1_UP_IRQn    // 控制回调所在中断
+#define MS8313_PWM_PORT     GPIOB
+#define MS8313_PWM_PIN_A    GPIO_Pin_13     // TIM1_CH1N
+#define MS8313_PWM_PIN_B    GPIO_Pin_14     // TIM1_CH2N
+#define MS8313_PWM_PIN_C    GPIO_Pin_15     // TIM1_CH3N
+#define MS8313_BKIN_PORT    GPIOB
+#define MS8313_BKIN_PIN     GPIO_Pin_12     // 低电平有效（接驱动器nFAULT/比较器输出）
+#else
+#define MS8313_TIM          TIM2
+#define MS8313_UPDATE_IRQn  TIM2_IRQn       // 控制回调所在中断
+#define MS8313_PWM_PORT     GPIOA
+#define MS8313_PWM_PIN_A    GPIO_Pin_0      // TIM2_CH1
+#define MS8313_PWM_PIN_B    GPIO_Pin_1      // TIM2_CH2
+#define MS8313_PWM_PIN_C    GPIO_Pin_2      // TIM2_CH3
+#endif
+#define MS8313_PWM_PINS     (MS8313_PWM_PIN_A | MS8313_PWM_PIN_B | MS8313_PWM_PIN_C)
 
 // PWM通道定义（3个半H桥）
-#define MS8313_PWM_A        TIM2->CCR1  // A相PWM
-#define MS8313_PWM_B        TIM2->CCR2  // B相PWM
-#define MS8313_PWM_C        TIM2->CCR3  // C相PWM
+#define MS8313_PWM_A        MS8313_TIM->CCR1  // A相PWM
+#define MS8313_PWM_B        MS8313_TIM->CCR2  // B相PWM
+#define MS8313_PWM_C        MS8313_TIM->CCR3  // C相PWM
 
 // 相别定义
 #define MS8313_PHASE_A      0
@@ -21,11 +66,38 @@
 #define MS8313_EN_PORT      GPIOA
 #define MS8313_EN_PIN       GPIO_Pin_3
 
+// ==================== 数据结构 ====================
+/**
+ * @brief PWM时序配置（运行时唯一来源）
+ * @note   占空比满量程 = period；PWM频率总是控制频率的整数倍，
+ *         使控制周期与PWM周期保持同相位
+ */
+typedef struct {
+    uint32_t pwm_freq;          // 实际PWM频率（Hz）
+    uint16_t period;            // PWM周期值（ARR，占空比满量程）
+    uint16_t control_divider;   // 每 N 个PWM周期执行一次控制回调
+    float control_freq;         // 实际控制频率（Hz）
+    float period_inv;           // 1 / period，占空比归一化用
+    uint32_t version;           // 每次生效的修改加1，供上层检测并重算时间常数
+} MS8313_Timing_t;
+
+/**
+ * @brief 非对称PWM图样（单电阻采样用）
+ * @note   上半周期（向上计数）与下半周期使用不同比较值，平均占空比不变；
+ *         采样触发点与附带信息随图样在同一个PWM周期生效
+ */
+typedef struct {
+    uint16_t ccr_up[3];         // 上半周期三相比较值
+    uint16_t ccr_down[3];       // 下半周期三相比较值
+    uint16_t trigger[2];        // 两次采样触发点（向上计数的CNT值）
+    uint8_t tag;                // 调用者附带信息（如采样对应的相序）
+} MS8313_AsymPattern_t;
+
 // ==================== 函数声明 ====================
 
 /**
  * @brief  MS8313 PWM初始化
- * @note   配置TIM1和TIM8输出6路PWM
+ * @note   按 MS8313_USE_TIM1 选择TIM2或TIM1输出3路PWM
  * @retval 无
  */
 void MS8313_Init(void);
@@ -33,20 +105,52 @@ void MS8313_Init(void);
 /**
  * @brief  设置PWM占空比
  * @param  phase: 相别（0=A, 1=B, 2=C）
- * @param  duty: 占空比（0-1000）
+ * @param  duty: 占空比（0-周期值）
  * @retval 无
  */
 void MS8313_SetDutyCycle(uint8_t phase, uint16_t duty);
 
 /**
- * @brief  设置三相PWM占空比
- * @param  duty_a: A相占空比（0-1000）
- * @param  duty_b: B相占空比（0-1000）
- * @param  duty_c: C相占空比（0-1000）
+ * @brief  设置三相PWM占空比（原子更新，三路在同一次更新事件生效）
+ * @param  duty_a: A相占空比（0-周期值）
+ * @param  duty_b: B相占空比（0-周期值）
+ * @param  duty_c: C相占空比（0-周期值）
  * @retval 无
  */
 void MS8313_SetThreePhaseDuty(uint16_t duty_a, uint16_t duty_b, uint16_t duty_c);
 
+/**
+ * @brief  设置非对称PWM图样（两个半周期分别装载）
+ * @note   仅TIM2后端：上溢与下溢各有一次更新事件，下一次上溢中断写入上半周期比较值
+ *         并装填第一个采样触发点，随后的下溢中断写入下半周期比较值。
+ *         调用 MS8313_SetThreePhaseDuty / MS8313_SetSixStep 或修改频率后恢复对称输出。
+ *         图样双缓冲，可在PWM中断或更高优先级的电流采样中断中调用
+ * @param  up: 上半周期三相占空比（0-周期值）
+ * @param  down: 下半周期三相占空比（0-周期值）
+ * @param  trigger1: 第一个采样触发点（向上计数的CNT值）
+ * @param  trigger2: 第二个采样触发点，由采样中断通过 MS8313_SetADCTriggerPoint 装填
+ * @param  tag: 附带信息，与图样一起生效
+ * @retval 无
+ */
+void MS8313_SetAsymmetricDuty(const uint16_t up[3], const uint16_t down[3],
+                              uint16_t trigger1, uint16_t trigger2, uint8_t tag);
+
+/**
+ * @brief  获取当前PWM周期正在生效的非对称图样
+ * @retval 图样指针（只读），对称输出时返回NULL
+ */
+const MS8313_AsymPattern_t* MS8313_GetActivePattern(void);
+
+/**
+ * @brief  六步换相输出
+ * @note   MS8313三相共用一个使能引脚，不能单独关断一相，
+ *         悬空相保持在周期中点；导通两相以中点对称 ±duty/2，线电压 = duty
+ * @param  step: 换相步（0-5，电压矢量方向 30° + 60° * step）
+ * @param  duty: 线电压占空比（0-周期值）
+ * @retval 无
+ */
+void MS8313_SetSixStep(uint8_t step, uint16_t duty);
+
 /**
  * @brief  使能PWM输出
  * @retval 无
@@ -59,13 +163,54 @@ void MS8313_EnableOutput(void);
  */
 void MS8313_DisableOutput(void);
 
+/**
+ * @brief  关闭驱动桥、保持定时器运行（电机自由滑行）
+ * @note   控制周期回调和电流采样继续，重新输出调用 MS8313_EnableOutput
+ * @retval 无
+ */
+void MS8313_Coast(void);
+
 /**
  * @brief  设置PWM频率
+ * @note   频率取整到控制频率的整数倍；定时器运行时在下一个PWM周期边界（下溢）生效，
+ *         生效时按新周期等比例换算当前三相比较值
  * @param  freq: PWM频率（Hz）
  * @retval 无
  */
 void MS8313_SetFrequency(uint32_t freq);
 
+/**
+ * @brief  配置ADC注入组触发
+ * @note   通道4作内部比较（不输出到引脚，PA3仍为使能引脚）：PWM1模式，
+ *         CNT < CCR4 时 OC4REF 有效，向下计数经过 CCR4 时产生上升沿，
+ *         经 TRGO 在谷点前 lead 个计数触发采样；与周期值无关，改频率不需重配
+ * @param  lead: 触发提前量（定时器计数，36MHz）
+ * @retval 无
+ */
+void MS8313_SetADCTrigger(uint16_t lead);
+
+/**
+ * @brief  配置单电阻采样触发
+ * @note   通道4改为PWM2模式并关闭预装载：CNT >= CCR4 时 OC4REF 有效，
+ *         向上计数经过 CCR4 时产生上升沿；写入立即生效，
+ *         在同一个上半周期内改写一次 CCR4 即可得到第二个触发沿
+ * @retval 无
+ */
+void MS8313_SetSingleShuntTrigger(void);
+
+/**
+ * @brief  改写采样触发点（立即生效）
+ * @param  count: 触发点（向上计数的CNT值）
+ * @retval 无
+ */
+void MS8313_SetADCTriggerPoint(uint16_t count);
+
+/**
+ * @brief  获取当前PWM时序配置
+ * @retval 时序配置指针（只读）
+ */
+const MS8313_Timing_t* MS8313_GetTiming(void);
+
 /**
  * @brief  停止所有PWM输出
  * @retval 无
@@ -79,6 +224,41 @@ void MS8313_StopAll(void);
  */
 uint8_t MS8313_GetOutputStatus(void);
 
+/**
+ * @brief  PWM定时器更新中断处理
+ * @note   在 TIM2_IRQHandler / TIM1_UP_IRQHandler 中调用，仅在计数器下溢时计数，
+ *         每 control_divider 次下溢调用一次 MS8313_ControlCallback()
+ * @retval 无
+ */
+void MS8313_TIM_IRQHandler(void);
+
+/**
+ * @brief  刹车中断处理（仅TIM1后端）
+ * @note   在 TIM1_BRK_IRQHandler 中调用。硬件已清除MOE，这里拉低使能引脚并锁存故障
+ * @retval 无
+ */
+void MS8313_BRK_IRQHandler(void);
+
+/**
+ * @brief  获取硬件刹车故障状态
+ * @retval 1: 发生过刹车且未清除, 0: 无故障（TIM2后端恒为0）
+ */
+uint8_t MS8313_GetFault(void);
+
+/**
+ * @brief  清除刹车故障
+ * @note   刹车输入仍有效时清除失败；清除后输出保持禁用，需重新调用 MS8313_EnableOutput
+ * @retval 1: 清除成功, 0: 刹车输入仍有效
+ */
+uint8_t MS8313_ClearFault(void);
+
+/**
+ * @brief  控制周期回调（弱定义，用户重写）
+ * @note   在PWM下溢中断中调用，与PWM同相位，写入的占空比在下一次更新事件生效
+ * @retval 无
+ */
+void MS8313_ControlCallback(void);
+
 /**
  * @brief  PWM测试函数
  * @note   输出固定占空比的PWM用于测试
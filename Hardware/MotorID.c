@@ -0,0 +1,359 @@
+#include "MotorID.h"
+#include "MS8313.h"
+#include "ADC.h"
+#include "Delay.h"
+#include "USART.h"
+
+#define MOTORID_E_INV          0.36787944f  // 1/e
+
+/**
+ * @brief  等待下一个电流采样
+ * @param  last: 上次采样计数（输入输出）
+ * @param  ialpha: α轴电流输出（A）
+ * @param  ibeta: β轴电流输出（A）
+ * @retval 1: 得到新采样, 0: 超时、故障或电流超限
+ */
+static uint8_t MotorID_Sample(uint32_t *last, float *ialpha, float *ibeta)
+{
+    const MYADC_Current_t *current = MYADC_GetCurrent();
+    uint32_t start = Delay_GetTick();
+    
+    while (current->count == *last) {
+        if (FOC_GetControlStatus()->fault || Delay_GetTick() - start >= MOTORID_SAMPLE_TIMEOUT_MS) {
+            return 0;
+        }
+    }
+    *last = current->count;
+    FOC_Clarke_Transform(current->ia, current->ib, current->ic, ialpha, ibeta);
+    
+    return (*ialpha * *ialpha + *ibeta * *ibeta) < MOTORID_MAX_CURRENT * MOTORID_MAX_CURRENT;
+}
+
+/**
+ * @brief  电压矢量线性过渡后保持
+ * @param  va0, vb0: 起始电压（V）
+ * @param  va1, vb1: 目标电压（V）
+ * @param  ramp_ms: 过渡时间（ms）
+ * @param  hold_ms: 到达后保持时间（ms）
+ * @retval 1: 完成, 0: 采样失败或电流超限
+ */
+static uint8_t MotorID_Ramp(float va0, float vb0, float va1, float vb1, uint32_t ramp_ms, uint32_t hold_ms)
+{
+    uint32_t last = MYADC_GetCurrent()->count;
+    uint32_t start = Delay_GetTick();
+    uint32_t t;
+    float ia, ib, k;
+    
+    while ((t = Delay_GetTick() - start) < ramp_ms + hold_ms) {
+        k = (t < ramp_ms) ? (float)t / ramp_ms : 1.0f;
+        FOC_SetOpenLoopVoltage(va0 + (va1 - va0) * k, vb0 + (vb1 - vb0) * k);
+        if (!MotorID_Sample(&last, &ia, &ib)) {
+            return 0;
+        }
+    }
+    FOC_SetOpenLoopVoltage(va1, vb1);
+    return 1;
+}
+
+/**
+ * @brief  平均 α/β 电流
+ * @param  samples: 平均次数
+ * @param  ialpha: α轴平均电流（A）
+ * @param  ibeta: β轴平均电流（A）
+ * @retval 1: 完成, 0: 采样失败或电流超限
+ */
+static uint8_t MotorID_Average(uint16_t samples, float *ialpha, float *ibeta)
+{
+    uint32_t last = MYADC_GetCurrent()->count;
+    float ia, ib, sum_a = 0.0f, sum_b = 0.0f;
+    uint16_t i;
+    
+    for (i = 0; i < samples; i++) {
+        if (!MotorID_Sample(&last, &ia, &ib)) {
+            return 0;
+        }
+        sum_a += ia;
+        sum_b += ib;
+    }
+    *ialpha = sum_a / samples;
+    *ibeta = sum_b / samples;
+    return 1;
+}
+
+/**
+ * @brief  两点直流注入测相电阻
+ * @note   转子被吸合到A相轴后不动，反电势为0；两点电流差抵消死区和采样偏置的固定误差。
+ *         结束时保持 MOTORID_RS_V2 输出
+ * @param  rs: 相电阻输出（Ω）
+ * @retval 1: 成功, 0: 失败
+ */
+static uint8_t MotorID_Resistance(float *rs)
+{
+    float i1, i2, ib;
+    
+    if (!MotorID_Ramp(0.0f, 0.0f, MOTORID_RS_V1, 0.0f, MOTORID_ALIGN_MS / 2, MOTORID_ALIGN_MS / 2) ||
+        !MotorID_Average(MOTORID_AVG_SAMPLES, &i1, &ib)) {
+        return 0;
+    }
+    if (!MotorID_Ramp(MOTORID_RS_V1, 0.0f, MOTORID_RS_V2, 0.0f, 0, MOTORID_SETTLE_MS) ||
+        !MotorID_Average(MOTORID_AVG_SAMPLES, &i2, &ib)) {
+        return 0;
+    }
+    if (i2 - i1 < MOTORID_MIN_DELTA_I) {
+        return 0;
+    }
+    
+    *rs = (MOTORID_RS_V2 - MOTORID_RS_V1) / (i2 - i1);
+    return 1;
+}
+
+/**
+ * @brief  电压阶跃测电气时间常数（面积法）
+ * @note   L·di/dt = ΔV - Rs·i，积分得 τ = ∫(ΔI∞ - Δi)dt / ΔI∞，ΔI∞ = ΔV / Rs；
+ *         对采样噪声不敏感，不需要找 63.2% 交点。阶跃紧接一次采样（下溢）写入，
+ *         两种定时器后端都在下一次下溢装载，新占空比一个PWM周期后生效，结果扣除该延迟。
+ *         结束时保持阶跃后电压
+ * @param  va0, vb0: 阶跃前电压（V）
+ * @param  va1, vb1: 阶跃后电压（V）
+ * @param  rs: 相电阻（Ω）
+ * @param  tau: 时间常数输出（s）
+ * @retval 1: 成功, 0: 失败（窗口末段未稳定说明窗口太短或转子移动）
+ */
+static uint8_t MotorID_StepTau(float va0, float vb0, float va1, float vb1, float rs, float *tau)
+{
+    float dva = va1 - va0;
+    float dvb = vb1 - vb0;
+    float dv = sqrtf(dva * dva + dvb * dvb);
+    float di = dv / rs;
+    float t = 1.0f / MS8313_GetTiming()->pwm_freq;
+    float ia, ib, i0, dev, prev = 0.0f, area = 0.0f, tail = 0.0f;
+    uint32_t last;
+    uint16_t k;
+    
+    if (!MotorID_Ramp(va0, vb0, va0, vb0, 0, MOTORID_SETTLE_MS) ||
+        !MotorID_Average(MOTORID_AVG_SAMPLES, &ia, &ib)) {
+        return 0;
+    }
+    
+    // 电流投影到阶跃方向
+    dva /= dv;
+    dvb /= dv;
+    i0 = ia * dva + ib * dvb;
+    
+    last = MYADC_GetCurrent()->count;
+    if (!MotorID_Sample(&last, &ia, &ib)) {
+        return 0;
+    }
+    FOC_SetOpenLoopVoltage(va1, vb1);
+    
+    for (k = 0; k < MOTORID_STEP_SAMPLES; k++) {
+        if (!MotorID_Sample(&last, &ia, &ib)) {
+            return 0;
+        }
+        dev = ia * dva + ib * dvb - i0;
+        area += (2.0f * di - prev - dev) * 0.5f * t;
+        prev = dev;
+        if (k >= MOTORID_STEP_SAMPLES * 3 / 4) {
+            tail += dev;
+        }
+    }
+    
+    tail /= MOTORID_STEP_SAMPLES - MOTORID_STEP_SAMPLES * 3 / 4;
+    if (fabsf(tail - di) > di * MOTORID_STEP_TOL) {
+        return 0;
+    }
+    *tau = area / di - t;
+    return *tau > 0.0f;
+}
+
+/**
+ * @brief  开环拖动测磁链和粘滞摩擦
+ * @note   电压矢量从A相轴（转子已对齐）开始旋转，频率线性上升到目标后保持；
+ *         稳态下 V = Rs·I + jω·L·I + jω·λ（L 取 (Ld+Lq)/2），反电势幅值与转子对齐无关；
+ *         输入功率扣除铜耗即机械功率 B·ωm²（电感无功平均为0）
+ * @param  motor: 电机参数（使用 rs / ld / lq / pole_pairs）
+ * @param  flux: 磁链输出（V·s/rad）
+ * @param  friction: 粘滞摩擦系数输出（N·m·s/rad），机械功率不为正时输出0
+ * @retval 1: 同步运行并完成测量, 0: 失步或采样失败
+ */
+static uint8_t MotorID_Spin(const FOC_MotorParam_t *motor, float *flux, float *friction)
+{
+    FOC_Control_t *foc = FOC_GetControlStatus();
+    float omega_target = MOTORID_SPIN_RPM * (2.0f * PI / 60.0f) * motor->pole_pairs;
+    float accel = omega_target / (MOTORID_SPIN_RAMP_MS * 0.001f);
+    float wl = 0.0f, omega = 0.0f, theta = 0.0f;
+    float va = MOTORID_SPIN_VOLTAGE, vb = 0.0f;
+    float ia, ib, ea, eb, dt;
+    float sum_p = 0.0f, sum_i2 = 0.0f, sum_e = 0.0f, sum_speed = 0.0f;
+    float speed, power, omega_m;
+    uint32_t last = MYADC_GetCurrent()->count;
+    uint32_t now, prev = Delay_GetMicros();
+    uint32_t hold = 0, n = 0;
+    uint8_t at_speed = 0;
+    
+    while (!at_speed || Delay_GetTick() - hold < MOTORID_SPIN_SETTLE_MS + MOTORID_SPIN_MEASURE_MS) {
+        if (!MotorID_Sample(&last, &ia, &ib)) {
+            return 0;
+        }
+        
+        // 本次采样对应上次写入的电压，一个PWM周期内矢量转角可忽略
+        if (at_speed && Delay_GetTick() - hold >= MOTORID_SPIN_SETTLE_MS) {
+            ea = va - motor->rs * ia + wl * ib;
+            eb = vb - motor->rs * ib - wl * ia;
+            sum_e += sqrtf(ea * ea + eb * eb);
+            sum_p += va * ia + vb * ib;
+            sum_i2 += ia * ia + ib * ib;
+            sum_speed += (foc->speed_rpm >= 0.0f) ? foc->speed_rpm : -foc->speed_rpm;
+            n++;
+        }
+        
+        // 频率斜坡与相位积分
+        now = Delay_GetMicros();
+        dt = (now - prev) * 0.000001f;
+        prev = now;
+        if (!at_speed) {
+            omega += accel * dt;
+            if (omega >= omega_target) {
+                omega = omega_target;
+                wl = omega * 0.5f * (motor->ld + motor->lq);
+                hold = Delay_GetTick();
+                at_speed = 1;
+            }
+        }
+        theta += omega * dt;
+        if (theta >= 2.0f * PI) {
+            theta -= 2.0f * PI;
+        }
+        va = MOTORID_SPIN_VOLTAGE * cosf(theta);
+        vb = MOTORID_SPIN_VOLTAGE * sinf(theta);
+        FOC_SetOpenLoopVoltage(va, vb);
+    }
+    
+    if (n == 0) {
+        return 0;
+    }
+    
+    // 失步判定：实测机械转速应与拖动转速一致
+    speed = sum_speed / n;
+    USART1_Printf("MotorID: spin %.0f RPM (drive %.0f RPM)\r\n", speed, MOTORID_SPIN_RPM);
+    if (speed < MOTORID_SPIN_RPM * (1.0f - MOTORID_SYNC_TOL) || speed > MOTORID_SPIN_RPM * (1.0f + MOTORID_SYNC_TOL)) {
+        return 0;
+    }
+    
+    *flux = sum_e / n / omega_target;
+    
+    // 幅值不变Clarke：三相功率 = 1.5·(vα·iα + vβ·iβ)
+    power = 1.5f * (sum_p - motor->rs * sum_i2) / n;
+    omega_m = omega_target / motor->pole_pairs;
+    *friction = (power > 0.0f) ? power / (omega_m * omega_m) : 0.0f;
+    return 1;
+}
+
+/**
+ * @brief  滑行测机械时间常数
+ * @note   关闭驱动桥后只受摩擦减速，ω(t) = ω0·e^(-t·B/J)；定时器保持运行，继续测速
+ * @param  tau: 机械时间常数输出（s）
+ * @retval 1: 成功, 0: 超时（转速未降到 1/e）
+ */
+static uint8_t MotorID_Coast(float *tau)
+{
+    FOC_Control_t *foc = FOC_GetControlStatus();
+    float speed0 = (foc->speed_rpm >= 0.0f) ? foc->speed_rpm : -foc->speed_rpm;
+    float speed;
+    uint32_t start = Delay_GetTick();
+    uint32_t t;
+    
+    MS8313_Coast();
+    while ((t = Delay_GetTick() - start) < MOTORID_COAST_TIMEOUT_MS) {
+        speed = (foc->speed_rpm >= 0.0f) ? foc->speed_rpm : -foc->speed_rpm;
+        if (speed <= speed0 * MOTORID_E_INV) {
+            *tau = t * 0.001f;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief  离线电机参数辨识（阻塞，约数秒）
+ * @param  motor: 电机参数（输入为当前值，输出为辨识结果，失败的项保持原值）
+ * @param  angle_offset: 电角度零点（输出，MOTORID_OFFSET_OK 时有效）
+ * @retval 成功的项（MOTORID_x_OK 组合）
+ */
+uint8_t MotorID_Run(FOC_MotorParam_t *motor, uint16_t *angle_offset)
+{
+    FOC_Control_t *foc = FOC_GetControlStatus();
+    float rs, tau, flux, friction;
+    float dv = MOTORID_RS_V2 - MOTORID_RS_V1;
+    uint8_t result = 0;
+    uint32_t start;
+    
+    if (foc->enable || foc->fault) {
+        USART1_Printf("MotorID: FOC must be disabled\r\n");
+        return 0;
+    }
+    if (motor->pole_pairs == 0) {
+        motor->pole_pairs = 1;
+    }
+    
+    FOC_SetOpenLoopVoltage(0.0f, 0.0f);
+    MS8313_EnableOutput();
+    
+    // 1. 相电阻（结束时转子对齐A相轴，输出 V2），此时的位置角度即电角度零点
+    if (MotorID_Resistance(&rs)) {
+        motor->rs = rs;
+        *angle_offset = foc->angle;
+        result |= MOTORID_RS_OK | MOTORID_OFFSET_OK;
+        USART1_Printf("MotorID: Rs %.3f ohm, angle offset %d\r\n", rs, *angle_offset);
+    } else {
+        USART1_Printf("MotorID: Rs failed\r\n");
+    }
+    
+    // 2. 电感：d轴沿A相轴从 V2 降到 V1（电流不超过电阻测量），q轴在 V1 对齐下叠加β阶跃
+    if (result & MOTORID_RS_OK) {
+        if (MotorID_StepTau(MOTORID_RS_V2, 0.0f, MOTORID_RS_V1, 0.0f, rs, &tau)) {
+            motor->ld = tau * rs;
+            result |= MOTORID_LD_OK;
+        }
+        if (MotorID_StepTau(MOTORID_RS_V1, 0.0f, MOTORID_RS_V1, dv, rs, &tau)) {
+            motor->lq = tau * rs;
+            result |= MOTORID_LQ_OK;
+        }
+        USART1_Printf("MotorID: Ld %.6f H%s, Lq %.6f H%s\r\n",
+                      motor->ld, (result & MOTORID_LD_OK) ? "" : " (failed)",
+                      motor->lq, (result & MOTORID_LQ_OK) ? "" : " (failed)");
+    }
+    
+    // 3. 开环拖动：从对齐位置过渡到拖动电压，测磁链和摩擦
+    if (!foc->fault &&
+        MotorID_Ramp(MOTORID_RS_V1, 0.0f, MOTORID_SPIN_VOLTAGE, 0.0f, MOTORID_SETTLE_MS, MOTORID_SETTLE_MS) &&
+        MotorID_Spin(motor, &flux, &friction)) {
+        motor->flux = flux;
+        result |= MOTORID_FLUX_OK;
+        if (friction > 0.0f) {
+            motor->friction = friction;
+            result |= MOTORID_FRICTION_OK;
+        }
+        USART1_Printf("MotorID: flux %.5f Vs/rad, friction %.3e Nms/rad\r\n", flux, friction);
+        
+        // 4. 滑行：J = B·τm
+        if ((result & MOTORID_FRICTION_OK) && MotorID_Coast(&tau)) {
+            motor->inertia = friction * tau;
+            result |= MOTORID_INERTIA_OK;
+            USART1_Printf("MotorID: coast %.3f s, inertia %.3e kgm2\r\n", tau, motor->inertia);
+        }
+    } else {
+        USART1_Printf("MotorID: spin failed\r\n");
+    }
+    
+    // 5. 关闭驱动桥等待停止，恢复零矢量后关闭输出
+    MS8313_Coast();
+    start = Delay_GetTick();
+    while ((foc->speed_rpm > MOTORID_STOP_RPM || foc->speed_rpm < -MOTORID_STOP_RPM) &&
+           Delay_GetTick() - start < MOTORID_COAST_TIMEOUT_MS);
+    FOC_SetOpenLoopVoltage(0.0f, 0.0f);
+    MS8313_DisableOutput();
+    
+    USART1_Printf("MotorID: done, result 0x%02X\r\n", result);
+    return result;
+}
@@ -0,0 +1,62 @@
+#ifndef __MOTORID_H
+#define __MOTORID_H
+
+#include <stdint.h>
+#include "FOC.h"
+
+// ==================== 配置参数 ====================
+// 离线电机参数辨识（FOC禁用时运行，电机会转动）：
+// 1. 相电阻：沿A相轴两点直流注入，Rs = ΔV / ΔI（抵消死区和采样偏置的固定误差），
+//    转子吸合在A相轴，同时记录电角度零点；
+// 2. d/q电感：电压阶跃，面积法求时间常数 τ = ∫(I∞ - i)dt / ΔI∞，L = τ·Rs；
+// 3. 磁链和摩擦：开环旋转电压矢量拖动到固定转速，AS5600确认同步后
+//    λ = |V - Rs·I - jωL·I| / ω，粘滞摩擦 B = (P_in - P_cu) / ωm²；
+// 4. 惯量：关闭驱动桥自由滑行，转速降到 1/e 的时间 τm = J / B
+#define MOTORID_AT_STARTUP         0       // 1: 上电时未辨识过则自动辨识并保存（电机会转动）
+
+#define MOTORID_MAX_CURRENT        1.5f    // 实验电流上限（A），超出立即中止
+#define MOTORID_SAMPLE_TIMEOUT_MS  5       // 等待电流采样超时（ms），定时器停止或故障时退出
+
+#define MOTORID_RS_V1              0.5f    // 电阻测量第一点电压（V），电流应明显大于死区补偿线性区
+#define MOTORID_RS_V2              1.0f    // 电阻测量第二点电压（V），按相电阻选取，使电流约为额定的一半
+#define MOTORID_ALIGN_MS           200     // 注入电压斜坡 + 转子对齐时间（ms）
+#define MOTORID_SETTLE_MS          30      // 电压改变后等待电流稳定（ms）
+#define MOTORID_AVG_SAMPLES        512     // 电流平均次数
+#define MOTORID_MIN_DELTA_I        0.1f    // 两点电流差下限（A），过小时电阻不可信
+
+#define MOTORID_STEP_SAMPLES       128     // 阶跃响应积分窗口（PWM周期），须覆盖约5倍电气时间常数
+#define MOTORID_STEP_TOL           0.1f    // 窗口末段电流与 ΔV/Rs 的允许偏差（相对值）
+
+#define MOTORID_SPIN_VOLTAGE       2.0f    // 开环拖动电压幅值（V）
+#define MOTORID_SPIN_RPM           300.0f  // 开环拖动转速（RPM）
+#define MOTORID_SPIN_RAMP_MS       2000    // 拖动频率线性上升时间（ms）
+#define MOTORID_SPIN_SETTLE_MS     500     // 到达转速后等待稳定（ms）
+#define MOTORID_SPIN_MEASURE_MS    500     // 磁链/摩擦测量窗口（ms）
+#define MOTORID_SYNC_TOL           0.1f    // 实测转速与拖动转速的允许偏差（相对值），超出视为失步
+
+#define MOTORID_COAST_TIMEOUT_MS   3000    // 滑行测量超时（ms）
+#define MOTORID_STOP_RPM           5.0f    // 视为停止的转速（RPM）
+
+// 辨识结果（可同时存在）
+#define MOTORID_RS_OK              0x01
+#define MOTORID_LD_OK              0x02
+#define MOTORID_LQ_OK              0x04
+#define MOTORID_FLUX_OK            0x08
+#define MOTORID_FRICTION_OK        0x10
+#define MOTORID_INERTIA_OK         0x20
+#define MOTORID_OFFSET_OK          0x40    // 电角度零点
+
+// ==================== 函数声明 ====================
+/**
+ * @brief  离线电机参数辨识（阻塞，约数秒）
+ * @note   须在电流采样校准、AS5600和测速初始化之后，FOC_Enable 之前从主循环调用；
+ *         电感、磁链依赖本次或已有的相电阻，惯量依赖摩擦系数。
+ *         结束后关闭输出，电机已停止；过程和结果经 USART1 输出。
+ *         结果不自动生效，由调用者 FOC_SetMotorParam 并按需保存
+ * @param  motor: 电机参数（输入为当前值，极对数须已知；输出为辨识结果，失败的项保持原值）
+ * @param  angle_offset: 电角度零点（输出，MOTORID_OFFSET_OK 时有效，由调用者 FOC_SetAngleOffset）
+ * @retval 成功的项（MOTORID_x_OK 组合）
+ */
+uint8_t MotorID_Run(FOC_MotorParam_t *motor, uint16_t *angle_offset);
+
+#endif
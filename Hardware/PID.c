@@ -0,0 +1,220 @@
+#include "PID.h"
+
+#define PID_PI                  3.14159265359f
+
+/**
+ * @brief  计算反算增益
+ * @note   默认跟踪时间常数取积分时间 Ti = kp/ki；纯积分控制器按一个采样周期回退
+ */
+static void PID_UpdateTracking(PID_t *pid)
+{
+    if (pid->kp > 0.0f && pid->ki > 0.0f) {
+        pid->kt = pid->ki / pid->kp;
+    } else {
+        pid->kt = 1.0f / pid->dt;
+    }
+}
+
+/**
+ * @brief  计算微分低通系数
+ */
+static void PID_UpdateFilter(PID_t *pid)
+{
+    float tf = 1.0f / (2.0f * PID_PI * pid->d_cutoff);
+    
+    pid->d_alpha = pid->dt / (tf + pid->dt);
+}
+
+/**
+ * @brief  积分项反算回退
+ * @param  error: 实际输出 - 未限幅输出
+ */
+static void PID_BackCalculate(PID_t *pid, float error)
+{
+    float gain = pid->kt * pid->dt;
+    
+    // 单步回退不超过饱和量，避免积分项反向越过
+    if (gain > 1.0f) {
+        gain = 1.0f;
+    }
+    pid->integral += gain * error;
+}
+
+/**
+ * @brief  PID控制器初始化（kd=0 即为PI控制器）
+ * @param  pid: 控制器指针
+ * @param  kp: 比例增益
+ * @param  ki: 积分增益（1/s）
+ * @param  kd: 微分增益（s）
+ * @param  dt: 采样周期（s）
+ * @param  output_max: 输出上限
+ * @param  output_min: 输出下限
+ * @retval 无
+ */
+void PID_Init(PID_t *pid, float kp, float ki, float kd, float dt,
+              float output_max, float output_min)
+{
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+    pid->b = 1.0f;
+    pid->dt = dt;
+    pid->d_cutoff = PID_DEFAULT_D_CUTOFF;
+    pid->output_max = output_max;
+    pid->output_min = output_min;
+    PID_UpdateTracking(pid);
+    PID_UpdateFilter(pid);
+    PID_Reset(pid, 0.0f);
+}
+
+/**
+ * @brief  PID控制器计算
+ * @param  pid: 控制器指针
+ * @param  setpoint: 设定值
+ * @param  measurement: 测量值
+ * @param  feedforward: 前馈量（与PID输出相加后整体限幅）
+ * @retval 控制器输出（含前馈，已限幅）
+ */
+float PID_Update(PID_t *pid, float setpoint, float measurement, float feedforward)
+{
+    float error = setpoint - measurement;
+    float output, output_sat;
+    
+    // 微分项：作用在测量值上，一阶低通滤波
+    if (pid->kd != 0.0f) {
+        if (pid->initialized) {
+            float d_raw = -pid->kd * (measurement - pid->last_measurement) / pid->dt;
+            pid->d_term += pid->d_alpha * (d_raw - pid->d_term);
+        }
+    } else {
+        pid->d_term = 0.0f;
+    }
+    pid->last_setpoint = setpoint;
+    pid->last_measurement = measurement;
+    pid->initialized = 1;
+    
+    // 比例 + 积分 + 微分 + 前馈
+    output = pid->kp * (pid->b * setpoint - measurement) + pid->integral + pid->d_term + feedforward;
+    
+    // 输出限制
+    output_sat = output;
+    if (output_sat > pid->output_max) {
+        output_sat = pid->output_max;
+    } else if (output_sat < pid->output_min) {
+        output_sat = pid->output_min;
+    }
+    
+    // 积分：误差积分 + 饱和反算回退
+    pid->integral += pid->ki * pid->dt * error;
+    PID_BackCalculate(pid, output_sat - output);
+    
+    pid->output = output_sat - feedforward;
+    return output_sat;
+}
+
+/**
+ * @brief  报告下游实际执行的输出，用于反算抗饱和
+ * @note   在 PID_Update 之后、下一次 PID_Update 之前调用；
+ *         applied 与 PID_Update 返回值同单位（含前馈）
+ * @param  pid: 控制器指针
+ * @param  applied: 实际执行的输出
+ * @param  feedforward: 本周期前馈量
+ * @retval 无
+ */
+void PID_Saturation(PID_t *pid, float applied, float feedforward)
+{
+    float delta = (applied - feedforward) - pid->output;
+    
+    PID_BackCalculate(pid, delta);
+    pid->output += delta;
+}
+
+/**
+ * @brief  修改增益（无扰：调整积分项使当前输出不变）
+ * @param  pid: 控制器指针
+ * @param  kp: 比例增益
+ * @param  ki: 积分增益（1/s）
+ * @param  kd: 微分增益（s）
+ * @retval 无
+ */
+void PID_SetGains(PID_t *pid, float kp, float ki, float kd)
+{
+    float d_term = 0.0f;
+    
+    if (pid->initialized) {
+        // 比例项和微分项的变化量转入积分项
+        if (pid->kd != 0.0f) {
+            d_term = pid->d_term * (kd / pid->kd);
+        }
+        pid->integral += (pid->kp - kp) * (pid->b * pid->last_setpoint - pid->last_measurement)
+                         + pid->d_term - d_term;
+    }
+    pid->d_term = d_term;
+    
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+    PID_UpdateTracking(pid);
+}
+
+/**
+ * @brief  设置采样周期（增益为物理单位，改变调用频率无需重新整定）
+ * @param  pid: 控制器指针
+ * @param  dt: 采样周期（s）
+ * @retval 无
+ */
+void PID_SetDt(PID_t *pid, float dt)
+{
+    pid->dt = dt;
+    PID_UpdateTracking(pid);
+    PID_UpdateFilter(pid);
+}
+
+/**
+ * @brief  设置比例项设定值权重
+ * @note   b<1 时设定值阶跃的比例冲击减小，由积分项平滑接管
+ * @param  pid: 控制器指针
+ * @param  b: 权重（0-1）
+ * @retval 无
+ */
+void PID_SetWeight(PID_t *pid, float b)
+{
+    // 权重变化引起的比例项变化转入积分项
+    if (pid->initialized) {
+        pid->integral += pid->kp * (pid->b - b) * pid->last_setpoint;
+    }
+    pid->b = b;
+}
+
+/**
+ * @brief  设置微分低通截止频率
+ * @param  pid: 控制器指针
+ * @param  cutoff: 截止频率（Hz）
+ * @retval 无
+ */
+void PID_SetDerivativeFilter(PID_t *pid, float cutoff)
+{
+    pid->d_cutoff = cutoff;
+    PID_UpdateFilter(pid);
+}
+
+/**
+ * @brief  复位控制器
+ * @param  pid: 控制器指针
+ * @param  output: 积分项预置值（输出单位，0=清零）
+ * @retval 无
+ */
+void PID_Reset(PID_t *pid, float output)
+{
+    if (output > pid->output_max) {
+        output = pid->output_max;
+    } else if (output < pid->output_min) {
+        output = pid->output_min;
+    }
+    pid->integral = output;
+    pid->d_term = 0.0f;
+    pid->last_setpoint = 0.0f;
+    pid->last_measurement = 0.0f;
+    pid->output = output;
+    pid->initialized = 0;
+}
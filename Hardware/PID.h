@@ -0,0 +1,120 @@
+#ifndef __PID_H
+#define __PID_H
+
+#include <stdint.h>
+
+// ==================== 配置参数 ====================
+// 增益均为物理单位，与调用频率无关：
+//   kp：输出单位/误差单位
+//   ki：输出单位/(误差单位·s)，每次调用积分 ki·e·dt
+//   kd：输出单位·s/误差单位，微分作用在测量值上（设定值变化不产生微分冲击）
+#define PID_DEFAULT_D_CUTOFF    200.0f  // 微分一阶低通截止频率（Hz）
+
+// ==================== 数据结构 ====================
+/**
+ * @brief PID控制器结构体
+ * @note  积分项以输出单位保存，可直接预置为期望输出实现无扰切换；
+ *        抗饱和采用反算法：积分项按 kt·(实际输出 - 未限幅输出) 回退，
+ *        实际输出既包括本模块的输出限幅，也包括下游（如电压矢量限幅）通过
+ *        PID_Saturation 报告的饱和
+ */
+typedef struct {
+    float kp;                   // 比例增益
+    float ki;                   // 积分增益（1/s）
+    float kd;                   // 微分增益（s）
+    float kt;                   // 反算抗饱和增益（1/s），默认 ki/kp
+    float b;                    // 比例项设定值权重（0-1，1=误差比例）
+    float dt;                   // 采样周期（s）
+    float d_cutoff;             // 微分低通截止频率（Hz）
+    float d_alpha;              // 微分低通系数
+    float output_max;           // 输出上限
+    float output_min;           // 输出下限
+    float integral;             // 积分项（输出单位）
+    float d_term;               // 微分项（滤波后）
+    float last_setpoint;        // 上次设定值
+    float last_measurement;     // 上次测量值
+    float output;               // 上次输出（限幅后，不含前馈）
+    uint8_t initialized;        // 是否已有测量历史（微分用）
+} PID_t;
+
+// ==================== 函数声明 ====================
+/**
+ * @brief  PID控制器初始化（kd=0 即为PI控制器）
+ * @param  pid: 控制器指针
+ * @param  kp: 比例增益
+ * @param  ki: 积分增益（1/s）
+ * @param  kd: 微分增益（s）
+ * @param  dt: 采样周期（s）
+ * @param  output_max: 输出上限
+ * @param  output_min: 输出下限
+ * @retval 无
+ */
+void PID_Init(PID_t *pid, float kp, float ki, float kd, float dt,
+              float output_max, float output_min);
+
+/**
+ * @brief  PID控制器计算
+ * @param  pid: 控制器指针
+ * @param  setpoint: 设定值
+ * @param  measurement: 测量值
+ * @param  feedforward: 前馈量（与PID输出相加后整体限幅）
+ * @retval 控制器输出（含前馈，已限幅）
+ */
+float PID_Update(PID_t *pid, float setpoint, float measurement, float feedforward);
+
+/**
+ * @brief  报告下游实际执行的输出，用于反算抗饱和
+ * @note   在 PID_Update 之后、下一次 PID_Update 之前调用；
+ *         applied 与 PID_Update 返回值同单位（含前馈）
+ * @param  pid: 控制器指针
+ * @param  applied: 实际执行的输出
+ * @param  feedforward: 本周期前馈量
+ * @retval 无
+ */
+void PID_Saturation(PID_t *pid, float applied, float feedforward);
+
+/**
+ * @brief  修改增益（无扰：调整积分项使当前输出不变）
+ * @note   读改写积分项；控制器在中断中更新时，调用者须先屏蔽该中断
+ * @param  pid: 控制器指针
+ * @param  kp: 比例增益
+ * @param  ki: 积分增益（1/s）
+ * @param  kd: 微分增益（s）
+ * @retval 无
+ */
+void PID_SetGains(PID_t *pid, float kp, float ki, float kd);
+
+/**
+ * @brief  设置采样周期（增益为物理单位，改变调用频率无需重新整定）
+ * @param  pid: 控制器指针
+ * @param  dt: 采样周期（s）
+ * @retval 无
+ */
+void PID_SetDt(PID_t *pid, float dt);
+
+/**
+ * @brief  设置比例项设定值权重
+ * @note   b<1 时设定值阶跃的比例冲击减小，由积分项平滑接管
+ * @param  pid: 控制器指针
+ * @param  b: 权重（0-1）
+ * @retval 无
+ */
+void PID_SetWeight(PID_t *pid, float b);
+
+/**
+ * @brief  设置微分低通截止频率
+ * @param  pid: 控制器指针
+ * @param  cutoff: 截止频率（Hz）
+ * @retval 无
+ */
+void PID_SetDerivativeFilter(PID_t *pid, float cutoff);
+
+/**
+ * @brief  复位控制器
+ * @param  pid: 控制器指针
+ * @param  output: 积分项预置值（输出单位，0=清零）
+ * @retval 无
+ */
+void PID_Reset(PID_t *pid, float output);
+
+#endif
@@ -0,0 +1,260 @@
+#include "Traj.h"
+#include <math.h>
+
+/**
+ * @brief 轨迹状态（超前预测用）
+ */
+typedef struct {
+    float pos;
+    float vel;
+    float acc;
+} Traj_State_t;
+
+/**
+ * @brief  速度跟踪一步：加加速度受限地把速度带到 v_goal
+ * @note   把当前加速度以最大加加速度降到0期间速度还会变化 a·|a|/(2J)，
+ *         离散化后多出约半步；剩余速度差大于该值时加速度继续向限值靠拢，否则回零
+ * @param  tr: 轨迹发生器指针（只读限制参数）
+ * @param  v_goal: 目标速度
+ * @param  st: 状态，原地更新
+ */
+static void Traj_VelocityStep(const Traj_t *tr, float v_goal, Traj_State_t *st)
+{
+    float dt = tr->dt;
+    float jerk_step = tr->j_max * dt;
+    float dv = v_goal - st->vel;
+    float dv_stop = st->acc * fabsf(st->acc) / (2.0f * tr->j_max) + st->acc * dt * 0.5f;
+    float dir, limit, acc_target, acc, vel;
+    
+    if (dv > 0.0f) {
+        dir = 1.0f;
+    } else if (dv < 0.0f) {
+        dir = -1.0f;
+    } else {
+        dir = (st->acc > 0.0f) ? -1.0f : 1.0f;
+    }
+    
+    // 速度绝对值增大用加速限制，减小用减速限制
+    limit = (st->vel * dir >= 0.0f) ? tr->a_max : tr->d_max;
+    acc_target = (dir * (dv - dv_stop) > 0.0f) ? dir * limit : 0.0f;
+    
+    // 加速度按加加速度限制向目标靠拢
+    acc = acc_target - st->acc;
+    if (acc > jerk_step) {
+        acc = jerk_step;
+    } else if (acc < -jerk_step) {
+        acc = -jerk_step;
+    }
+    acc += st->acc;
+    vel = st->vel + (st->acc + acc) * 0.5f * dt;
+    
+    // 到达目标速度：剩余误差小于半步且加速度已降到一个加加速度步以内
+    if (fabsf(v_goal - vel) <= fabsf(acc) * dt * 0.5f && fabsf(st->acc) <= jerk_step) {
+        vel = v_goal;
+        acc = 0.0f;
+    }
+    
+    st->pos += (st->vel + vel) * 0.5f * dt;
+    st->vel = vel;
+    st->acc = acc;
+}
+
+/**
+ * @brief  以恒定加加速度推进一段时间，累加位移
+ */
+static float Traj_Phase(float *vel, float *acc, float jerk, float t)
+{
+    float s = (*vel) * t + (*acc) * t * t * 0.5f + jerk * t * t * t * (1.0f / 6.0f);
+    
+    *vel += (*acc) * t + jerk * t * t * 0.5f;
+    *acc += jerk * t;
+    return s;
+}
+
+/**
+ * @brief  从当前状态按减速限制停车的距离（带符号，与速度同向）
+ * @note   与 Traj_VelocityStep 目标为0时的行为一致：加速度以 -J 降到峰值减速度 -Ap，
+ *         恒减速（Ap 达到 d_max 时），再以 +J 回零；
+ *         Ap² = J·v + a²/2（无恒减速段时三角形曲线）
+ */
+static float Traj_StopDistance(const Traj_t *tr, const Traj_State_t *st)
+{
+    float dir = (st->vel >= 0.0f) ? 1.0f : -1.0f;
+    float vel = st->vel * dir;
+    float acc = st->acc * dir;
+    float j = tr->j_max;
+    float peak, t_const, s;
+    
+    if (vel == 0.0f && acc == 0.0f) {
+        return 0.0f;
+    }
+    
+    // 已在减速且回零过程中即可停住
+    if (acc < 0.0f && acc * acc >= 2.0f * j * vel) {
+        return dir * Traj_Phase(&vel, &acc, j, -acc / j);
+    }
+    
+    peak = sqrtf(j * vel + acc * acc * 0.5f);
+    t_const = 0.0f;
+    if (peak > tr->d_max) {
+        peak = tr->d_max;
+        t_const = (vel + acc * acc / (2.0f * j) - peak * peak / j) / peak;
+    }
+    
+    s = Traj_Phase(&vel, &acc, -j, (acc + peak) / j);
+    s += Traj_Phase(&vel, &acc, 0.0f, t_const);
+    s += Traj_Phase(&vel, &acc, j, peak / j);
+    return dir * s;
+}
+
+/**
+ * @brief  轨迹发生器初始化（速度模式，静止在0位置）
+ * @param  tr: 轨迹发生器指针
+ * @param  dt: 更新周期（s）
+ * @param  v_max: 最大速度
+ * @param  a_max: 最大加速度
+ * @param  d_max: 最大减速度
+ * @param  j_max: 最大加加速度
+ * @retval 无
+ */
+void Traj_Init(Traj_t *tr, float dt, float v_max, float a_max, float d_max, float j_max)
+{
+    tr->dt = dt;
+    tr->pos_tol = TRAJ_DEFAULT_POS_TOL;
+    tr->mode = TRAJ_MODE_VELOCITY;
+    tr->target_pos = 0.0f;
+    tr->target_vel = 0.0f;
+    Traj_SetLimits(tr, v_max, a_max, d_max, j_max);
+    Traj_Reset(tr, 0.0f, 0.0f);
+}
+
+/**
+ * @brief  修改运动限制（运动中修改立即生效）
+ * @param  tr: 轨迹发生器指针
+ * @param  v_max: 最大速度
+ * @param  a_max: 最大加速度
+ * @param  d_max: 最大减速度
+ * @param  j_max: 最大加加速度
+ * @retval 无
+ */
+void Traj_SetLimits(Traj_t *tr, float v_max, float a_max, float d_max, float j_max)
+{
+    tr->v_max = v_max;
+    tr->a_max = a_max;
+    tr->d_max = d_max;
+    tr->j_max = j_max;
+    
+    if (tr->target_vel > v_max) {
+        tr->target_vel = v_max;
+    } else if (tr->target_vel < -v_max) {
+        tr->target_vel = -v_max;
+    }
+}
+
+/**
+ * @brief  设置更新周期
+ * @param  tr: 轨迹发生器指针
+ * @param  dt: 更新周期（s）
+ * @retval 无
+ */
+void Traj_SetDt(Traj_t *tr, float dt)
+{
+    tr->dt = dt;
+}
+
+/**
+ * @brief  把轨迹状态设为实际状态（加速度清零），用于使能或切换时无扰起步
+ * @param  tr: 轨迹发生器指针
+ * @param  pos: 当前位置
+ * @param  vel: 当前速度
+ * @retval 无
+ */
+void Traj_Reset(Traj_t *tr, float pos, float vel)
+{
+    tr->pos = pos;
+    tr->vel = vel;
+    tr->acc = 0.0f;
+    tr->braking = 0;
+    tr->done = 0;
+}
+
+/**
+ * @brief  设置目标速度（切换到速度模式）
+ * @param  tr: 轨迹发生器指针
+ * @param  vel: 目标速度（限制在 ±v_max）
+ * @retval 无
+ */
+void Traj_SetVelocity(Traj_t *tr, float vel)
+{
+    if (vel > tr->v_max) {
+        vel = tr->v_max;
+    } else if (vel < -tr->v_max) {
+        vel = -tr->v_max;
+    }
+    tr->target_vel = vel;
+    tr->mode = TRAJ_MODE_VELOCITY;
+    tr->done = 0;
+}
+
+/**
+ * @brief  设置目标位置（切换到位置模式）
+ * @param  tr: 轨迹发生器指针
+ * @param  pos: 目标位置
+ * @retval 无
+ */
+void Traj_SetPosition(Traj_t *tr, float pos)
+{
+    tr->target_pos = pos;
+    tr->mode = TRAJ_MODE_POSITION;
+    tr->braking = 0;
+    tr->done = 0;
+}
+
+/**
+ * @brief  更新一个周期
+ * @param  tr: 轨迹发生器指针
+ * @retval 1: 已到达目标, 0: 运动中
+ */
+uint8_t Traj_Update(Traj_t *tr)
+{
+    Traj_State_t st;
+    float error, dir;
+    
+    st.pos = tr->pos;
+    st.vel = tr->vel;
+    st.acc = tr->acc;
+    
+    if (tr->mode == TRAJ_MODE_VELOCITY) {
+        Traj_VelocityStep(tr, tr->target_vel, &st);
+        tr->done = (st.vel == tr->target_vel);
+    } else if (!tr->done) {
+        error = tr->target_pos - st.pos;
+        dir = (error >= 0.0f) ? 1.0f : -1.0f;
+        
+        if (st.vel == 0.0f && st.acc == 0.0f) {
+            // 静止：误差在容差内即到位，否则开始下一段行程
+            if (fabsf(error) <= tr->pos_tol) {
+                tr->pos = tr->target_pos;
+                tr->done = 1;
+                return 1;
+            }
+            tr->braking = 0;
+        }
+        
+        if (!tr->braking) {
+            // 超前一步：继续加速一步后若停车距离已够到目标，则本周期开始停车
+            Traj_State_t next = st;
+            
+            Traj_VelocityStep(tr, dir * tr->v_max, &next);
+            if (dir * (next.pos + Traj_StopDistance(tr, &next) - tr->target_pos) >= 0.0f) {
+                tr->braking = 1;
+            }
+        }
+        Traj_VelocityStep(tr, tr->braking ? 0.0f : dir * tr->v_max, &st);
+    }
+    
+    tr->pos = st.pos;
+    tr->vel = st.vel;
+    tr->acc = st.acc;
+    return tr->done;
+}
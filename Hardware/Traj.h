@@ -0,0 +1,103 @@
+#ifndef __TRAJ_H
+#define __TRAJ_H
+
+#include <stdint.h>
+
+// ==================== 配置参数 ====================
+// 单位由调用者决定（FOC中位置为圈，速度 rev/s，加速度 rev/s²，加加速度 rev/s³）
+#define TRAJ_MODE_VELOCITY      0       // 速度模式：跟踪目标速度
+#define TRAJ_MODE_POSITION      1       // 位置模式：移动到目标位置并停止
+
+#define TRAJ_DEFAULT_POS_TOL    0.0001f // 位置模式到位容差（停止后误差小于此值直接对齐目标）
+
+// ==================== 数据结构 ====================
+/**
+ * @brief S曲线轨迹发生器结构体
+ * @note  每周期只根据当前状态（位置/速度/加速度）决定加加速度的方向，O(1)计算，
+ *        目标可以在运动中随时修改：
+ *        速度模式：预测把加速度降到0期间的速度增量，决定加速度继续增大还是回零；
+ *        位置模式：超前一步预测按最大减速度/加加速度停车的距离，
+ *        到达剩余距离时锁定减速，停车后余差由下一段短行程补足
+ */
+typedef struct {
+    float pos;                  // 位置输出
+    float vel;                  // 速度输出
+    float acc;                  // 加速度输出
+    float target_pos;           // 目标位置（位置模式）
+    float target_vel;           // 目标速度（速度模式）
+    float v_max;                // 最大速度
+    float a_max;                // 最大加速度（速度绝对值增大时）
+    float d_max;                // 最大减速度（速度绝对值减小时）
+    float j_max;                // 最大加加速度
+    float dt;                   // 更新周期（s）
+    float pos_tol;              // 位置模式到位容差
+    uint8_t mode;               // TRAJ_MODE_VELOCITY / TRAJ_MODE_POSITION
+    uint8_t braking;            // 位置模式：已进入停车段
+    uint8_t done;               // 1: 已到达目标（速度模式为目标速度，位置模式为目标位置且静止）
+} Traj_t;
+
+// ==================== 函数声明 ====================
+/**
+ * @brief  轨迹发生器初始化（速度模式，静止在0位置）
+ * @param  tr: 轨迹发生器指针
+ * @param  dt: 更新周期（s）
+ * @param  v_max: 最大速度
+ * @param  a_max: 最大加速度
+ * @param  d_max: 最大减速度
+ * @param  j_max: 最大加加速度
+ * @retval 无
+ */
+void Traj_Init(Traj_t *tr, float dt, float v_max, float a_max, float d_max, float j_max);
+
+/**
+ * @brief  修改运动限制（运动中修改立即生效）
+ * @param  tr: 轨迹发生器指针
+ * @param  v_max: 最大速度
+ * @param  a_max: 最大加速度
+ * @param  d_max: 最大减速度
+ * @param  j_max: 最大加加速度
+ * @retval 无
+ */
+void Traj_SetLimits(Traj_t *tr, float v_max, float a_max, float d_max, float j_max);
+
+/**
+ * @brief  设置更新周期
+ * @param  tr: 轨迹发生器指针
+ * @param  dt: 更新周期（s）
+ * @retval 无
+ */
+void Traj_SetDt(Traj_t *tr, float dt);
+
+/**
+ * @brief  把轨迹状态设为实际状态（加速度清零），用于使能或切换时无扰起步
+ * @param  tr: 轨迹发生器指针
+ * @param  pos: 当前位置
+ * @param  vel: 当前速度
+ * @retval 无
+ */
+void Traj_Reset(Traj_t *tr, float pos, float vel);
+
+/**
+ * @brief  设置目标速度（切换到速度模式）
+ * @param  tr: 轨迹发生器指针
+ * @param  vel: 目标速度（限制在 ±v_max）
+ * @retval 无
+ */
+void Traj_SetVelocity(Traj_t *tr, float vel);
+
+/**
+ * @brief  设置目标位置（切换到位置模式）
+ * @param  tr: 轨迹发生器指针
+ * @param  pos: 目标位置
+ * @retval 无
+ */
+void Traj_SetPosition(Traj_t *tr, float pos);
+
+/**
+ * @brief  更新一个周期
+ * @param  tr: 轨迹发生器指针
+ * @retval 1: 已到达目标, 0: 运动中
+ */
+uint8_t Traj_Update(Traj_t *tr);
+
+#endif
@@ -4,6 +4,11 @@
 // SysTick计数器
 volatile uint32_t systick_count = 0;
 
+// DWT周期计数器（CMSIS core_cm3.h 未定义DWT结构体）
+#define DWT_CTRL				(*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT				(*(volatile uint32_t *)0xE0001004)
+#define DWT_CTRL_CYCCNTENA		0x00000001
+
 /**
   * @brief  SysTick初始化
   * @param  无
@@ -65,3 +70,55 @@ uint32_t Delay_GetTick(void)
 	return systick_count;
 }
 
+
+/**
+  * @brief  获取系统时间戳（微秒）
+  * @note   由 SysTick 毫秒计数和当前计数值拼接而成，按 2^32 自然回绕，
+  *         可在中断中调用；依赖 Delay_Init() 的 1ms 配置，
+  *         调用 Delay_us() 会重装 SysTick，期间时间戳无效
+  * @param  无
+  * @retval 系统时间戳（us）
+  */
+uint32_t Delay_GetMicros(void)
+{
+	uint32_t ms, val, pending;
+	
+	do
+	{
+		ms = systick_count;
+		val = SysTick->VAL;
+		pending = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+	} while(ms != systick_count);
+	
+	// 在更高优先级中断中调用时，SysTick 可能已回绕但计数尚未递增
+	if(pending && val > (SysTick->LOAD >> 1))
+	{
+		ms++;
+	}
+	
+	return ms * 1000 + (SysTick->LOAD - val) / (SystemCoreClock / 1000000);
+}
+
+/**
+  * @brief  启动CPU周期计数器（DWT CYCCNT）
+  * @note   用于测量中断和算法耗时，不影响 SysTick
+  * @param  无
+  * @retval 无
+  */
+void Delay_CycleInit(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT_CYCCNT = 0;
+	DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+}
+
+/**
+  * @brief  获取CPU周期计数
+  * @note   72MHz下约60s回绕，两次读数相减即可得到间隔
+  * @param  无
+  * @retval 周期计数
+  */
+uint32_t Delay_GetCycles(void)
+{
+	return DWT_CYCCNT;
+}
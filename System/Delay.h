@@ -8,5 +8,8 @@ void Delay_us(uint32_t us);
 void Delay_ms(uint32_t ms);
 void Delay_s(uint32_t s);
 uint32_t Delay_GetTick(void);
+uint32_t Delay_GetMicros(void);
+void Delay_CycleInit(void);
+uint32_t Delay_GetCycles(void);
 
 #endif
@@ -4,6 +4,58 @@
 // 超时时间定义
 #define I2C_TIMEOUT  0xFFFF
 
+// 异步读取阶段
+#define ASYNC_PHASE_START_W  0   // 等待 START，随后发送写地址
+#define ASYNC_PHASE_ADDR_W   1   // 等待写地址应答，随后发送寄存器地址
+#define ASYNC_PHASE_REG      2   // 等待寄存器地址发送完成，随后重复 START
+#define ASYNC_PHASE_START_R  3   // 等待重复 START，随后启动 DMA 并发送读地址
+#define ASYNC_PHASE_DATA     4   // DMA 接收数据中
+
+/**
+  * @brief  I2C 总线硬件描述
+  */
+typedef struct {
+	I2C_TypeDef *i2c;                 // I2C 外设
+	DMA_Channel_TypeDef *dma_rx;      // 接收 DMA 通道
+	uint32_t dma_tc_flag;             // DMA 传输完成标志
+	uint32_t dma_clear;               // DMA 标志清除位
+	uint16_t gpio_pins;               // SCL | SDA 引脚（GPIOB）
+	uint32_t rcc_apb1;                // I2C 时钟
+	uint8_t ev_irq;                   // 事件中断号
+	uint8_t er_irq;                   // 错误中断号
+	uint8_t dma_irq;                  // DMA 中断号
+} MYI2C_BusHw_t;
+
+/**
+  * @brief  异步读取状态
+  */
+typedef struct {
+	volatile uint8_t state;           // MYI2C_ASYNC_xxx
+	uint8_t phase;                    // ASYNC_PHASE_xxx
+	uint8_t dev_addr;                 // 从设备地址
+	uint8_t reg_addr;                 // 寄存器地址
+	uint8_t *data;                    // 接收缓冲区
+	uint8_t len;                      // 接收长度
+} MYI2C_Async_t;
+
+static const MYI2C_BusHw_t bus_hw[MYI2C_BUS_NUM] = {
+	{I2C1, DMA1_Channel7, DMA_ISR_TCIF7, DMA_IFCR_CGIF7, GPIO_Pin_6 | GPIO_Pin_7,
+	 RCC_APB1Periph_I2C1, I2C1_EV_IRQn, I2C1_ER_IRQn, DMA1_Channel7_IRQn},
+	{I2C2, DMA1_Channel5, DMA_ISR_TCIF5, DMA_IFCR_CGIF5, GPIO_Pin_10 | GPIO_Pin_11,
+	 RCC_APB1Periph_I2C2, I2C2_EV_IRQn, I2C2_ER_IRQn, DMA1_Channel5_IRQn},
+};
+
+static MYI2C_Async_t bus_async[MYI2C_BUS_NUM];
+
+// ==================== 私有函数声明 ====================
+static uint8_t I2Cx_Start(I2C_TypeDef *I2Cx);
+static void I2Cx_Stop(I2C_TypeDef *I2Cx);
+static uint8_t I2Cx_SendAddress(I2C_TypeDef *I2Cx, uint8_t dev_addr, uint8_t direction);
+static uint8_t I2Cx_SendByte(I2C_TypeDef *I2Cx, uint8_t data);
+static uint8_t I2Cx_ReceiveByte(I2C_TypeDef *I2Cx, uint8_t *data, uint8_t ack);
+static uint8_t I2Cx_WaitBTF(I2C_TypeDef *I2Cx);
+static void I2Cx_FinishAsync(uint8_t bus, uint8_t state);
+
 /**
   * @brief  I2C 初始化函数
   * @note   使用 I2C1: PB6(SCL), PB7(SDA), 速率 400kHz
@@ -12,56 +64,102 @@
   */
 void MYI2C_Init(void)
 {
+	MYI2C_BusInit(MYI2C_BUS1);
+}
+
+/**
+  * @brief  I2C 软件复位（用于总线挂死恢复）
+  * @param  无
+  * @retval 无
+  */
+void MYI2C_Reset(void)
+{
+	MYI2C_BusReset(MYI2C_BUS1);
+}
+
+/**
+  * @brief  指定总线初始化
+  * @note   I2C1: PB6(SCL), PB7(SDA)；I2C2: PB10(SCL), PB11(SDA)；速率 400kHz
+  *         同时配置接收 DMA（I2C1: DMA1_CH7，I2C2: DMA1_CH5）和中断，供异步读取使用
+  * @param  bus: 总线编号（MYI2C_BUS1/MYI2C_BUS2）
+  * @retval 无
+  */
+void MYI2C_BusInit(uint8_t bus)
+{
+	const MYI2C_BusHw_t *hw = &bus_hw[bus];
+	
 	// 开启时钟
 	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB, ENABLE);
-	RCC_APB1PeriphClockCmd(RCC_APB1Periph_I2C1, ENABLE);
+	RCC_APB1PeriphClockCmd(hw->rcc_apb1, ENABLE);
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
 	
-	// 配置 GPIO：PB6(SCL), PB7(SDA) - 复用开漏输出
+	// 配置 GPIO：SCL, SDA - 复用开漏输出
 	GPIO_InitTypeDef GPIO_InitStruct;
 	GPIO_InitStruct.GPIO_Mode = GPIO_Mode_AF_OD;
-	GPIO_InitStruct.GPIO_Pin = GPIO_Pin_6 | GPIO_Pin_7;
+	GPIO_InitStruct.GPIO_Pin = hw->gpio_pins;
 	GPIO_InitStruct.GPIO_Speed = GPIO_Speed_50MHz;
 	GPIO_Init(GPIOB, &GPIO_InitStruct);
 	
-	// 配置 I2C1
+	// 配置 I2C
 	I2C_InitTypeDef I2C_InitStruct;
-	I2C_DeInit(I2C1);
+	I2C_DeInit(hw->i2c);
 	I2C_InitStruct.I2C_Mode = I2C_Mode_I2C;
 	I2C_InitStruct.I2C_DutyCycle = I2C_DutyCycle_2;           // 占空比 2:1
 	I2C_InitStruct.I2C_OwnAddress1 = 0x00;                     // 主机地址（任意）
 	I2C_InitStruct.I2C_Ack = I2C_Ack_Enable;                   // 使能应答
 	I2C_InitStruct.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
 	I2C_InitStruct.I2C_ClockSpeed = 400000;                    // 400kHz 快速模式
-	I2C_Init(I2C1, &I2C_InitStruct);
-	I2C_Cmd(I2C1, ENABLE);
+	I2C_Init(hw->i2c, &I2C_InitStruct);
+	I2C_Cmd(hw->i2c, ENABLE);
+	
+	// 配置接收 DMA：外设 → 内存，8位，内存地址自增，传输完成中断
+	hw->dma_rx->CCR = 0;
+	hw->dma_rx->CPAR = (uint32_t)&hw->i2c->DR;
+	hw->dma_rx->CCR = DMA_Priority_High | DMA_CCR1_MINC | DMA_CCR1_TCIE;
+	
+	// 配置 NVIC（低于控制中断，高于串口）
+	NVIC_InitTypeDef NVIC_InitStruct;
+	NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 2;
+	NVIC_InitStruct.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStruct.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_InitStruct.NVIC_IRQChannel = hw->ev_irq;
+	NVIC_Init(&NVIC_InitStruct);
+	NVIC_InitStruct.NVIC_IRQChannel = hw->er_irq;
+	NVIC_Init(&NVIC_InitStruct);
+	NVIC_InitStruct.NVIC_IRQChannel = hw->dma_irq;
+	NVIC_Init(&NVIC_InitStruct);
+	
+	bus_async[bus].state = MYI2C_ASYNC_IDLE;
 }
 
 /**
-  * @brief  I2C 软件复位（用于总线挂死恢复）
-  * @param  无
+  * @brief  指定总线软件复位（用于总线挂死恢复）
+  * @param  bus: 总线编号
   * @retval 无
   */
-void MYI2C_Reset(void)
+void MYI2C_BusReset(uint8_t bus)
 {
-	I2C_Cmd(I2C1, DISABLE);
-	I2C_SoftwareResetCmd(I2C1, ENABLE);
-	I2C_SoftwareResetCmd(I2C1, DISABLE);
-	I2C_Cmd(I2C1, ENABLE);
+	I2C_TypeDef *I2Cx = bus_hw[bus].i2c;
+	
+	I2C_Cmd(I2Cx, DISABLE);
+	I2C_SoftwareResetCmd(I2Cx, ENABLE);
+	I2C_SoftwareResetCmd(I2Cx, DISABLE);
+	I2C_Cmd(I2Cx, ENABLE);
 }
 
 // ==================== 底层操作函数 ====================
 
 /**
   * @brief  发送 START 信号
-  * @param  无
+  * @param  I2Cx: I2C 外设
   * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
   */
-uint8_t I2C_Start(void)
+static uint8_t I2Cx_Start(I2C_TypeDef *I2Cx)
 {
 	uint32_t timeout = I2C_TIMEOUT;
 	
-	I2C1->CR1 |= I2C_CR1_START;
-	while(!(I2C1->SR1 & I2C_SR1_SB))
+	I2Cx->CR1 |= I2C_CR1_START;
+	while(!(I2Cx->SR1 & I2C_SR1_SB))
 	{
 		if(--timeout == 0) return I2C_FAIL;
 	}
@@ -71,47 +169,49 @@ uint8_t I2C_Start(void)
 
 /**
   * @brief  发送 STOP 信号
-  * @param  无
+  * @param  I2Cx: I2C 外设
   * @retval 无
   */
-void I2C_Stop(void)
+static void I2Cx_Stop(I2C_TypeDef *I2Cx)
 {
-	I2C1->CR1 |= I2C_CR1_STOP;
+	I2Cx->CR1 |= I2C_CR1_STOP;
 }
 
 /**
   * @brief  发送设备地址
+  * @param  I2Cx: I2C 外设
   * @param  dev_addr: 从设备地址（7位，不含读写位）
   * @param  direction: 方向 (I2C_DIRECTION_WRITE 或 I2C_DIRECTION_READ)
   * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
   */
-uint8_t I2C_SendAddress(uint8_t dev_addr, uint8_t direction)
+static uint8_t I2Cx_SendAddress(I2C_TypeDef *I2Cx, uint8_t dev_addr, uint8_t direction)
 {
 	uint32_t timeout = I2C_TIMEOUT;
 	
-	I2C1->DR = (dev_addr << 1) | direction;
-	while(!(I2C1->SR1 & I2C_SR1_ADDR))
+	I2Cx->DR = (dev_addr << 1) | direction;
+	while(!(I2Cx->SR1 & I2C_SR1_ADDR))
 	{
 		if(--timeout == 0) return I2C_FAIL;
 	}
 	
 	// 清除 ADDR 标志（读 SR2 自动清除）
-	(void)I2C1->SR2;
+	(void)I2Cx->SR2;
 	
 	return I2C_SUCCESS;
 }
 
 /**
   * @brief  发送一个字节数据
+  * @param  I2Cx: I2C 外设
   * @param  data: 要发送的数据
   * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
   */
-uint8_t I2C_SendByte(uint8_t data)
+static uint8_t I2Cx_SendByte(I2C_TypeDef *I2Cx, uint8_t data)
 {
 	uint32_t timeout = I2C_TIMEOUT;
 	
-	I2C1->DR = data;
-	while(!(I2C1->SR1 & I2C_SR1_TXE))
+	I2Cx->DR = data;
+	while(!(I2Cx->SR1 & I2C_SR1_TXE))
 	{
 		if(--timeout == 0) return I2C_FAIL;
 	}
@@ -121,40 +221,41 @@ uint8_t I2C_SendByte(uint8_t data)
 
 /**
   * @brief  接收一个字节数据
+  * @param  I2Cx: I2C 外设
   * @param  data: 数据接收指针
   * @param  ack: 是否发送应答 (1: ACK, 0: NACK)
   * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
   */
-uint8_t I2C_ReceiveByte(uint8_t *data, uint8_t ack)
+static uint8_t I2Cx_ReceiveByte(I2C_TypeDef *I2Cx, uint8_t *data, uint8_t ack)
 {
 	uint32_t timeout = I2C_TIMEOUT;
 	
 	// 配置 ACK/NACK
 	if(ack)
-		I2C1->CR1 |= I2C_CR1_ACK;
+		I2Cx->CR1 |= I2C_CR1_ACK;
 	else
-		I2C1->CR1 &= ~I2C_CR1_ACK;
+		I2Cx->CR1 &= ~I2C_CR1_ACK;
 	
 	// 等待接收数据寄存器非空
-	while(!(I2C1->SR1 & I2C_SR1_RXNE))
+	while(!(I2Cx->SR1 & I2C_SR1_RXNE))
 	{
 		if(--timeout == 0) return I2C_FAIL;
 	}
 	
-	*data = I2C1->DR;
+	*data = I2Cx->DR;
 	return I2C_SUCCESS;
 }
 
 /**
   * @brief  等待字节传输完成
-  * @param  无
+  * @param  I2Cx: I2C 外设
   * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
   */
-uint8_t I2C_WaitBTF(void)
+static uint8_t I2Cx_WaitBTF(I2C_TypeDef *I2Cx)
 {
 	uint32_t timeout = I2C_TIMEOUT;
 	
-	while(!(I2C1->SR1 & I2C_SR1_BTF))
+	while(!(I2Cx->SR1 & I2C_SR1_BTF))
 	{
 		if(--timeout == 0) return I2C_FAIL;
 	}
@@ -162,105 +263,168 @@ uint8_t I2C_WaitBTF(void)
 	return I2C_SUCCESS;
 }
 
+/**
+  * @brief  发送 START 信号（I2C1）
+  * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
+  */
+uint8_t I2C_Start(void)
+{
+	return I2Cx_Start(I2C1);
+}
+
+/**
+  * @brief  发送 STOP 信号（I2C1）
+  * @retval 无
+  */
+void I2C_Stop(void)
+{
+	I2Cx_Stop(I2C1);
+}
+
+/**
+  * @brief  发送设备地址（I2C1）
+  * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
+  */
+uint8_t I2C_SendAddress(uint8_t dev_addr, uint8_t direction)
+{
+	return I2Cx_SendAddress(I2C1, dev_addr, direction);
+}
+
+/**
+  * @brief  发送一个字节数据（I2C1）
+  * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
+  */
+uint8_t I2C_SendByte(uint8_t data)
+{
+	return I2Cx_SendByte(I2C1, data);
+}
+
+/**
+  * @brief  接收一个字节数据（I2C1）
+  * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
+  */
+uint8_t I2C_ReceiveByte(uint8_t *data, uint8_t ack)
+{
+	return I2Cx_ReceiveByte(I2C1, data, ack);
+}
+
+/**
+  * @brief  等待字节传输完成（I2C1）
+  * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
+  */
+uint8_t I2C_WaitBTF(void)
+{
+	return I2Cx_WaitBTF(I2C1);
+}
+
 // ==================== 高层应用函数 ====================
 
 /**
-  * @brief  I2C 写入单个字节到指定寄存器
+  * @brief  指定总线写入单个字节到指定寄存器
+  * @param  bus: 总线编号
   * @param  dev_addr: 从设备地址（7位，不含读写位）
   * @param  reg_addr: 寄存器地址
   * @param  data: 要写入的数据
   * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
   */
-uint8_t I2C_WriteByte(uint8_t dev_addr, uint8_t reg_addr, uint8_t data)
+uint8_t I2C_BusWriteByte(uint8_t bus, uint8_t dev_addr, uint8_t reg_addr, uint8_t data)
 {
+	I2C_TypeDef *I2Cx = bus_hw[bus].i2c;
+	
 	// 1. 发送 START 信号
-	if(I2C_Start() != I2C_SUCCESS) return I2C_FAIL;
+	if(I2Cx_Start(I2Cx) != I2C_SUCCESS) return I2C_FAIL;
 	
 	// 2. 发送从设备地址（写模式）
-	if(I2C_SendAddress(dev_addr, I2C_DIRECTION_WRITE) != I2C_SUCCESS) return I2C_FAIL;
+	if(I2Cx_SendAddress(I2Cx, dev_addr, I2C_DIRECTION_WRITE) != I2C_SUCCESS) return I2C_FAIL;
 	
 	// 3. 发送寄存器地址
-	if(I2C_SendByte(reg_addr) != I2C_SUCCESS) return I2C_FAIL;
+	if(I2Cx_SendByte(I2Cx, reg_addr) != I2C_SUCCESS) return I2C_FAIL;
 	
 	// 4. 发送数据
-	if(I2C_SendByte(data) != I2C_SUCCESS) return I2C_FAIL;
+	if(I2Cx_SendByte(I2Cx, data) != I2C_SUCCESS) return I2C_FAIL;
 	
 	// 5. 等待字节传输完成
-	if(I2C_WaitBTF() != I2C_SUCCESS) return I2C_FAIL;
+	if(I2Cx_WaitBTF(I2Cx) != I2C_SUCCESS) return I2C_FAIL;
 	
 	// 6. 发送 STOP 信号
-	I2C_Stop();
+	I2Cx_Stop(I2Cx);
 	
 	return I2C_SUCCESS;
 }
 
 /**
-  * @brief  I2C 写入多个字节到指定寄存器
+  * @brief  指定总线写入多个字节到指定寄存器
+  * @param  bus: 总线编号
   * @param  dev_addr: 从设备地址（7位，不含读写位）
   * @param  reg_addr: 寄存器起始地址
   * @param  data: 要写入的数据缓冲区
   * @param  len: 数据长度
   * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
   */
-uint8_t I2C_Write(uint8_t dev_addr, uint8_t reg_addr, uint8_t *data, uint8_t len)
+uint8_t I2C_BusWrite(uint8_t bus, uint8_t dev_addr, uint8_t reg_addr, uint8_t *data, uint8_t len)
 {
+	I2C_TypeDef *I2Cx = bus_hw[bus].i2c;
+	
 	// 1. 发送 START 信号
-	if(I2C_Start() != I2C_SUCCESS) return I2C_FAIL;
+	if(I2Cx_Start(I2Cx) != I2C_SUCCESS) return I2C_FAIL;
 	
 	// 2. 发送从设备地址（写模式）
-	if(I2C_SendAddress(dev_addr, I2C_DIRECTION_WRITE) != I2C_SUCCESS) return I2C_FAIL;
+	if(I2Cx_SendAddress(I2Cx, dev_addr, I2C_DIRECTION_WRITE) != I2C_SUCCESS) return I2C_FAIL;
 	
 	// 3. 发送寄存器地址
-	if(I2C_SendByte(reg_addr) != I2C_SUCCESS) return I2C_FAIL;
+	if(I2Cx_SendByte(I2Cx, reg_addr) != I2C_SUCCESS) return I2C_FAIL;
 	
 	// 4. 等待寄存器地址传输完成
-	if(I2C_WaitBTF() != I2C_SUCCESS) return I2C_FAIL;
+	if(I2Cx_WaitBTF(I2Cx) != I2C_SUCCESS) return I2C_FAIL;
 	
 	// 5. 发送数据
 	for(uint8_t i = 0; i < len; i++)
 	{
-		if(I2C_SendByte(data[i]) != I2C_SUCCESS) return I2C_FAIL;
+		if(I2Cx_SendByte(I2Cx, data[i]) != I2C_SUCCESS) return I2C_FAIL;
 		
 		// 最后一个字节需要等待传输完成
 		if(i == len - 1)
 		{
-			if(I2C_WaitBTF() != I2C_SUCCESS) return I2C_FAIL;
+			if(I2Cx_WaitBTF(I2Cx) != I2C_SUCCESS) return I2C_FAIL;
 		}
 	}
 	
 	// 6. 发送 STOP 信号
-	I2C_Stop();
+	I2Cx_Stop(I2Cx);
 	
 	return I2C_SUCCESS;
 }
 
 /**
-  * @brief  I2C 从指定寄存器读取多个字节
+  * @brief  指定总线从指定寄存器读取多个字节
+  * @param  bus: 总线编号
   * @param  dev_addr: 从设备地址（7位，不含读写位）
   * @param  reg_addr: 寄存器起始地址
   * @param  data: 数据接收缓冲区
   * @param  len: 要读取的数据长度
   * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
   */
-uint8_t I2C_Read(uint8_t dev_addr, uint8_t reg_addr, uint8_t *data, uint8_t len)
+uint8_t I2C_BusRead(uint8_t bus, uint8_t dev_addr, uint8_t reg_addr, uint8_t *data, uint8_t len)
 {
+	I2C_TypeDef *I2Cx = bus_hw[bus].i2c;
+	
 	// 1. 发送 START 信号
-	if(I2C_Start() != I2C_SUCCESS) return I2C_FAIL;
+	if(I2Cx_Start(I2Cx) != I2C_SUCCESS) return I2C_FAIL;
 	
 	// 2. 发送从设备地址（写模式）- 先写寄存器地址
-	if(I2C_SendAddress(dev_addr, I2C_DIRECTION_WRITE) != I2C_SUCCESS) return I2C_FAIL;
+	if(I2Cx_SendAddress(I2Cx, dev_addr, I2C_DIRECTION_WRITE) != I2C_SUCCESS) return I2C_FAIL;
 	
 	// 3. 发送寄存器地址
-	if(I2C_SendByte(reg_addr) != I2C_SUCCESS) return I2C_FAIL;
+	if(I2Cx_SendByte(I2Cx, reg_addr) != I2C_SUCCESS) return I2C_FAIL;
 	
 	// 4. 等待寄存器地址完全发送
-	if(I2C_WaitBTF() != I2C_SUCCESS) return I2C_FAIL;
+	if(I2Cx_WaitBTF(I2Cx) != I2C_SUCCESS) return I2C_FAIL;
 	
 	// 5. 发送重复 START 条件（Repeated START）
-	if(I2C_Start() != I2C_SUCCESS) return I2C_FAIL;
+	if(I2Cx_Start(I2Cx) != I2C_SUCCESS) return I2C_FAIL;
 	
 	// 6. 发送从设备地址（读模式）
-	if(I2C_SendAddress(dev_addr, I2C_DIRECTION_READ) != I2C_SUCCESS) return I2C_FAIL;
+	if(I2Cx_SendAddress(I2Cx, dev_addr, I2C_DIRECTION_READ) != I2C_SUCCESS) return I2C_FAIL;
 	
 	// 7. 读取数据
 	for(uint8_t i = 0; i < len; i++)
@@ -268,29 +432,80 @@ uint8_t I2C_Read(uint8_t dev_addr, uint8_t reg_addr, uint8_t *data, uint8_t len)
 		if(i == len - 1)
 		{
 			// 最后一个字节：NACK + STOP
-			I2C_Stop();
-			if(I2C_ReceiveByte(&data[i], 0) != I2C_SUCCESS) return I2C_FAIL;
+			I2Cx_Stop(I2Cx);
+			if(I2Cx_ReceiveByte(I2Cx, &data[i], 0) != I2C_SUCCESS) return I2C_FAIL;
 		}
 		else if(i == len - 2)
 		{
 			// 倒数第二个字节：先读取，再配置 NACK
-			if(I2C_ReceiveByte(&data[i], 1) != I2C_SUCCESS) return I2C_FAIL;
+			if(I2Cx_ReceiveByte(I2Cx, &data[i], 1) != I2C_SUCCESS) return I2C_FAIL;
 		}
 		else
 		{
 			// 其他字节：ACK
-			if(I2C_ReceiveByte(&data[i], 1) != I2C_SUCCESS) return I2C_FAIL;
+			if(I2Cx_ReceiveByte(I2Cx, &data[i], 1) != I2C_SUCCESS) return I2C_FAIL;
 		}
 	}
 	
 	// 8. 重新启用 ACK（为下次通信做准备）
-	I2C1->CR1 |= I2C_CR1_ACK;
+	I2Cx->CR1 |= I2C_CR1_ACK;
 	
 	return I2C_SUCCESS;
 }
 
 /**
-  * @brief  I2C 读取单个字节（便捷函数）
+  * @brief  指定总线读取单个字节
+  * @param  bus: 总线编号
+  * @param  dev_addr: 从设备地址（7位，不含读写位）
+  * @param  reg_addr: 寄存器地址
+  * @param  data: 数据接收指针
+  * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
+  */
+uint8_t I2C_BusReadByte(uint8_t bus, uint8_t dev_addr, uint8_t reg_addr, uint8_t *data)
+{
+	return I2C_BusRead(bus, dev_addr, reg_addr, data, 1);
+}
+
+/**
+  * @brief  I2C 写入单个字节到指定寄存器（I2C1）
+  * @param  dev_addr: 从设备地址（7位，不含读写位）
+  * @param  reg_addr: 寄存器地址
+  * @param  data: 要写入的数据
+  * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
+  */
+uint8_t I2C_WriteByte(uint8_t dev_addr, uint8_t reg_addr, uint8_t data)
+{
+	return I2C_BusWriteByte(MYI2C_BUS1, dev_addr, reg_addr, data);
+}
+
+/**
+  * @brief  I2C 写入多个字节到指定寄存器（I2C1）
+  * @param  dev_addr: 从设备地址（7位，不含读写位）
+  * @param  reg_addr: 寄存器起始地址
+  * @param  data: 要写入的数据缓冲区
+  * @param  len: 数据长度
+  * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
+  */
+uint8_t I2C_Write(uint8_t dev_addr, uint8_t reg_addr, uint8_t *data, uint8_t len)
+{
+	return I2C_BusWrite(MYI2C_BUS1, dev_addr, reg_addr, data, len);
+}
+
+/**
+  * @brief  I2C 从指定寄存器读取多个字节（I2C1）
+  * @param  dev_addr: 从设备地址（7位，不含读写位）
+  * @param  reg_addr: 寄存器起始地址
+  * @param  data: 数据接收缓冲区
+  * @param  len: 要读取的数据长度
+  * @retval I2C_SUCCESS(1) 或 I2C_FAIL(0)
+  */
+uint8_t I2C_Read(uint8_t dev_addr, uint8_t reg_addr, uint8_t *data, uint8_t len)
+{
+	return I2C_BusRead(MYI2C_BUS1, dev_addr, reg_addr, data, len);
+}
+
+/**
+  * @brief  I2C 读取单个字节（便捷函数，I2C1）
   * @param  dev_addr: 从设备地址（7位，不含读写位）
   * @param  reg_addr: 寄存器地址
   * @param  data: 数据接收指针
@@ -301,3 +516,165 @@ uint8_t I2C_ReadByte(uint8_t dev_addr, uint8_t reg_addr, uint8_t *data)
 	return I2C_Read(dev_addr, reg_addr, data, 1);
 }
 
+// ==================== 异步读取（中断 + DMA） ====================
+
+/**
+  * @brief  结束异步读取
+  * @note   关闭中断和 DMA 请求，恢复 ACK，供阻塞函数继续使用该总线
+  * @param  bus: 总线编号
+  * @param  state: 结束状态（MYI2C_ASYNC_DONE/MYI2C_ASYNC_ERROR/MYI2C_ASYNC_IDLE）
+  * @retval 无
+  */
+static void I2Cx_FinishAsync(uint8_t bus, uint8_t state)
+{
+	const MYI2C_BusHw_t *hw = &bus_hw[bus];
+	
+	hw->dma_rx->CCR &= ~DMA_CCR1_EN;
+	DMA1->IFCR = hw->dma_clear;
+	hw->i2c->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITERREN | I2C_CR2_DMAEN | I2C_CR2_LAST);
+	hw->i2c->CR1 |= I2C_CR1_ACK;
+	
+	bus_async[bus].state = state;
+}
+
+/**
+  * @brief  启动异步读取
+  * @note   START/地址/寄存器阶段由事件中断推进，数据由 DMA 接收，
+  *         DMA 的 LAST 位使最后一个字节自动回 NACK，传输完成中断中发送 STOP；
+  *         两条总线可同时进行，总耗时约等于单条总线一次读取
+  * @param  bus: 总线编号
+  * @param  dev_addr: 从设备地址（7位，不含读写位）
+  * @param  reg_addr: 寄存器起始地址
+  * @param  data: 数据接收缓冲区（传输完成前必须保持有效）
+  * @param  len: 要读取的数据长度（>= 2）
+  * @retval I2C_SUCCESS(1): 已启动, I2C_FAIL(0): 总线忙或参数错误
+  */
+uint8_t I2C_BusReadAsync(uint8_t bus, uint8_t dev_addr, uint8_t reg_addr, uint8_t *data, uint8_t len)
+{
+	const MYI2C_BusHw_t *hw = &bus_hw[bus];
+	MYI2C_Async_t *async = &bus_async[bus];
+	
+	if(len < 2 || async->state == MYI2C_ASYNC_BUSY) return I2C_FAIL;
+	if(hw->i2c->SR2 & I2C_SR2_BUSY) return I2C_FAIL;
+	
+	async->dev_addr = dev_addr;
+	async->reg_addr = reg_addr;
+	async->data = data;
+	async->len = len;
+	async->phase = ASYNC_PHASE_START_W;
+	async->state = MYI2C_ASYNC_BUSY;
+	
+	hw->i2c->CR2 |= I2C_CR2_ITEVTEN | I2C_CR2_ITERREN;
+	hw->i2c->CR1 |= I2C_CR1_START;
+	
+	return I2C_SUCCESS;
+}
+
+/**
+  * @brief  查询异步读取状态
+  * @param  bus: 总线编号
+  * @retval MYI2C_ASYNC_IDLE/BUSY/DONE/ERROR
+  */
+uint8_t I2C_BusGetAsyncState(uint8_t bus)
+{
+	return bus_async[bus].state;
+}
+
+/**
+  * @brief  中止异步读取（超时处理）
+  * @param  bus: 总线编号
+  * @retval 无
+  */
+void I2C_BusAbortAsync(uint8_t bus)
+{
+	I2Cx_FinishAsync(bus, MYI2C_ASYNC_IDLE);
+	I2Cx_Stop(bus_hw[bus].i2c);
+	MYI2C_BusReset(bus);
+}
+
+/**
+  * @brief  事件中断处理
+  * @param  bus: 总线编号
+  * @retval 无
+  */
+void MYI2C_EV_IRQHandler(uint8_t bus)
+{
+	const MYI2C_BusHw_t *hw = &bus_hw[bus];
+	MYI2C_Async_t *async = &bus_async[bus];
+	I2C_TypeDef *I2Cx = hw->i2c;
+	uint16_t sr1 = I2Cx->SR1;
+	
+	if(sr1 & I2C_SR1_SB)
+	{
+		if(async->phase == ASYNC_PHASE_START_W)
+		{
+			// EV5：发送写地址
+			I2Cx->DR = (async->dev_addr << 1) | I2C_DIRECTION_WRITE;
+			async->phase = ASYNC_PHASE_ADDR_W;
+		}
+		else
+		{
+			// 重复 START 后：先准备 DMA，再发送读地址
+			hw->dma_rx->CMAR = (uint32_t)async->data;
+			hw->dma_rx->CNDTR = async->len;
+			hw->dma_rx->CCR |= DMA_CCR1_EN;
+			I2Cx->CR2 |= I2C_CR2_DMAEN | I2C_CR2_LAST;
+			I2Cx->DR = (async->dev_addr << 1) | I2C_DIRECTION_READ;
+			async->phase = ASYNC_PHASE_DATA;
+		}
+	}
+	else if(sr1 & I2C_SR1_ADDR)
+	{
+		// EV6：读 SR2 清除 ADDR
+		(void)I2Cx->SR2;
+		
+		if(async->phase == ASYNC_PHASE_ADDR_W)
+		{
+			I2Cx->DR = async->reg_addr;
+			async->phase = ASYNC_PHASE_REG;
+		}
+	}
+	else if(sr1 & I2C_SR1_BTF)
+	{
+		if(async->phase == ASYNC_PHASE_REG)
+		{
+			// 寄存器地址发送完成：先读 DR 清除 BTF（SR1 已在入口读过），再重复 START；
+			// 只置 START 时 BTF 要等 START 实际产生后才由硬件清除，期间事件中断会反复进入
+			(void)I2Cx->DR;
+			I2Cx->CR1 |= I2C_CR1_START;
+			async->phase = ASYNC_PHASE_START_R;
+		}
+	}
+}
+
+/**
+  * @brief  错误中断处理
+  * @param  bus: 总线编号
+  * @retval 无
+  */
+void MYI2C_ER_IRQHandler(uint8_t bus)
+{
+	I2C_TypeDef *I2Cx = bus_hw[bus].i2c;
+	
+	// 清除错误标志（NACK、仲裁丢失、总线错误、溢出、超时）
+	I2Cx->SR1 &= ~(I2C_SR1_AF | I2C_SR1_ARLO | I2C_SR1_BERR | I2C_SR1_OVR | I2C_SR1_TIMEOUT);
+	I2Cx_Stop(I2Cx);
+	
+	I2Cx_FinishAsync(bus, MYI2C_ASYNC_ERROR);
+}
+
+/**
+  * @brief  DMA 接收完成中断处理
+  * @param  bus: 总线编号
+  * @retval 无
+  */
+void MYI2C_DMA_IRQHandler(uint8_t bus)
+{
+	const MYI2C_BusHw_t *hw = &bus_hw[bus];
+	
+	if(DMA1->ISR & hw->dma_tc_flag)
+	{
+		I2Cx_Stop(hw->i2c);
+		I2Cx_FinishAsync(bus, MYI2C_ASYNC_DONE);
+	}
+}
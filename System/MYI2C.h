@@ -11,14 +11,31 @@
 #define I2C_DIRECTION_WRITE  0
 #define I2C_DIRECTION_READ   1
 
+// I2C 总线编号
+#define MYI2C_BUS1           0   // I2C1: PB6(SCL), PB7(SDA)
+#define MYI2C_BUS2           1   // I2C2: PB10(SCL), PB11(SDA)
+#define MYI2C_BUS_NUM        2
+
+// 异步读取状态
+#define MYI2C_ASYNC_IDLE     0   // 空闲
+#define MYI2C_ASYNC_BUSY     1   // 传输中
+#define MYI2C_ASYNC_DONE     2   // 完成
+#define MYI2C_ASYNC_ERROR    3   // 出错（NACK、仲裁丢失、总线错误）
+
 // ==================== 初始化与复位 ====================
-// I2C 初始化
+// I2C 初始化（I2C1）
 void MYI2C_Init(void);
 
-// I2C 软件复位
+// I2C 软件复位（I2C1）
 void MYI2C_Reset(void);
 
-// ==================== 底层操作函数 ====================
+// 指定总线初始化（含异步读取所需的中断和 DMA）
+void MYI2C_BusInit(uint8_t bus);
+
+// 指定总线软件复位
+void MYI2C_BusReset(uint8_t bus);
+
+// ==================== 底层操作函数（I2C1） ====================
 // 发送 START 信号
 uint8_t I2C_Start(void);
 
@@ -37,7 +54,7 @@ uint8_t I2C_ReceiveByte(uint8_t *data, uint8_t ack);
 // 等待字节传输完成
 uint8_t I2C_WaitBTF(void);
 
-// ==================== 高层应用函数 ====================
+// ==================== 高层应用函数（I2C1） ====================
 // I2C 写入单个字节到指定寄存器
 uint8_t I2C_WriteByte(uint8_t dev_addr, uint8_t reg_addr, uint8_t data);
 
@@ -50,4 +67,36 @@ uint8_t I2C_Read(uint8_t dev_addr, uint8_t reg_addr, uint8_t *data, uint8_t len)
 // I2C 读取单个字节（便捷函数）
 uint8_t I2C_ReadByte(uint8_t dev_addr, uint8_t reg_addr, uint8_t *data);
 
+// ==================== 多总线函数 ====================
+// 指定总线写入单个字节到指定寄存器
+uint8_t I2C_BusWriteByte(uint8_t bus, uint8_t dev_addr, uint8_t reg_addr, uint8_t data);
+
+// 指定总线写入多个字节到指定寄存器
+uint8_t I2C_BusWrite(uint8_t bus, uint8_t dev_addr, uint8_t reg_addr, uint8_t *data, uint8_t len);
+
+// 指定总线从指定寄存器读取多个字节
+uint8_t I2C_BusRead(uint8_t bus, uint8_t dev_addr, uint8_t reg_addr, uint8_t *data, uint8_t len);
+
+// 指定总线读取单个字节
+uint8_t I2C_BusReadByte(uint8_t bus, uint8_t dev_addr, uint8_t reg_addr, uint8_t *data);
+
+// ==================== 异步读取（中断 + DMA） ====================
+// 启动异步读取（len >= 2），立即返回，多条总线可同时进行
+uint8_t I2C_BusReadAsync(uint8_t bus, uint8_t dev_addr, uint8_t reg_addr, uint8_t *data, uint8_t len);
+
+// 查询异步读取状态
+uint8_t I2C_BusGetAsyncState(uint8_t bus);
+
+// 中止异步读取（超时处理）
+void I2C_BusAbortAsync(uint8_t bus);
+
+// 事件中断处理（在 I2Cx_EV_IRQHandler 中调用）
+void MYI2C_EV_IRQHandler(uint8_t bus);
+
+// 错误中断处理（在 I2Cx_ER_IRQHandler 中调用）
+void MYI2C_ER_IRQHandler(uint8_t bus);
+
+// DMA 接收完成中断处理（在 DMA1_Channel7/5_IRQHandler 中调用）
+void MYI2C_DMA_IRQHandler(uint8_t bus);
+
 #endif
@@ -0,0 +1,147 @@
+#include "Param.h"
+#include "stm32f10x.h"
+
+#define PARAM_WORDS   ((sizeof(Param_t) - sizeof(uint32_t)) / sizeof(uint32_t))  // CRC覆盖的字数
+
+static Param_t param;
+
+// ==================== 私有函数声明 ====================
+static uint32_t Param_CalcCRC(const Param_t *p);
+
+/**
+  * @brief  计算参数CRC32
+  * @note   硬件CRC单元（多项式 0x04C11DB7），按字计算，不含 crc 字段本身
+  * @param  p: 参数指针
+  * @retval CRC值
+  */
+static uint32_t Param_CalcCRC(const Param_t *p)
+{
+	CRC_ResetDR();
+	return CRC_CalcBlockCRC((uint32_t *)p, PARAM_WORDS);
+}
+
+/**
+  * @brief  参数初始化
+  * @param  无
+  * @retval PARAM_OK: 读取成功, PARAM_FAIL: 使用默认值
+  */
+uint8_t Param_Init(void)
+{
+	const Param_t *stored = (const Param_t *)PARAM_FLASH_ADDR;
+	
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_CRC, ENABLE);
+	
+	if (stored->magic == PARAM_MAGIC && stored->version == PARAM_VERSION &&
+		stored->size == sizeof(Param_t) && stored->crc == Param_CalcCRC(stored))
+	{
+		param = *stored;
+		return PARAM_OK;
+	}
+	
+	Param_SetDefault();
+	return PARAM_FAIL;
+}
+
+/**
+  * @brief  获取参数
+  * @param  无
+  * @retval 参数指针
+  */
+Param_t* Param_Get(void)
+{
+	return &param;
+}
+
+/**
+  * @brief  恢复默认参数
+  * @param  无
+  * @retval 无
+  */
+void Param_SetDefault(void)
+{
+	uint8_t i, j;
+	
+	param.magic = PARAM_MAGIC;
+	param.version = PARAM_VERSION;
+	param.size = sizeof(Param_t);
+	
+	for (i = 0; i < 3; i++)
+	{
+		param.current_offset[i] = 2048;
+		param.current_gain[i] = 1.0f;
+	}
+	param.current_calibrated = 0;
+	
+	param.speed_tuned = 0;
+	param.reserved = 0;
+	for (i = 0; i < 2; i++)
+	{
+		param.speed_kp[i] = 0.0f;
+		param.speed_ki[i] = 0.0f;
+		param.sched_count[i] = 0;
+		for (j = 0; j < PARAM_SCHED_POINTS; j++)
+		{
+			param.sched_speed[i][j] = 0.0f;
+			param.sched_kp[i][j] = 0.0f;
+			param.sched_ki[i][j] = 0.0f;
+		}
+	}
+	param.sched_reserved = 0;
+	
+	param.motor_identified = 0;
+	param.motor_reserved = 0;
+	param.motor_rs = 0.0f;
+	param.motor_ld = 0.0f;
+	param.motor_lq = 0.0f;
+	param.motor_flux = 0.0f;
+	param.motor_inertia = 0.0f;
+	param.motor_friction = 0.0f;
+	
+	param.angle_calibrated = 0;
+	param.angle_offset = 0;
+}
+
+/**
+  * @brief  保存参数到Flash
+  * @param  无
+  * @retval PARAM_OK: 写入并回读校验成功, PARAM_FAIL: 失败
+  */
+uint8_t Param_Save(void)
+{
+	const uint32_t *src = (const uint32_t *)&param;
+	uint32_t addr = PARAM_FLASH_ADDR;
+	uint8_t result = PARAM_OK;
+	uint16_t i;
+	
+	param.magic = PARAM_MAGIC;
+	param.version = PARAM_VERSION;
+	param.size = sizeof(Param_t);
+	param.crc = Param_CalcCRC(&param);
+	
+	FLASH_Unlock();
+	FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_PGERR | FLASH_FLAG_WRPRTERR);
+	
+	if (FLASH_ErasePage(PARAM_FLASH_ADDR) != FLASH_COMPLETE)
+	{
+		result = PARAM_FAIL;
+	}
+	
+	for (i = 0; i < sizeof(Param_t) / sizeof(uint32_t) && result == PARAM_OK; i++)
+	{
+		if (FLASH_ProgramWord(addr, src[i]) != FLASH_COMPLETE)
+		{
+			result = PARAM_FAIL;
+		}
+		addr += 4;
+	}
+	
+	FLASH_Lock();
+	
+	// 回读校验
+	if (result == PARAM_OK && ((const Param_t *)PARAM_FLASH_ADDR)->crc != Param_CalcCRC((const Param_t *)PARAM_FLASH_ADDR))
+	{
+		result = PARAM_FAIL;
+	}
+	
+	return result;
+}
@@ -0,0 +1,94 @@
+#ifndef __PARAM_H
+#define __PARAM_H
+
+#include <stdint.h>
+
+// ==================== 存储配置 ====================
+// STM32F103C8：64KB Flash，页大小1KB，参数占用最后一页（工程 IROM1 大小设为 0xFC00，链接器不会占用该页）
+#define PARAM_FLASH_ADDR     0x0800FC00
+#define PARAM_PAGE_SIZE      1024
+
+#define PARAM_MAGIC          0x4D524150  // "PARM"
+#define PARAM_SCHED_POINTS   4           // 增益调度表断点数（不超过 FOC_GAIN_POINTS）
+#define PARAM_VERSION        5           // 结构体布局变化时加1，旧版本数据按默认值处理
+
+// 操作返回值定义
+#define PARAM_OK             1
+#define PARAM_FAIL           0
+
+// ==================== 数据结构 ====================
+/**
+  * @brief  持久化参数（按字对齐，整体做CRC校验）
+  */
+typedef struct {
+	uint32_t magic;                   // PARAM_MAGIC
+	uint16_t version;                 // PARAM_VERSION
+	uint16_t size;                    // sizeof(Param_t)
+	
+	// 电流采样校准
+	uint16_t current_offset[3];       // 零电流偏置（计数）
+	uint16_t current_calibrated;      // 1: 偏置已校准
+	float current_gain[3];            // 各通道增益修正（相对A相）
+	
+	// 速度环自整定结果（[0] 电压输出，[1] 电流输出）
+	uint16_t speed_tuned;             // bit0/bit1: 对应一组增益已整定
+	uint16_t reserved;                // 保留（字对齐）
+	float speed_kp[2];                // 速度环比例增益
+	float speed_ki[2];                // 速度环积分增益（1/s）
+	
+	// 速度环增益调度表（[0] 电压输出，[1] 电流输出），点数为0时使用上面的固定增益
+	uint8_t sched_count[2];           // 断点数（0 或 2 ~ PARAM_SCHED_POINTS）
+	uint16_t sched_reserved;          // 保留（字对齐）
+	float sched_speed[2][PARAM_SCHED_POINTS];  // 断点转速（RPM，严格升序）
+	float sched_kp[2][PARAM_SCHED_POINTS];     // 断点比例增益
+	float sched_ki[2][PARAM_SCHED_POINTS];     // 断点积分增益（1/s）
+	
+	// 电机参数辨识结果
+	uint16_t motor_identified;        // 已辨识的项（MOTORID_x_OK 组合），对应字段有效
+	uint16_t motor_reserved;          // 保留（字对齐）
+	float motor_rs;                   // 相电阻（Ω）
+	float motor_ld;                   // d轴电感（H）
+	float motor_lq;                   // q轴电感（H）
+	float motor_flux;                 // 永磁磁链（V·s/rad）
+	float motor_inertia;              // 转动惯量（kg·m²）
+	float motor_friction;             // 粘滞摩擦系数（N·m·s/rad）
+	
+	// 位置传感器电角度零点
+	uint16_t angle_calibrated;        // 1: 零点已标定
+	uint16_t angle_offset;            // 转子d轴对齐A相轴时的位置角度（0-4095）
+	
+	uint32_t crc;                     // 以上所有字的CRC32（硬件CRC单元），必须放在最后
+} Param_t;
+
+// ==================== 函数声明 ====================
+/**
+  * @brief  参数初始化
+  * @note   从Flash读取参数，校验失败（未写过、版本不符、CRC错误）时加载默认值
+  * @param  无
+  * @retval PARAM_OK: 读取成功, PARAM_FAIL: 使用默认值
+  */
+uint8_t Param_Init(void);
+
+/**
+  * @brief  获取参数（RAM副本，修改后调用 Param_Save 写入Flash）
+  * @param  无
+  * @retval 参数指针
+  */
+Param_t* Param_Get(void);
+
+/**
+  * @brief  恢复默认参数（只修改RAM副本）
+  * @param  无
+  * @retval 无
+  */
+void Param_SetDefault(void);
+
+/**
+  * @brief  保存参数到Flash
+  * @note   擦除整页约20ms，期间CPU取指停顿、中断无法响应，只能在电机停止时调用
+  * @param  无
+  * @retval PARAM_OK: 写入并回读校验成功, PARAM_FAIL: 失败
+  */
+uint8_t Param_Save(void);
+
+#endif
@@ -0,0 +1,279 @@
+/**
+ * 死区补偿主机仿真（逆变器 + 电机模型）
+ *
+ * 固件的 FOC_SVPWM_Generate（含 FOC_DeadTime_Compensate 和采样窗口）在PC上运行，
+ * 外设寄存器映射为主机内存（见 HostPeriph.h），从TIM2比较寄存器读出每个PWM周期实际写入的占空比。
+ * 逆变器按开关沿建模：高边指令上升沿和下降沿分别经过死区、开通/关断传播延迟，
+ * 电流流出时死区内由下管续流（相电压为0），流入时由上管续流（相电压为母线电压）；
+ * 小电流时开关节点电容来不及在死区内充放电，误差按 |i| / SIM_I_CAP 线性减小；
+ * 脉宽不足时脉冲消失。相电压平均值驱动星形连接的 R-L-反电势 电机模型，转子匀速旋转。
+ *
+ * 电压模式开环（与固件电压模式相同：电压矢量沿q轴），按电频率和补偿方式输出：
+ * iq 平均值、iq 的6次谐波幅值（转矩脉动的主要成分）、iq 峰峰值、相电流THD（2-25次）、
+ * 相电压基波幅值相对指令的误差。补偿方式：理想逆变器（无死区，参考）、不补偿、
+ * 按电压矢量估计电流方向补偿、按实测相电流补偿（每周期把模型电流作为采样值输入）。
+ * 模型无随机量，结果可复现。
+ *
+ * 编译运行（仓库根目录）：
+ *   gcc -std=gnu99 -O2 -w -DUSE_STDPERIPH_DRIVER -DSTM32F10X_MD \
+ *       "-D__weak=__attribute__((weak))" -IStart -ILibrary -IUser -ISystem -IHardware -ITest \
+ *       Test/DeadTime_Test.c Test/HostPeriph.c Hardware/FOC.c Hardware/ADC.c Hardware/MS8313.c \
+ *       Hardware/PID.c Hardware/Traj.c Library/misc.c Library/stm32f10x_tim.c \
+ *       Library/stm32f10x_adc.c Library/stm32f10x_gpio.c Library/stm32f10x_rcc.c \
+ *       Library/stm32f10x_dma.c -lm -o deadtime_test
+ *   ./deadtime_test
+ * 返回值：任一电频率下实测电流补偿未把 iq 6次谐波降到不补偿时的 1/SIM_MIN_REDUCTION 以下时为1
+ */
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "stm32f10x.h"
+#include "HostPeriph.h"
+#include "FOC.h"
+#include "ADC.h"
+#include "MS8313.h"
+
+// ==================== 仿真参数 ====================
+#define SIM_VBUS            12.0f   // 母线电压（V）
+#define SIM_RS              1.0f    // 相电阻（Ω）
+#define SIM_LS              0.0005f // 相电感（H）
+#define SIM_FLUX            0.005f  // 永磁磁链（V·s/rad）
+#define SIM_IQ              1.0f    // 目标q轴电流（A），电压指令按稳态 Rs·iq + ω·λ 给出
+#define SIM_DEADTIME_NS     300.0   // 逆变器实际死区（ns）
+#define SIM_TON_NS          150.0   // 实际开通延迟（ns）
+#define SIM_TOFF_NS         100.0   // 实际关断延迟（ns）
+#define SIM_I_CAP           0.05    // 死区内能完成开关节点充放电的电流（A）
+#define SIM_SETTLE_CYCLES   2       // 稳定电周期数
+#define SIM_MEASURE_CYCLES  4       // 统计电周期数
+#define SIM_HARMONICS       25      // THD计算的最高次谐波
+#define SIM_MAX_PER_CYCLE   20000   // 每电周期最多PWM周期数（电频率下限 = PWM频率 / 此值）
+#define SIM_MIN_REDUCTION   3.0     // 实测电流补偿对6次谐波的最小抑制倍数
+
+static const float sim_freq[] = {2.0f, 5.0f, 20.0f};    // 电频率（Hz）
+#define SIM_FREQ_NUM        (sizeof(sim_freq) / sizeof(sim_freq[0]))
+
+/**
+ * @brief  补偿方式
+ */
+typedef enum {
+    SIM_IDEAL = 0,          // 理想逆变器
+    SIM_OFF,                // 不补偿
+    SIM_ESTIMATED,          // 按电压矢量估计电流方向
+    SIM_MEASURED,           // 按实测相电流
+    SIM_MODE_NUM
+} Sim_Mode_t;
+
+static const char *sim_mode_name[SIM_MODE_NUM] = {"ideal", "off", "estimated", "measured"};
+
+/**
+ * @brief  统计结果
+ */
+typedef struct {
+    double iq_mean;         // iq 平均值（A）
+    double iq_h6;           // iq 6次谐波幅值（A）
+    double iq_pp;           // iq 峰峰值（A）
+    double thd;             // A相电流THD
+    double v1_err;          // 相电压基波幅值相对指令的误差
+} Sim_Result_t;
+
+// ==================== 固件依赖的桩函数 ====================
+float AS5600_GetTotalAngle(void)
+{
+    return 0.0f;
+}
+
+uint32_t Delay_GetTick(void)
+{
+    return 0;
+}
+
+// ==================== 仿真函数 ====================
+
+/**
+ * @brief  一相一个PWM周期的平均相电压（对地）
+ * @note   中心对齐：指令高电平 2·duty 个计数居中于峰值；
+ *         电流流出：上升沿推迟 死区+开通延迟，下降沿推迟 关断延迟；流入时相反
+ * @param  duty: 比较寄存器对应的占空比（计数）
+ * @param  period: 周期值
+ * @param  current: 相电流（A，流出为正）
+ * @param  ideal: 1 = 理想逆变器
+ */
+static double Sim_PhaseVoltage(int32_t duty, int32_t period, double current, uint8_t ideal)
+{
+    double t_period = 2.0 * period / MS8313_TIM_CLOCK;     // PWM周期（s）
+    double t_high = 2.0 * duty / MS8313_TIM_CLOCK;
+    double t_err = (SIM_DEADTIME_NS + SIM_TON_NS - SIM_TOFF_NS) * 1e-9;
+    double s;
+    
+    if (!ideal && duty > 0 && duty < period) {
+        // 小电流时误差按电流线性过渡
+        s = current / SIM_I_CAP;
+        if (s > 1.0) s = 1.0;
+        if (s < -1.0) s = -1.0;
+        t_high -= s * t_err;
+        if (t_high < 0.0) t_high = 0.0;
+        if (t_high > t_period) t_high = t_period;
+    }
+    return SIM_VBUS * t_high / t_period;
+}
+
+/**
+ * @brief  单频DFT幅值
+ * @param  x: 采样序列
+ * @param  n: 采样点数
+ * @param  bin: 频率（整数个周期/序列长度）
+ */
+static double Sim_Dft(const float *x, uint32_t n, uint32_t bin)
+{
+    double re = 0.0, im = 0.0;
+    uint32_t k;
+    
+    for (k = 0; k < n; k++) {
+        double w = 2.0 * PI * (double)bin * k / n;
+        re += x[k] * cos(w);
+        im -= x[k] * sin(w);
+    }
+    return 2.0 * sqrt(re * re + im * im) / n;
+}
+
+/**
+ * @brief  一个工作点：电压模式开环运行，统计电流和转矩脉动
+ * @param  freq: 电频率（Hz）
+ * @param  mode: 补偿方式
+ * @param  res: 结果（输出）
+ */
+static void Sim_Run(float freq, Sim_Mode_t mode, Sim_Result_t *res)
+{
+    const MS8313_Timing_t *timing = MS8313_GetTiming();
+    int32_t period = timing->period;
+    double ts = 1.0 / timing->pwm_freq;
+    double omega = 2.0 * PI * freq;
+    double a = exp(-ts * SIM_RS / SIM_LS);
+    uint32_t per_cycle = (uint32_t)(timing->pwm_freq / freq + 0.5);
+    uint32_t total = per_cycle * (SIM_SETTLE_CYCLES + SIM_MEASURE_CYCLES);
+    uint32_t measure = per_cycle * SIM_MEASURE_CYCLES;
+    static float iq_log[SIM_MAX_PER_CYCLE * SIM_MEASURE_CYCLES];
+    static float ia_log[SIM_MAX_PER_CYCLE * SIM_MEASURE_CYCLES];
+    static float va_log[SIM_MAX_PER_CYCLE * SIM_MEASURE_CYCLES];
+    float vq = SIM_RS * SIM_IQ + (float)omega * SIM_FLUX;
+    double i[3] = {0.0, 0.0, 0.0};
+    double theta = 0.0;
+    double v[3], vn, e, thd, h1;
+    float valpha, vbeta;
+    uint32_t n, m, k;
+    uint8_t p;
+    
+    FOC_DeadTime_Enable(mode == SIM_ESTIMATED || mode == SIM_MEASURED);
+    FOC_GetControlStatus()->dead_time.current_valid = 0;
+    
+    for (n = 0; n < total; n++) {
+        // 控制：电压矢量沿q轴（theta + 90°），可选输入上一周期的相电流
+        if (mode == SIM_MEASURED) {
+            FOC_DeadTime_SetCurrent((float)i[0], (float)i[1], (float)i[2]);
+        }
+        FOC_InvPark_Transform(0.0f, vq, (float)theta, &valpha, &vbeta);
+        FOC_SVPWM_Generate(valpha, vbeta);
+        
+        // 逆变器：从比较寄存器取本周期占空比
+        v[0] = Sim_PhaseVoltage((int32_t)period - TIM2->CCR1, period, i[0], mode == SIM_IDEAL);
+        v[1] = Sim_PhaseVoltage((int32_t)period - TIM2->CCR2, period, i[1], mode == SIM_IDEAL);
+        v[2] = Sim_PhaseVoltage((int32_t)period - TIM2->CCR3, period, i[2], mode == SIM_IDEAL);
+        vn = (v[0] + v[1] + v[2]) / 3.0;
+        
+        // 电机：R-L-反电势，周期内电压恒定按指数解离散，反电势取周期中点
+        for (p = 0; p < 3; p++) {
+            e = -omega * SIM_FLUX * sin(theta + omega * ts / 2.0 - p * (2.0 * PI / 3.0));
+            i[p] = i[p] * a + (1.0 - a) * (v[p] - vn - e) / SIM_RS;
+        }
+        theta += omega * ts;
+        if (theta > 2.0 * PI) {
+            theta -= 2.0 * PI;
+        }
+        
+        if (n >= total - measure) {
+            m = n - (total - measure);
+            iq_log[m] = (float)(-(2.0 / 3.0) * (i[0] * sin(theta) + i[1] * sin(theta - 2.0 * PI / 3.0)
+                                                + i[2] * sin(theta + 2.0 * PI / 3.0)));
+            ia_log[m] = (float)i[0];
+            va_log[m] = (float)(v[0] - vn);
+        }
+    }
+    
+    // iq：平均值、6次谐波、峰峰值
+    res->iq_mean = 0.0;
+    res->iq_pp = 0.0;
+    {
+        float lo = iq_log[0], hi = iq_log[0];
+        
+        for (k = 0; k < measure; k++) {
+            res->iq_mean += iq_log[k];
+            if (iq_log[k] < lo) lo = iq_log[k];
+            if (iq_log[k] > hi) hi = iq_log[k];
+        }
+        res->iq_mean /= measure;
+        res->iq_pp = hi - lo;
+    }
+    res->iq_h6 = Sim_Dft(iq_log, measure, 6 * SIM_MEASURE_CYCLES);
+    
+    // 相电流THD
+    h1 = Sim_Dft(ia_log, measure, SIM_MEASURE_CYCLES);
+    thd = 0.0;
+    for (k = 2; k <= SIM_HARMONICS; k++) {
+        double h = Sim_Dft(ia_log, measure, k * SIM_MEASURE_CYCLES);
+        
+        thd += h * h;
+    }
+    res->thd = sqrt(thd) / h1;
+    
+    // 相电压基波相对指令幅值
+    res->v1_err = Sim_Dft(va_log, measure, SIM_MEASURE_CYCLES) / vq - 1.0;
+}
+
+int main(void)
+{
+    Sim_Result_t res[SIM_MODE_NUM];
+    FOC_MotorParam_t motor;
+    uint8_t f, mode;
+    int fail = 0;
+    
+    if (!HostPeriph_Init()) {
+        printf("cannot map peripheral address space\n");
+        return 2;
+    }
+    
+    FOC_Init();
+    motor = FOC_GetControlStatus()->motor;
+    motor.rs = SIM_RS;
+    motor.ld = SIM_LS;
+    motor.lq = SIM_LS;
+    motor.flux = SIM_FLUX;
+    FOC_SetMotorParam(&motor);
+    
+    printf("dead-time compensation: Vbus %.0f V, Rs %.1f ohm, Ls %.1f mH, dead %.0f ns, ton %.0f ns, toff %.0f ns\n",
+           SIM_VBUS, SIM_RS, SIM_LS * 1e3f, SIM_DEADTIME_NS, SIM_TON_NS, SIM_TOFF_NS);
+    printf("firmware compensation: %.2f counts (%.0f ns)\n\n", FOC_GetControlStatus()->dead_time.comp_counts,
+           FOC_GetControlStatus()->dead_time.error_ns);
+    printf("%6s %-10s %8s %9s %8s %7s %8s\n", "fe Hz", "comp", "iq A", "iq 6th A", "iq pp A", "THD", "V1 err");
+    
+    for (f = 0; f < SIM_FREQ_NUM; f++) {
+        if (MS8313_GetTiming()->pwm_freq / sim_freq[f] > SIM_MAX_PER_CYCLE) {
+            printf("%6.1f electrical frequency too low\n", sim_freq[f]);
+            fail = 1;
+            continue;
+        }
+        for (mode = 0; mode < SIM_MODE_NUM; mode++) {
+            Sim_Run(sim_freq[f], (Sim_Mode_t)mode, &res[mode]);
+            printf("%6.1f %-10s %8.3f %9.4f %8.3f %6.1f%% %7.1f%%\n", sim_freq[f], sim_mode_name[mode],
+                   res[mode].iq_mean, res[mode].iq_h6, res[mode].iq_pp,
+                   100.0 * res[mode].thd, 100.0 * res[mode].v1_err);
+        }
+        printf("%6s 6th-harmonic reduction: estimated x%.1f, measured x%.1f\n\n", "",
+               res[SIM_OFF].iq_h6 / res[SIM_ESTIMATED].iq_h6, res[SIM_OFF].iq_h6 / res[SIM_MEASURED].iq_h6);
+        if (res[SIM_OFF].iq_h6 < SIM_MIN_REDUCTION * res[SIM_MEASURED].iq_h6) {
+            fail = 1;
+        }
+    }
+    
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
@@ -0,0 +1,42 @@
+#include "HostPeriph.h"
+#include <string.h>
+#include <sys/mman.h>
+
+/**
+ * @brief  在固定地址映射一段可读写内存
+ * @param  base: 起始地址
+ * @param  size: 长度（字节）
+ * @retval 1: 成功, 0: 失败
+ */
+static uint8_t HostPeriph_Map(unsigned long base, unsigned long size)
+{
+    void *p = mmap((void *)base, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    
+    return p == (void *)base;
+}
+
+/**
+ * @brief  映射外设地址段（所有寄存器清零）
+ * @retval 1: 成功, 0: 地址段已被占用
+ */
+uint8_t HostPeriph_Init(void)
+{
+    if (!HostPeriph_Map(HOST_PERIPH_BASE, HOST_PERIPH_SIZE)) {
+        return 0;
+    }
+    if (!HostPeriph_Map(HOST_CORE_BASE, HOST_CORE_SIZE)) {
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief  所有寄存器清零（复位状态）
+ * @retval 无
+ */
+void HostPeriph_Reset(void)
+{
+    memset((void *)HOST_PERIPH_BASE, 0, HOST_PERIPH_SIZE);
+    memset((void *)HOST_CORE_BASE, 0, HOST_CORE_SIZE);
+}
@@ -0,0 +1,30 @@
+#ifndef __HOST_PERIPH_H
+#define __HOST_PERIPH_H
+
+#include <stdint.h>
+
+// ==================== 主机外设映射 ====================
+// 把STM32F103的外设寄存器地址段映射为主机内存，固件源码和标准外设库不做修改即可在PC上编译运行：
+// 0x40000000 起的APB1/APB2/AHB外设（TIM/ADC/GPIO/RCC/DMA/FLASH），
+// 0xE000E000 起的内核外设（SysTick/NVIC/SCB）。
+// 寄存器只是普通内存，没有硬件行为：计数、标志位和中断由测试程序按时序写入寄存器并调用中断函数
+#define HOST_PERIPH_BASE        0x40000000UL
+#define HOST_PERIPH_SIZE        0x00024000UL
+#define HOST_CORE_BASE          0xE000E000UL
+#define HOST_CORE_SIZE          0x00001000UL
+
+// ==================== 函数声明 ====================
+
+/**
+ * @brief  映射外设地址段（所有寄存器清零）
+ * @retval 1: 成功, 0: 地址段已被占用
+ */
+uint8_t HostPeriph_Init(void);
+
+/**
+ * @brief  所有寄存器清零（复位状态）
+ * @retval 无
+ */
+void HostPeriph_Reset(void);
+
+#endif
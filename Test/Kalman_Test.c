@@ -0,0 +1,348 @@
+/**
+ * 角度/速度卡尔曼滤波主机测试（合成 AS5600 轨迹回放）
+ *
+ * 机械模型 J·dω/dt = Kt·iq - B·ω - Tl 按控制周期的 SIM_SUBSTEPS 分之一积分，
+ * 转矩指令依次为：加速、滑行、减速、正弦摆动，正弦段叠加一次模型未知的负载阶跃。
+ * 每个控制周期生成一个 AS5600 测量值：真实角度加高斯噪声后量化到12位；
+ * 随机丢失 SIM_DROP_RATE 的测量值，另有两段连续丢失（I2C错误），滤波器只预测。
+ * 滤波器按 main.c 的调用顺序运行：Kalman_Predict（上一周期转矩指令）→ Kalman_Update（测量成功时），
+ * 两次采样之间用 Kalman_GetAngleAt 外推角度（电流环使用的预测角度）。
+ *
+ * 检查项：
+ *   1. 速度噪声：滤波速度相对真实速度的均方根误差，与测量角度差分测速对比；
+ *   2. 预测角度：采样之间 1/4、1/2、3/4 周期处外推角度的均方根误差；
+ *   3. 只预测：连续丢失期间最大角度误差，恢复后误差回到正常水平；
+ *   4. 模型输入：转矩指令作为模型输入时，加减速段速度误差小于无模型输入（b = 0）；
+ *   5. 采样频率修改：运行中修改控制频率，Kalman_SetSampleRate 换算后速度估计不跳变；
+ *   6. 耗时：主机上一次 Predict + Update 的时间（M3上的周期数由固件调试输出 "KF cycles" 给出）。
+ * 随机数使用固定种子，结果可复现。
+ *
+ * 编译运行（仓库根目录）：
+ *   gcc -std=gnu99 -O2 -Wall -IHardware Test/Kalman_Test.c Hardware/Kalman.c -lm -o kalman_test
+ *   ./kalman_test
+ * 返回值：任一检查项超出限值时为1
+ */
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "Kalman.h"
+
+// ==================== 仿真参数 ====================
+#define SIM_RATE            1000.0  // 控制频率（Hz）
+#define SIM_SUBSTEPS        20      // 每个控制周期的积分步数（4的倍数，外推检查用）
+#define SIM_DURATION        1.6     // 仿真时长（s）
+#define SIM_POLE_PAIRS      7       // 极对数
+#define SIM_FLUX            0.0025  // 永磁磁链（V·s/rad）
+#define SIM_INERTIA         2.0e-5  // 转动惯量（kg·m²）
+#define SIM_FRICTION        1.0e-6  // 粘滞摩擦系数（N·m·s/rad）
+#define SIM_LOAD_TORQUE     2.0e-3  // 负载阶跃（N·m，滤波器模型未知）
+#define SIM_NOISE           0.7     // 传感器噪声标准差（计数）
+#define SIM_DROP_RATE       0.03    // 随机丢失比例
+#define SIM_SEED            12345u  // 随机数种子
+
+// 连续丢失段（控制周期序号，长度）
+#define SIM_BURST1_START    500     // 滑行段
+#define SIM_BURST1_LEN      10
+#define SIM_BURST2_START    1150    // 正弦摆动段
+#define SIM_BURST2_LEN      20
+
+// 采样频率修改测试
+#define SIM_RATE2           1250.0  // 修改后的控制频率（Hz）
+#define SIM_RATE_CHANGE     0.45    // 修改时刻（s，滑行段）
+
+// 限值
+#define LIM_SPEED_RMS       5.0     // 滑行段速度均方根误差（RPM）
+#define LIM_SPEED_GAIN      3.0     // 相对差分测速的最小噪声抑制倍数
+#define LIM_PRED_RMS        1.0     // 外推角度均方根误差（计数）
+#define LIM_BURST_ERR       8.0     // 连续丢失期间最大角度误差（计数）
+#define LIM_RECOVER_ERR     3.0     // 恢复 SIM_RECOVER 个周期后的角度误差（计数）
+#define SIM_RECOVER         30
+#define LIM_RATE_JUMP       20.0    // 采样频率修改后20个周期内最大速度误差（RPM）
+
+/**
+ * @brief  一次运行的统计结果
+ */
+typedef struct {
+    double speed_rms;           // 滑行段滤波速度均方根误差（RPM）
+    double diff_rms;            // 滑行段差分测速均方根误差（RPM）
+    double accel_rms;           // 加减速段速度均方根误差（RPM）
+    double pred_rms;            // 外推角度均方根误差（计数）
+    double burst_max;           // 连续丢失期间最大角度误差（计数）
+    double recover_max;         // 恢复后的最大角度误差（计数）
+    double rate_max;            // 采样频率修改后的最大速度误差（RPM）
+    uint16_t missed_max;        // 最大连续丢失计数
+} Sim_Result_t;
+
+// ==================== 随机数 ====================
+static uint32_t rng_state;
+
+static double Sim_Uniform(void)
+{
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return ((rng_state >> 8) + 0.5) / 16777216.0;
+}
+
+static double Sim_Gauss(void)
+{
+    double u1 = Sim_Uniform();
+    double u2 = Sim_Uniform();
+    
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+// ==================== 仿真函数 ====================
+
+/**
+ * @brief  转矩指令（q轴电流，A）
+ * @param  t: 时间（s）
+ */
+static double Sim_Iq(double t)
+{
+    if (t < 0.3) return 0.3;        // 加速
+    if (t < 0.8) return 0.0;        // 滑行
+    if (t < 1.0) return -0.3;       // 减速
+    return 0.2 * sin(2.0 * M_PI * 5.0 * (t - 1.0));    // 正弦摆动
+}
+
+/**
+ * @brief  负载转矩（N·m）
+ * @param  t: 时间（s）
+ */
+static double Sim_Load(double t)
+{
+    return (t >= 1.3) ? SIM_LOAD_TORQUE : 0.0;
+}
+
+/**
+ * @brief  角度误差（计数，折算到 ±2048）
+ * @param  est: 估计角度（0-4095）
+ * @param  theta: 真实角度（圈）
+ */
+static double Sim_AngleErr(uint16_t est, double theta)
+{
+    double e = est - fmod(theta, 1.0) * 4096.0;
+    
+    while (e > 2048.0) e -= 4096.0;
+    while (e < -2048.0) e += 4096.0;
+    return e;
+}
+
+/**
+ * @brief  是否丢失本周期测量值
+ * @param  n: 控制周期序号
+ */
+static int Sim_Dropped(uint32_t n)
+{
+    if (n >= SIM_BURST1_START && n < SIM_BURST1_START + SIM_BURST1_LEN) return 1;
+    if (n >= SIM_BURST2_START && n < SIM_BURST2_START + SIM_BURST2_LEN) return 1;
+    return Sim_Uniform() < SIM_DROP_RATE;
+}
+
+/**
+ * @brief  一次运行
+ * @param  use_model: 1 = 转矩指令作为模型输入
+ * @param  rate_change: 1 = 在 SIM_RATE_CHANGE 修改控制频率
+ * @param  rescale: 1 = 修改控制频率时调用 Kalman_SetSampleRate
+ * @param  res: 结果（输出）
+ */
+static void Sim_Run(int use_model, int rate_change, int rescale, Sim_Result_t *res)
+{
+    double kt = 1.5 * SIM_POLE_PAIRS * SIM_FLUX;
+    double rate = SIM_RATE;
+    double theta = 0.123, omega = 0.0;      // 真实角度（圈）、角速度（rad/s）
+    double t = 0.0, h, iq_prev = 0.0;
+    double speed_err2 = 0.0, diff_err2 = 0.0, accel_err2 = 0.0, pred_err2 = 0.0;
+    uint32_t speed_n = 0, diff_n = 0, accel_n = 0, pred_n = 0;
+    uint32_t rate_tick = 0, n, k;
+    uint16_t z, z_prev = 0;
+    int z_prev_ok = 0, changed = 0;
+    Kalman_Config_t config;
+    Kalman_t kf;
+    
+    memset(res, 0, sizeof(*res));
+    rng_state = SIM_SEED;
+    
+    Kalman_GetDefaultConfig(&config);
+    config.sample_rate = (float)rate;
+    if (use_model) {
+        config.b[KALMAN_INPUT_CURRENT] = (float)(kt / (2.0 * M_PI * SIM_INERTIA));
+    }
+    Kalman_Init(&kf, &config);
+    
+    for (n = 0; t < SIM_DURATION; n++) {
+        double theta_sub[4];
+        double speed_true, e;
+        uint16_t est;
+        
+        // 控制频率修改：状态换算立即生效，增益按新频率重算（固件在主循环中完成）
+        if (rate_change && !changed && t >= SIM_RATE_CHANGE) {
+            int32_t gain[3];
+            
+            changed = 1;
+            rate_tick = n;
+            rate = SIM_RATE2;
+            if (rescale) {
+                Kalman_SetSampleRate(&kf, (float)rate, 0);
+                config.sample_rate = (float)rate;
+                Kalman_ComputeSteadyGains(&config, gain);
+                Kalman_SetSampleRate(&kf, (float)rate, gain);
+            }
+        }
+        
+        // 机械模型积分一个控制周期，记录 1/4、1/2、3/4 处的角度
+        h = 1.0 / rate / SIM_SUBSTEPS;
+        theta_sub[0] = theta;
+        for (k = 1; k <= SIM_SUBSTEPS; k++) {
+            double torque = kt * Sim_Iq(t) - SIM_FRICTION * omega - Sim_Load(t);
+            
+            omega += h * torque / SIM_INERTIA;
+            theta += h * omega / (2.0 * M_PI);
+            t += h;
+            if (k % (SIM_SUBSTEPS / 4) == 0 && k < SIM_SUBSTEPS) {
+                theta_sub[k / (SIM_SUBSTEPS / 4)] = theta;
+            }
+        }
+        
+        // 上一周期的外推角度与真实角度对比（预测 → 本周期起点之后）
+        if (n > 50 && kf.missed == 0) {
+            for (k = 1; k < 4; k++) {
+                e = Sim_AngleErr(Kalman_GetAngleAt(&kf, k * 16384u), theta_sub[k]);
+                pred_err2 += e * e;
+                pred_n++;
+            }
+        }
+        
+        // 滤波器：预测（上一周期的转矩指令），测量成功时校正
+        Kalman_Predict(&kf, (float)iq_prev, KALMAN_INPUT_CURRENT);
+        iq_prev = Sim_Iq(t);
+        z = (uint16_t)((int32_t)floor(fmod(theta, 1.0) * 4096.0 + SIM_NOISE * Sim_Gauss() + 0.5) & 0x0FFF);
+        if (!Sim_Dropped(n)) {
+            Kalman_Update(&kf, z);
+            
+            // 差分测速（只在相邻两次都成功时）
+            if (z_prev_ok && t > 0.35 && t < 0.75) {
+                int32_t d = (int32_t)z - z_prev;
+                double v;
+                
+                if (d > 2048) d -= 4096;
+                if (d < -2048) d += 4096;
+                v = d * rate * 60.0 / 4096.0;
+                speed_true = omega * 60.0 / (2.0 * M_PI);
+                diff_err2 += (v - speed_true) * (v - speed_true);
+                diff_n++;
+            }
+            z_prev = z;
+            z_prev_ok = 1;
+        } else {
+            z_prev_ok = 0;
+        }
+        
+        est = Kalman_GetAngle(&kf);
+        e = fabs(Sim_AngleErr(est, theta));
+        speed_true = omega * 60.0 / (2.0 * M_PI);
+        
+        // 速度误差：滑行段（噪声）和加减速段（模型跟踪）
+        if (t > 0.35 && t < 0.75) {
+            double d = Kalman_GetSpeedRPM(&kf) - speed_true;
+            
+            speed_err2 += d * d;
+            speed_n++;
+        } else if ((t > 0.05 && t < 0.3) || (t > 0.8 && t < 1.0)) {
+            double d = Kalman_GetSpeedRPM(&kf) - speed_true;
+            
+            accel_err2 += d * d;
+            accel_n++;
+        }
+        
+        // 只预测段和恢复段
+        if ((n >= SIM_BURST1_START && n < SIM_BURST1_START + SIM_BURST1_LEN) ||
+            (n >= SIM_BURST2_START && n < SIM_BURST2_START + SIM_BURST2_LEN)) {
+            if (e > res->burst_max) res->burst_max = e;
+        }
+        if (n == SIM_BURST1_START + SIM_BURST1_LEN + SIM_RECOVER ||
+            n == SIM_BURST2_START + SIM_BURST2_LEN + SIM_RECOVER) {
+            if (e > res->recover_max) res->recover_max = e;
+        }
+        if (kf.missed > res->missed_max) {
+            res->missed_max = kf.missed;
+        }
+        
+        // 采样频率修改后的速度误差
+        if (changed && n >= rate_tick && n < rate_tick + 20) {
+            double d = fabs(Kalman_GetSpeedRPM(&kf) - speed_true);
+            
+            if (d > res->rate_max) res->rate_max = d;
+        }
+    }
+    
+    res->speed_rms = sqrt(speed_err2 / speed_n);
+    res->diff_rms = sqrt(diff_err2 / diff_n);
+    res->accel_rms = sqrt(accel_err2 / accel_n);
+    res->pred_rms = sqrt(pred_err2 / pred_n);
+}
+
+/**
+ * @brief  主机上一次 Predict + Update 的耗时
+ * @retval 纳秒
+ */
+static double Sim_Timing(void)
+{
+    Kalman_Config_t config;
+    Kalman_t kf;
+    struct timespec t0, t1;
+    uint32_t n, count = 2000000;
+    volatile uint16_t sink = 0;
+    
+    Kalman_GetDefaultConfig(&config);
+    config.b[KALMAN_INPUT_CURRENT] = 100.0f;
+    Kalman_Init(&kf, &config);
+    
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (n = 0; n < count; n++) {
+        Kalman_Predict(&kf, 0.1f, KALMAN_INPUT_CURRENT);
+        Kalman_Update(&kf, (uint16_t)(n * 3));
+        sink += Kalman_GetAngle(&kf);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    (void)sink;
+    
+    return ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / count;
+}
+
+int main(void)
+{
+    Sim_Result_t model, nomodel, rate_fix, rate_old;
+    int fail = 0;
+    
+    Sim_Run(1, 0, 0, &model);
+    Sim_Run(0, 0, 0, &nomodel);
+    Sim_Run(1, 1, 1, &rate_fix);
+    Sim_Run(1, 1, 0, &rate_old);
+    
+    printf("Kalman filter: %.0f Hz, noise %.1f counts, drop %.0f%% + bursts of %d/%d samples\n\n",
+           SIM_RATE, SIM_NOISE, SIM_DROP_RATE * 100.0, SIM_BURST1_LEN, SIM_BURST2_LEN);
+    printf("%-12s %10s %10s %10s %10s %10s %10s %8s\n", "input", "coast RPM", "diff RPM", "accel RPM",
+           "pred cnt", "burst cnt", "recov cnt", "missed");
+    printf("%-12s %10.2f %10.2f %10.2f %10.3f %10.2f %10.2f %8d\n", "torque", model.speed_rms, model.diff_rms,
+           model.accel_rms, model.pred_rms, model.burst_max, model.recover_max, model.missed_max);
+    printf("%-12s %10.2f %10.2f %10.2f %10.3f %10.2f %10.2f %8d\n", "none (b=0)", nomodel.speed_rms,
+           nomodel.diff_rms, nomodel.accel_rms, nomodel.pred_rms, nomodel.burst_max, nomodel.recover_max,
+           nomodel.missed_max);
+    printf("\nrate change %.0f -> %.0f Hz: max speed error %.2f RPM rescaled, %.2f RPM not rescaled\n",
+           SIM_RATE, SIM_RATE2, rate_fix.rate_max, rate_old.rate_max);
+    printf("host time per Predict + Update: %.1f ns\n\n", Sim_Timing());
+
+#define CHECK(cond, msg) do { if (!(cond)) { printf("FAIL: %s\n", msg); fail = 1; } } while (0)
+    CHECK(model.speed_rms < LIM_SPEED_RMS, "coast speed noise");
+    CHECK(model.diff_rms > LIM_SPEED_GAIN * model.speed_rms, "speed noise reduction vs differentiation");
+    CHECK(model.pred_rms < LIM_PRED_RMS, "predicted angle between samples");
+    CHECK(model.burst_max < LIM_BURST_ERR, "angle error while predicting only");
+    CHECK(model.recover_max < LIM_RECOVER_ERR, "recovery after missed samples");
+    CHECK(model.missed_max >= SIM_BURST2_LEN, "missed sample counter");
+    CHECK(model.accel_rms < nomodel.accel_rms, "torque model input reduces tracking error");
+    CHECK(rate_fix.rate_max < LIM_RATE_JUMP, "speed continuity across a sample rate change");
+    
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
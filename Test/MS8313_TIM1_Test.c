@@ -0,0 +1,376 @@
+/**
+ * MS8313 TIM1 后端寄存器级测试
+ *
+ * 以 MS8313_USE_TIM1 = 1 编译 MS8313.c 和标准外设库，外设寄存器映射为主机内存（见 HostPeriph.h），
+ * 逐项检查驱动写入的寄存器：时基与PWM模式、仅CHxN输出、刹车与死区（BDTR）、中断优先级、
+ * 使能/禁用、三相占空比原子更新、重复计数器对齐、周期修改在下溢生效、控制回调分频、
+ * 刹车中断锁存故障与清除流程、ADC触发配置。
+ * 刹车的硬件关断（BKIN异步清除MOE）没有软件参与，这里检查的是它依赖的配置位。
+ *
+ * 编译运行（仓库根目录）：
+ *   gcc -std=gnu99 -O2 -w -DUSE_STDPERIPH_DRIVER -DSTM32F10X_MD -DMS8313_USE_TIM1=1 \
+ *       "-D__weak=__attribute__((weak))" -IStart -ILibrary -IUser -ISystem -IHardware -ITest \
+ *       Test/MS8313_TIM1_Test.c Test/HostPeriph.c Hardware/MS8313.c Library/misc.c \
+ *       Library/stm32f10x_tim.c Library/stm32f10x_gpio.c Library/stm32f10x_rcc.c -o tim1_test
+ *   ./tim1_test
+ * 返回值：失败项数
+ */
+#include <stdio.h>
+#include "stm32f10x.h"
+#include "HostPeriph.h"
+#include "MS8313.h"
+
+#if !MS8313_USE_TIM1
+#error "以 -DMS8313_USE_TIM1=1 编译"
+#endif
+
+// ==================== 测试框架 ====================
+static int test_fail = 0;
+static int test_count = 0;
+
+#define CHECK(expr)     Test_Check((expr) != 0, #expr, __LINE__)
+#define CHECK_EQ(a, b)  Test_CheckEq((uint32_t)(a), (uint32_t)(b), #a, __LINE__)
+
+static void Test_Check(int ok, const char *expr, int line)
+{
+    test_count++;
+    if (!ok) {
+        test_fail++;
+        printf("  FAIL line %d: %s\n", line, expr);
+    }
+}
+
+static void Test_CheckEq(uint32_t a, uint32_t b, const char *expr, int line)
+{
+    test_count++;
+    if (a != b) {
+        test_fail++;
+        printf("  FAIL line %d: %s = %u (0x%X), expected %u (0x%X)\n", line, expr, a, a, b, b);
+    }
+}
+
+// ==================== 桩函数 ====================
+static uint32_t control_calls = 0;
+
+void MS8313_ControlCallback(void)
+{
+    control_calls++;
+}
+
+/**
+ * @brief  模拟一次更新事件并进入更新中断
+ * @param  down: 1 = 上溢（之后向下计数）, 0 = 下溢
+ */
+static void Test_UpdateEvent(uint8_t down)
+{
+    if (down) {
+        TIM1->CR1 |= TIM_CR1_DIR;
+    } else {
+        TIM1->CR1 &= (uint16_t)~TIM_CR1_DIR;
+    }
+    TIM1->SR |= TIM_SR_UIF;
+    MS8313_TIM_IRQHandler();
+}
+
+/**
+ * @brief  复位寄存器并重新初始化（与 main 相同的优先级分组）
+ */
+static void Test_Setup(void)
+{
+    HostPeriph_Reset();
+    NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2);
+    GPIOB->IDR = GPIO_Pin_12;       // BKIN释放（上拉）
+    MS8313_ClearFault();
+    MS8313_Init();
+}
+
+// ==================== 测试项 ====================
+
+static void Test_Init(void)
+{
+    uint16_t period = MS8313_GetTiming()->period;
+    
+    printf("init\n");
+    Test_Setup();
+    
+    // 时钟
+    CHECK(RCC->APB2ENR & RCC_APB2ENR_TIM1EN);
+    CHECK(RCC->APB2ENR & RCC_APB2ENR_IOPBEN);
+    
+    // 时基：中心对齐模式1，36MHz，ARR预装载，启动时RCR = 0
+    CHECK_EQ(TIM1->CR1 & TIM_CR1_CMS, TIM_CR1_CMS_0);
+    CHECK(TIM1->CR1 & TIM_CR1_ARPE);
+    CHECK_EQ(TIM1->PSC, 1);
+    CHECK_EQ(TIM1->ARR, period);
+    CHECK_EQ(TIM1->RCR, 0);
+    
+    // CH1-3：PWM2 + 预装载，只使能CHxN，极性高，空闲电平低
+    CHECK_EQ(TIM1->CCMR1 & (TIM_CCMR1_OC1M | TIM_CCMR1_OC1PE), TIM_CCMR1_OC1M | TIM_CCMR1_OC1PE);
+    CHECK_EQ(TIM1->CCMR1 & (TIM_CCMR1_OC2M | TIM_CCMR1_OC2PE), TIM_CCMR1_OC2M | TIM_CCMR1_OC2PE);
+    CHECK_EQ(TIM1->CCMR2 & (TIM_CCMR2_OC3M | TIM_CCMR2_OC3PE), TIM_CCMR2_OC3M | TIM_CCMR2_OC3PE);
+    CHECK_EQ(TIM1->CCER & 0x0FFF, TIM_CCER_CC1NE | TIM_CCER_CC2NE | TIM_CCER_CC3NE);
+    CHECK_EQ(TIM1->CR2 & (TIM_CR2_OIS1 | TIM_CR2_OIS1N | TIM_CR2_OIS2 | TIM_CR2_OIS2N | TIM_CR2_OIS3 | TIM_CR2_OIS3N), 0);
+    
+    // 初始占空比为0（PWM2：比较值 = 周期）
+    CHECK_EQ(TIM1->CCR1, period);
+    CHECK_EQ(TIM1->CCR2, period);
+    CHECK_EQ(TIM1->CCR3, period);
+    
+    // 刹车：使能、低有效、OSSI/OSSR、锁定级别1、无自动输出、死区
+    CHECK(TIM1->BDTR & TIM_BDTR_BKE);
+    CHECK(!(TIM1->BDTR & TIM_BDTR_BKP));
+    CHECK(TIM1->BDTR & TIM_BDTR_OSSI);
+    CHECK(TIM1->BDTR & TIM_BDTR_OSSR);
+    CHECK_EQ(TIM1->BDTR & TIM_BDTR_LOCK, TIM_BDTR_LOCK_0);
+    CHECK(!(TIM1->BDTR & TIM_BDTR_AOE));
+    CHECK_EQ(TIM1->BDTR & TIM_BDTR_DTG, MS8313_DEADTIME_DTG);
+    
+    // 中断：更新 + 刹车；刹车抢占优先级0，更新1（与ADC电流中断的关系见 ADC.c）
+    CHECK_EQ(TIM1->DIER & (TIM_DIER_UIE | TIM_DIER_BIE), TIM_DIER_UIE | TIM_DIER_BIE);
+    // ISER是写1置位，映射内存只保留最后一次写入（刹车中断）
+    CHECK(NVIC->ISER[TIM1_BRK_IRQn >> 5] & (1UL << (TIM1_BRK_IRQn & 0x1F)));
+    CHECK_EQ(NVIC->IP[TIM1_UP_IRQn] >> 6, 1);
+    CHECK_EQ(NVIC->IP[TIM1_BRK_IRQn] >> 6, 0);
+    
+    // 初始化后输出禁用：MOE清零、计数停止、EN拉低
+    CHECK(!(TIM1->BDTR & TIM_BDTR_MOE));
+    CHECK(!(TIM1->CR1 & TIM_CR1_CEN));
+    CHECK_EQ(GPIOA->BRR, MS8313_EN_PIN);
+    CHECK(!MS8313_GetOutputStatus());
+    
+    // BKIN（PB12）上拉输入：CRH 第4个引脚 CNF = 10, MODE = 00，ODR置1选择上拉
+    CHECK_EQ((GPIOB->CRH >> 16) & 0x0F, 0x08);
+    CHECK(GPIOB->BSRR & GPIO_Pin_12);
+    // PB13-15 复用推挽 50MHz
+    CHECK_EQ((GPIOB->CRH >> 20) & 0x0FFF, 0xBBB);
+}
+
+static void Test_EnableDisable(void)
+{
+    printf("enable/disable\n");
+    Test_Setup();
+    
+    GPIOA->BSRR = 0;
+    MS8313_EnableOutput();
+    CHECK(TIM1->BDTR & TIM_BDTR_MOE);
+    CHECK(TIM1->CR1 & TIM_CR1_CEN);
+    CHECK_EQ(GPIOA->BSRR, MS8313_EN_PIN);
+    CHECK(MS8313_GetOutputStatus());
+    
+    GPIOA->BRR = 0;
+    MS8313_DisableOutput();
+    CHECK(!(TIM1->BDTR & TIM_BDTR_MOE));
+    CHECK(!(TIM1->CR1 & TIM_CR1_CEN));
+    CHECK_EQ(GPIOA->BRR, MS8313_EN_PIN);
+    
+    // 滑行：MOE清零、EN拉低，计数器继续运行
+    MS8313_EnableOutput();
+    GPIOA->BRR = 0;
+    MS8313_Coast();
+    CHECK(!(TIM1->BDTR & TIM_BDTR_MOE));
+    CHECK(TIM1->CR1 & TIM_CR1_CEN);
+    CHECK_EQ(GPIOA->BRR, MS8313_EN_PIN);
+}
+
+static void Test_Duty(void)
+{
+    uint16_t period = MS8313_GetTiming()->period;
+    
+    printf("duty\n");
+    Test_Setup();
+    MS8313_EnableOutput();
+    
+    MS8313_SetThreePhaseDuty(100, period / 2, period);
+    CHECK_EQ(TIM1->CCR1, period - 100);
+    CHECK_EQ(TIM1->CCR2, period - period / 2);
+    CHECK_EQ(TIM1->CCR3, 0);
+    CHECK(!(TIM1->CR1 & TIM_CR1_UDIS));     // 写入后恢复更新事件
+    
+    // 超出周期按100%
+    MS8313_SetThreePhaseDuty(period + 50, 0, 1);
+    CHECK_EQ(TIM1->CCR1, 0);
+    CHECK_EQ(TIM1->CCR2, period);
+    CHECK_EQ(TIM1->CCR3, period - 1);
+    
+    MS8313_SetDutyCycle(MS8313_PHASE_B, 300);
+    CHECK_EQ(TIM1->CCR2, period - 300);
+    CHECK_EQ(TIM1->CCR1, 0);
+    
+    // 六步换相第0步：A高、C低、B在中点
+    MS8313_SetSixStep(0, 400);
+    CHECK_EQ(TIM1->CCR1, period - (period / 2 + 200));
+    CHECK_EQ(TIM1->CCR2, period - period / 2);
+    CHECK_EQ(TIM1->CCR3, period - (period / 2 - 200));
+    
+    MS8313_StopAll();
+    CHECK_EQ(TIM1->CCR1, period);
+    CHECK_EQ(TIM1->CCR2, period);
+    CHECK_EQ(TIM1->CCR3, period);
+}
+
+static void Test_Repetition(void)
+{
+    uint8_t i;
+    
+    printf("repetition counter\n");
+    Test_Setup();
+    MS8313_EnableOutput();
+    
+    // 启动时RCR = 0，上溢和下溢都更新；第一次上溢写入目标值，下一次下溢装载后只在下溢更新
+    Test_UpdateEvent(1);
+    CHECK_EQ(TIM1->RCR, MS8313_TIM1_REPETITION);
+    
+    // 更新落在上溢（相位错开）：先写0，下一次上溢再写目标值
+    Test_UpdateEvent(1);
+    CHECK_EQ(TIM1->RCR, 0);
+    Test_UpdateEvent(1);
+    CHECK_EQ(TIM1->RCR, MS8313_TIM1_REPETITION);
+    
+    // 下溢不改RCR
+    for (i = 0; i < 4; i++) {
+        Test_UpdateEvent(0);
+    }
+    CHECK_EQ(TIM1->RCR, MS8313_TIM1_REPETITION);
+}
+
+static void Test_ControlDivider(void)
+{
+    uint16_t divider = MS8313_GetTiming()->control_divider;
+    uint16_t i;
+    
+    printf("control divider\n");
+    Test_Setup();
+    MS8313_EnableOutput();
+    
+    control_calls = 0;
+    for (i = 0; i < 10 * divider; i++) {
+        Test_UpdateEvent(0);
+    }
+    CHECK_EQ(control_calls, 10);
+    
+    // 上溢不触发控制回调
+    for (i = 0; i < 10 * divider; i++) {
+        Test_UpdateEvent(1);
+    }
+    CHECK_EQ(control_calls, 10);
+}
+
+static void Test_Frequency(void)
+{
+    const MS8313_Timing_t *timing = MS8313_GetTiming();
+    uint16_t old_period, new_period;
+    uint32_t version;
+    
+    printf("frequency change\n");
+    Test_Setup();
+    
+    // 定时器停止时立即生效
+    MS8313_SetFrequency(MS8313_PWM_FREQ);
+    CHECK_EQ(TIM1->ARR, timing->period);
+    
+    MS8313_EnableOutput();
+    old_period = timing->period;
+    MS8313_SetThreePhaseDuty(old_period / 4, old_period / 2, old_period);
+    version = timing->version;
+    
+    // 运行中：登记后等下溢中断写入，ARR和比较值按占空比百分比一起换算
+    MS8313_SetFrequency(MS8313_PWM_FREQ * 2);
+    CHECK_EQ(TIM1->ARR, old_period);
+    CHECK_EQ(timing->version, version);
+    Test_UpdateEvent(1);
+    CHECK_EQ(TIM1->ARR, old_period);
+    Test_UpdateEvent(0);
+    new_period = timing->period;
+    CHECK_EQ(new_period, old_period / 2);
+    CHECK_EQ(TIM1->ARR, new_period);
+    CHECK_EQ(timing->version, version + 1);
+    CHECK_EQ(TIM1->CCR1, new_period - new_period / 4);
+    CHECK_EQ(TIM1->CCR2, new_period - new_period / 2);
+    CHECK_EQ(TIM1->CCR3, 0);
+    CHECK(!(TIM1->CR1 & TIM_CR1_UDIS));
+    CHECK_EQ(timing->pwm_freq, MS8313_PWM_FREQ * 2);
+    
+    MS8313_DisableOutput();
+    MS8313_SetFrequency(MS8313_PWM_FREQ);
+}
+
+static void Test_Break(void)
+{
+    printf("break\n");
+    Test_Setup();
+    MS8313_EnableOutput();
+    
+    // 硬件：BKIN有效时异步清除MOE并置位BIF
+    TIM1->BDTR &= (uint16_t)~TIM_BDTR_MOE;
+    TIM1->SR |= TIM_SR_BIF;
+    GPIOB->IDR &= ~(uint32_t)GPIO_Pin_12;
+    GPIOA->BRR = 0;
+    MS8313_BRK_IRQHandler();
+    CHECK(MS8313_GetFault());
+    CHECK(!MS8313_GetOutputStatus());
+    CHECK_EQ(GPIOA->BRR, MS8313_EN_PIN);
+    CHECK(!(TIM1->DIER & TIM_DIER_BIE));    // BKIN保持有效时不反复进入
+    CHECK(TIM1->DIER & TIM_DIER_UIE);
+    
+    // 故障未清除时不允许重新使能
+    MS8313_EnableOutput();
+    CHECK(!(TIM1->BDTR & TIM_BDTR_MOE));
+    CHECK(!MS8313_GetOutputStatus());
+    
+    // BKIN仍为低：清除失败
+    CHECK(!MS8313_ClearFault());
+    CHECK(MS8313_GetFault());
+    CHECK(!(TIM1->DIER & TIM_DIER_BIE));
+    
+    // BKIN释放：清除成功，刹车中断重新打开，输出保持禁用直到重新使能
+    GPIOB->IDR |= GPIO_Pin_12;
+    CHECK(MS8313_ClearFault());
+    CHECK(!MS8313_GetFault());
+    CHECK(TIM1->DIER & TIM_DIER_BIE);
+    CHECK(!(TIM1->BDTR & TIM_BDTR_MOE));
+    MS8313_EnableOutput();
+    CHECK(TIM1->BDTR & TIM_BDTR_MOE);
+    
+    // 没有BIF时刹车中断不做任何事
+    TIM1->SR = 0;
+    MS8313_BRK_IRQHandler();
+    CHECK(!MS8313_GetFault());
+}
+
+static void Test_ADCTrigger(void)
+{
+    printf("adc trigger\n");
+    Test_Setup();
+    
+    // CH4 PWM1 内部比较，TRGO = OC4REF
+    MS8313_SetADCTrigger(11);
+    CHECK_EQ(TIM1->CCR4, 11);
+    CHECK_EQ(TIM1->CCMR2 & TIM_CCMR2_OC4M, TIM_CCMR2_OC4M_2 | TIM_CCMR2_OC4M_1);
+    CHECK(TIM1->CCMR2 & TIM_CCMR2_OC4PE);
+    CHECK(!(TIM1->CCER & TIM_CCER_CC4E));
+    CHECK_EQ(TIM1->CR2 & TIM_CR2_MMS, TIM_TRGOSource_OC4Ref);
+    
+    // 提前量为0时取1（CCR4 = 0 不产生触发）
+    MS8313_SetADCTrigger(0);
+    CHECK_EQ(TIM1->CCR4, 1);
+}
+
+int main(void)
+{
+    if (!HostPeriph_Init()) {
+        printf("cannot map peripheral address space\n");
+        return 2;
+    }
+    
+    Test_Init();
+    Test_EnableDisable();
+    Test_Duty();
+    Test_Repetition();
+    Test_ControlDivider();
+    Test_Frequency();
+    Test_Break();
+    Test_ADCTrigger();
+    
+    printf("\n%d checks, %d failed\n", test_count, test_fail);
+    return test_fail;
+}
@@ -0,0 +1,416 @@
+/**
+ * 单电阻电流重构主机仿真
+ *
+ * 在PC上运行固件的调制和重构路径：
+ *   FOC_SVPWM_Generate → FOC_SVPWM_SingleShunt → MS8313 图样双缓冲与更新中断
+ *   → 注入组转换完成中断 MYADC_IRQHandler（MYADC_SingleShuntSample）→ 重构三相电流
+ * 外设寄存器映射为主机内存（见 HostPeriph.h），本程序按TIM2中心对齐计数的时序
+ * 装载影子寄存器、产生更新中断和采样触发，由真实相电流和各相开关状态算出采样时刻的母线电流，
+ * 写入ADC数据寄存器。电流回调里以同一电压矢量重新调用调制器，与电流环的调用位置一致。
+ *
+ * 电压矢量按各幅值（线性区内切圆的 5% ~ 100%）匀速旋转一圈，覆盖6个扇区，
+ * 每个PWM周期的指令和相电流都在变化（图样逐周期更新），按幅值和方向区间输出：
+ * 可重构的PWM周期比例、重构误差（最大/均方根，A）、采样保持窗口内出现开关沿的次数、
+ * 转换完成中断被判为过期而丢弃的次数、没有产生采样触发（电流回调停止）的次数。
+ * 噪声和放大器建模见 SIM_x 参数，随机数固定种子，结果可复现。
+ *
+ * 编译运行（仓库根目录）：
+ *   gcc -std=gnu99 -O2 -w -DUSE_STDPERIPH_DRIVER -DSTM32F10X_MD -DMYADC_SHUNT_NUM=1 \
+ *       "-D__weak=__attribute__((weak))" -IStart -ILibrary -IUser -ISystem -IHardware -ITest \
+ *       Test/SingleShunt_Test.c Test/HostPeriph.c Hardware/FOC.c Hardware/ADC.c Hardware/MS8313.c \
+ *       Hardware/PID.c Hardware/Traj.c Library/misc.c Library/stm32f10x_tim.c \
+ *       Library/stm32f10x_adc.c Library/stm32f10x_gpio.c Library/stm32f10x_rcc.c \
+ *       Library/stm32f10x_dma.c -lm -o singleshunt_test
+ *   ./singleshunt_test            汇总表（按幅值）
+ *   ./singleshunt_test -v         按方向区间（10°）的明细
+ * 返回值：有效周期内重构误差超出 SIM_ERR_LIMIT 或采样窗口内出现开关沿时为1
+ */
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "stm32f10x.h"
+#include "HostPeriph.h"
+#include "FOC.h"
+#include "ADC.h"
+#include "MS8313.h"
+
+// ==================== 仿真参数 ====================
+#define SIM_VBUS            12.0f   // 母线电压（V）
+#define SIM_I_PEAK          3.0f    // 相电流幅值（A）
+#define SIM_PHI             (30.0f * PI / 180.0f)   // 电流滞后电压矢量的角度（rad）
+#define SIM_ADC_SAMPLE      23      // ADC采样保持时间（定时器计数：7.5周期 @12MHz）
+#define SIM_ADC_CONV        60      // 触发到转换完成（20周期 @12MHz）
+#define SIM_IRQ_LATENCY     12      // 转换完成到进入中断（定时器计数）
+#define SIM_AMP_TAU         7.0f    // 电流放大器一阶响应时间常数（定时器计数，约0.2us）
+#define SIM_NOISE           1.5f    // ADC噪声标准差（计数）
+#define SIM_WARMUP          4       // 每个幅值的预热PWM周期
+#define SIM_TURN_PERIODS    3600    // 电压矢量旋转一圈的PWM周期数（18kHz下电频率5Hz）
+#define SIM_BIN_DEG         10      // 统计的方向区间（°）
+#define SIM_BIN_NUM         (360 / SIM_BIN_DEG)
+#define SIM_ERR_LIMIT       0.05f   // 允许的重构误差（A）
+
+static const float sim_mod[] = {0.05f, 0.1f, 0.2f, 0.4f, 0.6f, 0.8f, 0.9f, 0.95f, 1.0f};
+#define SIM_MOD_NUM         (sizeof(sim_mod) / sizeof(sim_mod[0]))
+
+// ==================== 仿真状态 ====================
+static float cmd_valpha, cmd_vbeta;     // 电流回调中调制器使用的电压矢量
+static float phase_i[3];                // 真实相电流（A，流出逆变器为正）
+static uint32_t callback_count;         // 电流回调次数
+static uint32_t rng_state = 12345;      // 噪声随机数
+
+/**
+ * @brief  工作点统计
+ */
+typedef struct {
+    uint32_t periods;       // 统计的PWM周期
+    uint32_t valid;         // 由两次采样重构的周期
+    uint32_t edge_hits;     // 采样保持窗口内有开关沿
+    uint32_t dropped;       // 转换完成中断核对触发点失败而丢弃
+    uint32_t stalled;       // 没有采样触发，电流回调未运行
+    float err_max;          // 最大重构误差（A）
+    double err_sq;          // 误差平方和
+    uint32_t err_n;         // 误差样本数
+} Sim_Stat_t;
+
+// ==================== 固件依赖的桩函数 ====================
+float AS5600_GetTotalAngle(void)
+{
+    return 0.0f;
+}
+
+uint32_t Delay_GetTick(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  电流采样完成回调：以当前电压指令生成下一个PWM图样（与电流环相同的调用位置）
+ */
+void MYADC_CurrentCallback(void)
+{
+    callback_count++;
+    FOC_SVPWM_Generate(cmd_valpha, cmd_vbeta);
+}
+
+// ==================== 仿真函数 ====================
+
+/**
+ * @brief  标准正态随机数（线性同余 + Box-Muller）
+ */
+static float Sim_Gauss(void)
+{
+    float u1, u2;
+    
+    rng_state = rng_state * 1103515245u + 12345u;
+    u1 = ((rng_state >> 8) + 1.0f) / 16777217.0f;
+    rng_state = rng_state * 1103515245u + 12345u;
+    u2 = (rng_state >> 8) / 16777216.0f;
+    return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * PI * u2);
+}
+
+/**
+ * @brief  向上计数时某一时刻的母线电流（高边导通各相电流之和）
+ * @param  ccr: 已装载的三相比较值（PWM2：CNT >= CCR 时高边导通）
+ * @param  cnt: 计数值
+ */
+static float Sim_BusCurrent(const uint16_t ccr[3], int32_t cnt)
+{
+    float idc = 0.0f;
+    uint8_t i;
+    
+    for (i = 0; i < 3; i++) {
+        if (cnt >= ccr[i]) {
+            idc += phase_i[i];
+        }
+    }
+    return idc;
+}
+
+/**
+ * @brief  采样保持结束时放大器输出的母线电流
+ * @note   放大器按一阶响应跟随母线电流，从谷点（零矢量，已稳定）开始逐个开关沿递推
+ * @param  ccr: 已装载的三相比较值
+ * @param  hold: 采样保持结束时刻（计数）
+ */
+static float Sim_AmpOutput(const uint16_t ccr[3], int32_t hold)
+{
+    int32_t t = 0;
+    float y = Sim_BusCurrent(ccr, 0);
+    int32_t edge;
+    uint8_t i;
+    
+    for (;;) {
+        // 下一个开关沿
+        edge = hold;
+        for (i = 0; i < 3; i++) {
+            if (ccr[i] > t && ccr[i] < edge) {
+                edge = ccr[i];
+            }
+        }
+        y = Sim_BusCurrent(ccr, t) + (y - Sim_BusCurrent(ccr, t)) * expf(-(edge - t) / SIM_AMP_TAU);
+        if (edge >= hold) {
+            return y;
+        }
+        t = edge;
+    }
+}
+
+/**
+ * @brief  一次注入组转换：采样母线电流并在转换完成时进入中断
+ * @param  ccr: 已装载的三相比较值
+ * @param  trigger: 触发时刻（计数）
+ * @param  period: 周期值
+ * @param  stat: 统计
+ */
+static void Sim_Convert(const uint16_t ccr[3], int32_t trigger, int32_t period, Sim_Stat_t *stat)
+{
+    int32_t t = trigger + SIM_ADC_CONV + SIM_IRQ_LATENCY;
+    float counts;
+    uint8_t i;
+    
+    // 采样保持窗口内母线电流不应变化
+    for (i = 0; i < 3; i++) {
+        if (ccr[i] > trigger && ccr[i] <= trigger + SIM_ADC_SAMPLE && stat) {
+            stat->edge_hits++;
+        }
+    }
+    
+    counts = MYADC_CURRENT_OFFSET + Sim_AmpOutput(ccr, trigger + SIM_ADC_SAMPLE)
+             / (MYADC_VREF / 4096.0f / (MYADC_SHUNT_OHM * MYADC_AMP_GAIN)) + SIM_NOISE * Sim_Gauss();
+    counts = floorf(counts + 0.5f);
+    if (counts < 0.0f) counts = 0.0f;
+    if (counts > 4095.0f) counts = 4095.0f;
+    ADC1->JDR1 = (uint32_t)counts;
+    
+    // 中断时刻的计数值和方向（越过峰值后向下计数）
+    if (t <= period) {
+        TIM2->CNT = (uint16_t)t;
+        TIM2->CR1 &= (uint16_t)~TIM_CR1_DIR;
+    } else {
+        TIM2->CNT = (uint16_t)(2 * period - t);
+        TIM2->CR1 |= TIM_CR1_DIR;
+    }
+    ADC1->SR |= ADC_SR_JEOC;
+    MYADC_IRQHandler();
+}
+
+/**
+ * @brief  PWM更新事件：预装载值进入影子寄存器，随后进入更新中断
+ * @param  shadow: 影子比较值（输出）
+ * @param  cnt: 计数值（0 = 下溢，周期值 = 上溢）
+ * @param  down: 更新后的计数方向
+ */
+static void Sim_Update(uint16_t shadow[3], uint16_t cnt, uint8_t down)
+{
+    shadow[0] = TIM2->CCR1;
+    shadow[1] = TIM2->CCR2;
+    shadow[2] = TIM2->CCR3;
+    TIM2->CNT = cnt;
+    if (down) {
+        TIM2->CR1 |= TIM_CR1_DIR;
+    } else {
+        TIM2->CR1 &= (uint16_t)~TIM_CR1_DIR;
+    }
+    TIM2->SR |= TIM_SR_UIF;
+    MS8313_TIM_IRQHandler();
+}
+
+/**
+ * @brief  仿真一个PWM周期（下溢 → 向上计数两次采样 → 上溢 → 向下计数）
+ * @param  stat: 统计（NULL = 预热）
+ */
+static void Sim_Period(Sim_Stat_t *stat)
+{
+    int32_t period = MS8313_GetTiming()->period;
+    uint16_t shadow[3], shadow_down[3];
+    uint32_t callbacks = callback_count;
+    int32_t trigger, t_isr;
+    uint8_t conversions = 0;
+    uint8_t peak_done = 0;
+    
+    // 下溢：上半周期比较值生效
+    Sim_Update(shadow, 0, 0);
+    
+    // 第一个触发点：CCR4 在上溢中断中写入（预装载关闭，立即生效），PWM2向上计数经过时触发
+    trigger = TIM2->CCR4;
+    if (trigger > 0 && trigger < period) {
+        t_isr = trigger + SIM_ADC_CONV + SIM_IRQ_LATENCY;
+        if (t_isr > period) {
+            Sim_Update(shadow_down, (uint16_t)period, 1);
+            peak_done = 1;
+        }
+        Sim_Convert(shadow, trigger, period, stat);
+        conversions++;
+        
+        // 第二个触发点：中断中改写的CCR4仍大于计数值才会再产生上升沿
+        if (!peak_done && TIM2->CCR4 > t_isr && TIM2->CCR4 < period) {
+            trigger = TIM2->CCR4;
+            t_isr = trigger + SIM_ADC_CONV + SIM_IRQ_LATENCY;
+            if (t_isr > period) {
+                Sim_Update(shadow_down, (uint16_t)period, 1);
+                peak_done = 1;
+            }
+            Sim_Convert(shadow, trigger, period, stat);
+            conversions++;
+        }
+    }
+    
+    // 上溢：下半周期比较值生效，下一周期的图样切换
+    if (!peak_done) {
+        Sim_Update(shadow_down, (uint16_t)period, 1);
+    }
+    
+    if (stat == 0) {
+        if (callback_count == callbacks) {
+            FOC_SVPWM_Generate(cmd_valpha, cmd_vbeta);
+        }
+        return;
+    }
+    
+    stat->periods++;
+    if (callback_count == callbacks) {
+        // 没有触发或结果被丢弃，由控制周期代替电流回调重新调制
+        if (conversions == 0) {
+            stat->stalled++;
+        } else {
+            stat->dropped++;
+        }
+        FOC_SVPWM_Generate(cmd_valpha, cmd_vbeta);
+    } else if (MYADC_GetCurrent()->reconstructed != 0x07) {
+        const MYADC_Current_t *cur = MYADC_GetCurrent();
+        float err[3];
+        uint8_t i;
+        
+        stat->valid++;
+        err[0] = cur->ia - phase_i[0];
+        err[1] = cur->ib - phase_i[1];
+        err[2] = cur->ic - phase_i[2];
+        for (i = 0; i < 3; i++) {
+            if (fabsf(err[i]) > stat->err_max) {
+                stat->err_max = fabsf(err[i]);
+            }
+            stat->err_sq += err[i] * err[i];
+            stat->err_n++;
+        }
+    }
+}
+
+/**
+ * @brief  设置本PWM周期的电压指令和相电流
+ * @param  angle: 电压矢量方向（°）
+ * @param  mod: 幅值（相对线性区上限 Vbus/√3）
+ */
+static void Sim_SetPoint(float angle, float mod)
+{
+    float theta = angle * PI / 180.0f;
+    float v = mod * SIM_VBUS * SQRT3_INV;
+    uint8_t i;
+    
+    cmd_valpha = v * cosf(theta);
+    cmd_vbeta = v * sinf(theta);
+    for (i = 0; i < 3; i++) {
+        phase_i[i] = SIM_I_PEAK * cosf(theta - SIM_PHI - i * (2.0f * PI / 3.0f));
+    }
+}
+
+/**
+ * @brief  电压矢量匀速旋转一圈，按方向分区统计
+ * @param  mod: 幅值（相对线性区上限 Vbus/√3）
+ * @param  stat: 各方向区间的统计（累加）
+ */
+static void Sim_Turn(float mod, Sim_Stat_t stat[SIM_BIN_NUM])
+{
+    uint32_t n;
+    float angle;
+    
+    for (n = 0; n < SIM_WARMUP; n++) {
+        Sim_SetPoint(0.0f, mod);
+        Sim_Period(0);
+    }
+    for (n = 0; n < SIM_TURN_PERIODS; n++) {
+        angle = n * (360.0f / SIM_TURN_PERIODS);
+        Sim_SetPoint(angle, mod);
+        Sim_Period(&stat[(uint32_t)(angle / SIM_BIN_DEG)]);
+    }
+}
+
+/**
+ * @brief  合并统计
+ */
+static void Sim_Merge(Sim_Stat_t *dst, const Sim_Stat_t *src)
+{
+    dst->periods += src->periods;
+    dst->valid += src->valid;
+    dst->edge_hits += src->edge_hits;
+    dst->dropped += src->dropped;
+    dst->stalled += src->stalled;
+    if (src->err_max > dst->err_max) {
+        dst->err_max = src->err_max;
+    }
+    dst->err_sq += src->err_sq;
+    dst->err_n += src->err_n;
+}
+
+/**
+ * @brief  输出一行统计
+ */
+static void Sim_Print(const char *label, const Sim_Stat_t *s)
+{
+    printf("%-14s %7.1f%% %9.4f %9.4f %6u %6u %6u\n", label,
+           s->periods ? 100.0 * s->valid / s->periods : 0.0,
+           s->err_max, s->err_n ? sqrt(s->err_sq / s->err_n) : 0.0,
+           s->edge_hits, s->dropped, s->stalled);
+}
+
+int main(int argc, char *argv[])
+{
+    uint8_t verbose = (argc > 1 && strcmp(argv[1], "-v") == 0);
+    uint16_t offset[3] = {MYADC_CURRENT_OFFSET, MYADC_CURRENT_OFFSET, MYADC_CURRENT_OFFSET};
+    float gain[3] = {1.0f, 1.0f, 1.0f};
+    Sim_Stat_t total, row, bins[SIM_BIN_NUM];
+    char label[32];
+    uint8_t m, b;
+    int fail = 0;
+    
+    if (!HostPeriph_Init()) {
+        printf("cannot map peripheral address space\n");
+        return 2;
+    }
+    
+    // 固件初始化：调制器、PWM（TIM2后端）、单电阻触发、电流换算
+    FOC_Init();
+    MYADC_SetCalibration(offset, gain);
+    MS8313_SetSingleShuntTrigger();
+    MS8313_EnableOutput();
+    
+    printf("single-shunt reconstruction: period %u, window %u, sample %u, min pulse %u (counts)\n",
+           MS8313_GetTiming()->period, FOC_GetControlStatus()->sampling.ss_window,
+           FOC_GetControlStatus()->sampling.ss_sample, FOC_GetControlStatus()->sampling.min_pulse);
+    printf("I = %.1f A lagging %.0f deg, noise %.1f LSB, amp tau %.0f counts\n\n",
+           SIM_I_PEAK, SIM_PHI * 180.0f / PI, SIM_NOISE, SIM_AMP_TAU);
+    printf("%-14s %8s %9s %9s %6s %6s %6s\n", "point", "valid", "max err", "rms err", "edge", "drop", "stall");
+    
+    memset(&total, 0, sizeof(total));
+    for (m = 0; m < SIM_MOD_NUM; m++) {
+        memset(&row, 0, sizeof(row));
+        memset(bins, 0, sizeof(bins));
+        Sim_Turn(sim_mod[m], bins);
+        for (b = 0; b < SIM_BIN_NUM; b++) {
+            if (verbose) {
+                snprintf(label, sizeof(label), "m%.2f %3d-%3d", sim_mod[m], b * SIM_BIN_DEG, (b + 1) * SIM_BIN_DEG);
+                Sim_Print(label, &bins[b]);
+            }
+            Sim_Merge(&row, &bins[b]);
+        }
+        snprintf(label, sizeof(label), "m %.2f", sim_mod[m]);
+        Sim_Print(label, &row);
+        Sim_Merge(&total, &row);
+    }
+    Sim_Print("all", &total);
+    
+    if (total.err_max > SIM_ERR_LIMIT || total.edge_hits) {
+        fail = 1;
+    }
+    printf("\n%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
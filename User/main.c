@@ -1,19 +1,182 @@
 #include "stm32f10x.h"
 #include "Delay.h"
 #include "FOC.h"
+#include "MS8313.h"
 #include "AS5600.h"
+#include "Kalman.h"
+#include "ADC.h"
 #include "USART.h"
+#include "Param.h"
+#include "Autotune.h"
+#include "MotorID.h"
+
+// ==================== 控制周期共享变量 ====================
+static volatile uint8_t control_ready = 0;  // 传感器和滤波器就绪后才执行控制
+static uint16_t pwm_count = 0;  // 本控制周期内已过的PWM周期数（电流环角度插值用）
+static uint16_t angle = 0;
+static float speed_rpm = 0.0f;
+static float speed_mt = 0.0f;
+static AS5600_SpeedEst_t speed_est;
+static Kalman_t kf;
+static uint32_t kf_timing_version = 0;      // 滤波器已换算到的PWM时序版本
+static volatile uint8_t kf_gain_pending = 0;  // 控制频率已修改，稳态增益待主循环重算
+static uint32_t kf_cycles = 0;              // 最近一次 Predict + Update 耗时（CPU周期）
+static uint32_t kf_cycles_max = 0;          // Predict + Update 最大耗时（CPU周期）
+static uint32_t cl_cycles = 0;              // 最近一次电流环（角度外推 + FOC_CurrentLoop）耗时（CPU周期）
+static uint32_t cl_cycles_max = 0;          // 电流环最大耗时（CPU周期）
+static uint32_t cl_overrun = 0;             // 电流环耗时超过一个PWM周期的次数
+#if AS5600_DUAL_ENABLE
+static AS5600_Dual_t dual;
+#endif
+
+/**
+  * @brief  按电机参数计算卡尔曼滤波的模型输入增益
+  * @note   电流输入 b = Kt / (2π·J)，电压输入再除以 Rs；
+  *         惯量、磁链或电阻未辨识（为0）时对应增益为0，滤波器只按运动学模型预测
+  * @param  motor: 电机参数
+  * @param  b: 增益输出（rev/s^2 每A / 每V）
+  */
+static void KF_ModelGain(const FOC_MotorParam_t *motor, float b[KALMAN_INPUT_NUM])
+{
+	float kt = 1.5f * motor->pole_pairs * motor->flux;
+	
+	b[KALMAN_INPUT_CURRENT] = 0.0f;
+	b[KALMAN_INPUT_VOLTAGE] = 0.0f;
+	if (kt > 0.0f && motor->inertia > 0.0f) {
+		b[KALMAN_INPUT_CURRENT] = kt / (2.0f * PI * motor->inertia);
+		if (motor->rs > 0.0f) {
+			b[KALMAN_INPUT_VOLTAGE] = b[KALMAN_INPUT_CURRENT] / motor->rs;
+		}
+	}
+}
+
+/**
+  * @brief  控制周期回调（TIM2下溢中断，1kHz，与PWM同相位）
+  * @note   角度读取为异步：本周期取上周期启动的读取结果（双传感器模式下表决），
+  *         结束前启动下一次读取，中断内不等待 I2C。
+  *         电流采样中断优先级更高，会在本回调中途插入并外推滤波器角度，
+  *         滤波器和插值计数的修改关中断完成，电流环不会看到一半更新的状态
+  */
+void MS8313_ControlCallback(void)
+{
+	FOC_Control_t *status = FOC_GetControlStatus();
+	uint16_t raw_angle;
+	uint16_t divider;
+	uint8_t read_ok;
+	uint32_t t0, cycles;
+	
+	if (!control_ready) {
+		return;
+	}
+	
+	// 卡尔曼预测（I2C读取失败时只预测；输入为上一周期的转矩指令：
+	// 电流环运行时用 iq 参考（A），电压模式和六步换相用电压参考（V），禁用时为0）
+	// 本谷点的电流采样可能已先于本回调处理（按上一周期外推到终点），此时计数扣除一个控制周期
+	divider = MS8313_GetTiming()->control_divider;
+	NVIC_DisableIRQ(ADC1_2_IRQn);
+	pwm_count = (pwm_count > divider) ? pwm_count - divider : 0;
+	
+	// PWM频率修改后控制频率随之变化：滤波器状态立即按新周期换算，稳态增益由主循环重算
+	if (MS8313_GetTiming()->version != kf_timing_version) {
+		kf_timing_version = MS8313_GetTiming()->version;
+		Kalman_SetSampleRate(&kf, MS8313_GetTiming()->control_freq, 0);
+		kf_gain_pending = 1;
+	}
+	
+	t0 = Delay_GetCycles();
+	if (!status->enable) {
+		Kalman_Predict(&kf, 0.0f, KALMAN_INPUT_CURRENT);
+	} else if (status->current_loop && status->mode == FOC_MODE_FOC) {
+		Kalman_Predict(&kf, status->iq_ref, KALMAN_INPUT_CURRENT);
+	} else {
+		Kalman_Predict(&kf, status->voltage_ref, KALMAN_INPUT_VOLTAGE);
+	}
+	cycles = Delay_GetCycles() - t0;
+	NVIC_EnableIRQ(ADC1_2_IRQn);
+	
+	// 读取位置（带时间戳）
+#if AS5600_DUAL_ENABLE
+	read_ok = AS5600_Dual_Vote(Kalman_GetAngle(&kf), &dual);
+	raw_angle = dual.angle;
+#else
+	read_ok = AS5600_GetReadResult(&raw_angle);
+#endif
+	if (read_ok == AS5600_OK)
+	{
+		// M/T法测速：低速计时，高速计数
+		speed_mt = AS5600_SpeedEst_Update(&speed_est, raw_angle, Delay_GetMicros());
+		NVIC_DisableIRQ(ADC1_2_IRQn);
+		t0 = Delay_GetCycles();
+		Kalman_Update(&kf, raw_angle);
+		cycles += Delay_GetCycles() - t0;
+		NVIC_EnableIRQ(ADC1_2_IRQn);
+	}
+	
+	// 滤波器耗时（电流采样中断已屏蔽，不含被抢占的时间）
+	kf_cycles = cycles;
+	if (cycles > kf_cycles_max) {
+		kf_cycles_max = cycles;
+	}
+	
+	angle = Kalman_GetAngle(&kf);
+	speed_rpm = Kalman_GetSpeedRPM(&kf);
+	AS5600_UpdateTotalAngle(angle);  // 多圈累计角度（位置环反馈）
+	
+	// FOC主控制循环
+	FOC_MainLoop(angle, speed_rpm);
+	
+#if AS5600_DUAL_ENABLE
+	AS5600_Dual_StartRead();
+#else
+	AS5600_StartRead();
+#endif
+}
+
+/**
+  * @brief  电流采样完成回调（ADC注入组中断，每个PWM周期）
+  * @note   d/q电流环使用卡尔曼滤波外推到本次采样时刻的角度
+  */
+void MYADC_CurrentCallback(void)
+{
+	const MYADC_Current_t *current = MYADC_GetCurrent();
+	uint32_t frac_q16;
+	uint32_t t0, cycles;
+	
+	if (!control_ready) {
+		return;
+	}
+	
+	frac_q16 = ((uint32_t)pwm_count << 16) / MS8313_GetTiming()->control_divider;
+	if (pwm_count < 0xFFFF) {
+		pwm_count++;
+	}
+	
+	t0 = Delay_GetCycles();
+	FOC_CurrentLoop(current->ia, current->ib, current->ic, Kalman_GetAngleAt(&kf, frac_q16));
+	cycles = Delay_GetCycles() - t0;
+	
+	// 不含中断进出和ADC换算，超出一个PWM周期的预算即计为超时
+	cl_cycles = cycles;
+	if (cycles > cl_cycles_max) {
+		cl_cycles_max = cycles;
+	}
+	if (cycles > SystemCoreClock / MS8313_GetTiming()->pwm_freq) {
+		cl_overrun++;
+	}
+}
 
 /**
   * @brief  FOC智能车控制程序
-  * @note   实现开环FOC控制，无ADC电流采样
+  * @note   速度环 + d/q电流环FOC；相电流由ADC注入组在PWM谷点同步采样
   */
 int main(void)
 {
 	// ========== 初始化 ==========
 	
-	// 1. 初始化延时系统
+	// 1. 初始化中断分组和延时系统
+	NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2);
 	Delay_Init();
+	Delay_CycleInit();
 	
 	// 2. 初始化串口调试
 	USART1_Init(115200);
@@ -23,7 +186,64 @@ int main(void)
 	FOC_Init();
 	USART1_Printf("FOC System Initialized!\r\n");
 	
+	// 初始化ADC（慢速通道 + 相电流采样）
+	MYADC_Init();
+	USART1_Printf("Vbus: %.2f V\r\n", MYADC_GetVbus());
+	
+	// 读取持久化参数，先应用上次的电流采样校准
+	Param_t *param = Param_Get();
+	if (Param_Init() != PARAM_OK) {
+		USART1_Printf("Param: using defaults\r\n");
+	}
+	MYADC_SetCalibration(param->current_offset, param->current_gain);
+	
+	// 应用已保存的速度环自整定增益（bit0 电压输出，bit1 电流输出）
+	if (param->speed_tuned & 0x01) {
+		FOC_SetSpeedGain(0, param->speed_kp[0], param->speed_ki[0]);
+	}
+	if (param->speed_tuned & 0x02) {
+		FOC_SetSpeedGain(1, param->speed_kp[1], param->speed_ki[1]);
+	}
+	
+	// 应用已保存的速度环增益调度表（有表时覆盖上面的固定增益）
+	{
+		uint8_t u;
+		
+		for (u = 0; u < 2; u++) {
+			if (param->sched_count[u] &&
+				!FOC_SetGainSchedule(u, param->sched_speed[u], param->sched_kp[u],
+									 param->sched_ki[u], param->sched_count[u])) {
+				USART1_Printf("Param: invalid gain schedule %d\r\n", u);
+			}
+		}
+	}
+	
+	// 应用已保存的电角度零点（启动校准成功时重新标定）
+	if (param->angle_calibrated) {
+		FOC_SetAngleOffset(param->angle_offset);
+	}
+	
+	// 应用已保存的电机辨识结果（只覆盖辨识成功的项）
+	if (param->motor_identified) {
+		FOC_MotorParam_t motor = FOC_GetControlStatus()->motor;
+		
+		if (param->motor_identified & MOTORID_RS_OK)       motor.rs = param->motor_rs;
+		if (param->motor_identified & MOTORID_LD_OK)       motor.ld = param->motor_ld;
+		if (param->motor_identified & MOTORID_LQ_OK)       motor.lq = param->motor_lq;
+		if (param->motor_identified & MOTORID_FLUX_OK)     motor.flux = param->motor_flux;
+		if (param->motor_identified & MOTORID_INERTIA_OK)  motor.inertia = param->motor_inertia;
+		if (param->motor_identified & MOTORID_FRICTION_OK) motor.friction = param->motor_friction;
+		FOC_SetMotorParam(&motor);
+	}
+	
 	// 4. 初始化AS5600位置传感器
+#if AS5600_DUAL_ENABLE
+	// 双传感器冗余：I2C1 + I2C2，至少一路存在即可运行
+	if (AS5600_Dual_Init() != AS5600_OK) {
+		USART1_Printf("AS5600 Dual Init Failed!\r\n");
+		while(1);
+	}
+#else
 	if (AS5600_Init() != AS5600_OK) {
 		USART1_Printf("AS5600 Init Failed!\r\n");
 		while(1);
@@ -34,45 +254,166 @@ int main(void)
 		USART1_Printf("AS5600 Not Connected!\r\n");
 		while(1);
 	}
+#endif
 	
 	USART1_Printf("AS5600 Connected Successfully!\r\n");
 	
-	// 5. 使能FOC控制
-	FOC_Enable();
-	USART1_Printf("FOC Control Enabled!\r\n");
+	// 5. 初始化测速和角度/速度卡尔曼滤波（以转矩指令为模型输入，增益按已应用的电机参数）
+	Kalman_Config_t kf_config;
+	
+#if AS5600_DUAL_ENABLE
+	AS5600_Dual_Read(0, &dual);
+	angle = dual.angle;
+	AS5600_Dual_StartRead();
+#else
+	AS5600_GetRawAngle(&angle);
+	AS5600_StartRead();
+#endif
+	AS5600_SpeedEst_Init(&speed_est, angle, Delay_GetMicros());
+	
+	Kalman_GetDefaultConfig(&kf_config);
+	kf_config.sample_rate = MS8313_GetTiming()->control_freq;
+	kf_timing_version = MS8313_GetTiming()->version;
+	KF_ModelGain(&FOC_GetControlStatus()->motor, kf_config.b);
+	Kalman_Init(&kf, &kf_config);
+	Kalman_Update(&kf, angle);
+	control_ready = 1;
+	
+	// 电流采样启动校准（同时标定电角度零点，需要控制回调在记录角度）：
+	// 成功的结果与已存值差别明显时才写Flash，避免每次上电擦写
+	{
+		uint16_t offset[3];
+		uint16_t angle_offset = param->angle_offset;
+		int16_t angle_diff;
+		float gain[3];
+		uint8_t cal, changed = 0;
+		uint8_t i;
+		
+		for (i = 0; i < 3; i++) {
+			offset[i] = param->current_offset[i];
+			gain[i] = param->current_gain[i];
+		}
+		cal = FOC_CalibrateCurrent(FOC_CAL_GAIN_CHECK, offset, gain, &angle_offset);
+		USART1_Printf("Current Cal: 0x%02X, offset %d/%d/%d, gain %.3f/%.3f/%.3f, angle %d\r\n",
+					   cal, offset[0], offset[1], offset[2], gain[0], gain[1], gain[2], angle_offset);
+		
+		for (i = 0; i < 3; i++) {
+			if ((cal & FOC_CAL_OFFSET_OK) &&
+				(offset[i] > param->current_offset[i] + 2 || offset[i] + 2 < param->current_offset[i])) {
+				changed = 1;
+			}
+			if ((cal & FOC_CAL_GAIN_OK) &&
+				(gain[i] > param->current_gain[i] + 0.01f || gain[i] < param->current_gain[i] - 0.01f)) {
+				changed = 1;
+			}
+		}
+		angle_diff = AS5600_GetAngleDiff(angle_offset, param->angle_offset);
+		if ((cal & FOC_CAL_ANGLE_OK) && (!param->angle_calibrated || angle_diff > 8 || angle_diff < -8)) {
+			changed = 1;
+		}
+		if (changed || ((cal & FOC_CAL_OFFSET_OK) && !param->current_calibrated)) {
+			for (i = 0; i < 3; i++) {
+				param->current_offset[i] = offset[i];
+				param->current_gain[i] = gain[i];
+			}
+			param->current_calibrated = 1;
+			if (cal & FOC_CAL_ANGLE_OK) {
+				param->angle_offset = angle_offset;
+				param->angle_calibrated = 1;
+			}
+			if (Param_Save() != PARAM_OK) {
+				USART1_Printf("Param: save failed\r\n");
+			}
+		}
+	}
+	
+#if MOTORID_AT_STARTUP
+	// 未辨识过时做离线参数辨识（需要测速，在FOC使能前运行，结束时电机已停止）
+	if (!param->motor_identified) {
+		FOC_MotorParam_t motor = FOC_GetControlStatus()->motor;
+		uint16_t angle_offset;
+		uint8_t id = MotorID_Run(&motor, &angle_offset);
+		
+		if (id) {
+			float b[KALMAN_INPUT_NUM];
+			
+			FOC_SetMotorParam(&motor);
+			KF_ModelGain(&FOC_GetControlStatus()->motor, b);
+			NVIC_DisableIRQ(MS8313_UPDATE_IRQn);
+			Kalman_SetInputGain(&kf, KALMAN_INPUT_CURRENT, b[KALMAN_INPUT_CURRENT]);
+			Kalman_SetInputGain(&kf, KALMAN_INPUT_VOLTAGE, b[KALMAN_INPUT_VOLTAGE]);
+			NVIC_EnableIRQ(MS8313_UPDATE_IRQn);
+			if (id & MOTORID_OFFSET_OK) {
+				FOC_SetAngleOffset(angle_offset);
+				param->angle_offset = angle_offset;
+				param->angle_calibrated = 1;
+			}
+			param->motor_identified = id;
+			param->motor_rs = motor.rs;
+			param->motor_ld = motor.ld;
+			param->motor_lq = motor.lq;
+			param->motor_flux = motor.flux;
+			param->motor_inertia = motor.inertia;
+			param->motor_friction = motor.friction;
+			USART1_Printf("MotorID: %s\r\n", Param_Save() == PARAM_OK ? "saved" : "save failed");
+		}
+	}
+#endif
 	
 	// 6. 设置控制参数（先用低转速测试）
 	FOC_SetControl(100.0f, 0);  // 100RPM转速，正转
 	USART1_Printf("FOC Control Parameters Set: 100 RPM\r\n");
 	
-	USART1_Printf("System Ready! Starting FOC Control...\r\n\r\n");
+	// 7. 使能FOC控制（PWM启动后由下溢中断驱动控制周期）
+	FOC_Enable();
+	USART1_Printf("FOC Control Enabled!\r\n");
 	
-	// ========== 主循环：FOC控制 ==========
-	uint32_t last_time = 0;
-	uint16_t angle = 0;
-	float speed_rpm = 0.0f;
+#if AUTOTUNE_AT_STARTUP
+	// 当前控制模式的速度环未整定时自动整定；Flash擦写期间中断停顿，停机后再保存
+	{
+		Autotune_Result_t tune;
+		uint8_t bit = (FOC_GetControlStatus()->current_loop) ? 0x02 : 0x01;
+		uint32_t t0;
+		
+		if (!(param->speed_tuned & bit) &&
+			Autotune_Run(AUTOTUNE_SETPOINT, AUTOTUNE_RULE_ZN, &tune) == AUTOTUNE_OK) {
+			FOC_SetControl(0.0f, 0);
+			t0 = Delay_GetTick();
+			while ((FOC_GetControlStatus()->speed_rpm > 5.0f || FOC_GetControlStatus()->speed_rpm < -5.0f) &&
+				   Delay_GetTick() - t0 < 2000);
+			FOC_Disable();
+			
+			param->speed_tuned |= bit;
+			param->speed_kp[tune.current_units] = tune.kp;
+			param->speed_ki[tune.current_units] = tune.ki;
+			USART1_Printf("Autotune: %s\r\n", Param_Save() == PARAM_OK ? "saved" : "save failed");
+			
+			FOC_SetControl(100.0f, 0);
+			FOC_Enable();
+		}
+	}
+#endif
 	
+	USART1_Printf("System Ready! Starting FOC Control...\r\n\r\n");
+	
+	// ========== 主循环：调试输出 ==========
 	while(1)
 	{
 		uint32_t current_time = Delay_GetTick();
 		
-		// 1ms控制周期
-		if (current_time - last_time >= 1)
-		{
-			// 读取位置
-			AS5600_GetRawAngle(&angle);
-			
-			// 计算速度（简化版）
-			static uint16_t last_angle = 0;
-			int16_t angle_diff = AS5600_GetAngleDiff(angle, last_angle);
-			speed_rpm = (float)angle_diff * 60.0f * 1000.0f / 4096.0f;  // RPM
-			last_angle = angle;
-			
-			// FOC主控制循环
-			FOC_MainLoop(angle, speed_rpm);
+		// 控制频率修改后重算卡尔曼稳态增益（浮点迭代耗时，不在中断中进行）；
+		// 计算期间频率再次修改时丢弃结果，下一轮按新频率重算
+		if (kf_gain_pending) {
+			int32_t gain[3];
 			
-			// 更新计时
-			last_time = current_time;
+			kf_gain_pending = 0;
+			kf_config.sample_rate = kf.sample_rate;
+			Kalman_ComputeSteadyGains(&kf_config, gain);
+			NVIC_DisableIRQ(MS8313_UPDATE_IRQn);
+			if (kf.sample_rate == kf_config.sample_rate) {
+				Kalman_SetSampleRate(&kf, kf_config.sample_rate, gain);
+			}
+			NVIC_EnableIRQ(MS8313_UPDATE_IRQn);
 		}
 		
 		// 串口输出调试信息（每100ms）
@@ -84,12 +425,35 @@ int main(void)
 			USART1_Printf("=== FOC Debug Info ===\r\n");
 			USART1_Printf("Angle: %d, Speed: %.1f RPM, Ref: %.1f RPM\r\n", 
 						   angle, speed_rpm, status->speed_ref);
-			USART1_Printf("Voltage: %.2f V, Enable: %d\r\n", 
-						   status->voltage_ref, status->enable);
+			USART1_Printf("M/T Speed: %.1f RPM (%s), KF Missed: %d\r\n", 
+						   speed_mt,
+						   (AS5600_SpeedEst_GetMethod(&speed_est) == AS5600_SPEED_METHOD_M) ? "M" : "T",
+						   kf.missed);
+			USART1_Printf("KF cycles: %lu (max %lu)\r\n", kf_cycles, kf_cycles_max);
+			USART1_Printf("Current loop cycles: %lu (max %lu), budget %lu, overrun %lu\r\n",
+						   cl_cycles, cl_cycles_max,
+						   (uint32_t)(SystemCoreClock / MS8313_GetTiming()->pwm_freq), cl_overrun);
+#if AS5600_DUAL_ENABLE
+			USART1_Printf("Dual: status %d, diff %d, mismatch %lu, fail %lu/%lu\r\n",
+						   dual.status, dual.disagreement, dual.mismatch_count,
+						   dual.fail_count[0], dual.fail_count[1]);
+#endif
+			USART1_Printf("Voltage: %.2f V, Vbus: %.2f V, Enable: %d, Fault: 0x%02X\r\n", 
+						   status->voltage_ref, status->vbus, status->enable, status->fault);
+			USART1_Printf("Temp: driver %.1f C, board %.1f C\r\n", 
+						   MYADC_GetSlow()->temp_driver, MYADC_GetSlow()->temp_board);
 			USART1_Printf("PWM: A=%d, B=%d, C=%d\r\n", 
 						   status->pwm_a, status->pwm_b, status->pwm_c);
 			USART1_Printf("Theta: %.3f rad, Valpha: %.3f, Vbeta: %.3f\r\n", 
 						   status->theta, status->valpha, status->vbeta);
+			USART1_Printf("Current: A=%.3f, B=%.3f, C=%.3f A, Unsampled: 0x%02X\r\n", 
+						   MYADC_GetCurrent()->ia, MYADC_GetCurrent()->ib, MYADC_GetCurrent()->ic,
+						   status->sampling.unsampled);
+			USART1_Printf("Id: %.3f/%.3f A, Iq: %.3f/%.3f A, Vd: %.2f, Vq: %.2f\r\n", 
+						   status->id, status->id_ref, status->iq, status->iq_ref,
+						   status->vd, status->vq);
+			USART1_Printf("Load: %.4f Nm, Comp: %.3f A\r\n", 
+						   status->dob.torque, status->dob.iq_comp);
 			USART1_Printf("=====================\r\n\r\n");
 			
 			debug_time = current_time;
@@ -24,6 +24,9 @@
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f10x_it.h"
 #include "Delay.h"
+#include "MYI2C.h"
+#include "MS8313.h"
+#include "ADC.h"
 
 /** @addtogroup STM32F10x_StdPeriph_Template
   * @{
@@ -146,6 +149,118 @@ void SysTick_Handler(void)
 /*  file (startup_stm32f10x_xx.s).                                            */
 /******************************************************************************/
 
+/**
+  * @brief  This function handles TIM2 (PWM timer) interrupt request.
+  * @param  None
+  * @retval None
+  */
+void TIM2_IRQHandler(void)
+{
+	MS8313_TIM_IRQHandler();
+}
+
+/**
+  * @brief  This function handles ADC1 and ADC2 interrupt request.
+  * @param  None
+  * @retval None
+  */
+void ADC1_2_IRQHandler(void)
+{
+	MYADC_IRQHandler();
+}
+
+#if MS8313_USE_TIM1
+/**
+  * @brief  This function handles TIM1 update (PWM timer) interrupt request.
+  * @param  None
+  * @retval None
+  */
+void TIM1_UP_IRQHandler(void)
+{
+	MS8313_TIM_IRQHandler();
+}
+
+/**
+  * @brief  This function handles TIM1 break interrupt request.
+  * @param  None
+  * @retval None
+  */
+void TIM1_BRK_IRQHandler(void)
+{
+	MS8313_BRK_IRQHandler();
+}
+#endif
+
+/**
+  * @brief  This function handles I2C1 event interrupt request.
+  * @param  None
+  * @retval None
+  */
+void I2C1_EV_IRQHandler(void)
+{
+	MYI2C_EV_IRQHandler(MYI2C_BUS1);
+}
+
+/**
+  * @brief  This function handles I2C1 error interrupt request.
+  * @param  None
+  * @retval None
+  */
+void I2C1_ER_IRQHandler(void)
+{
+	MYI2C_ER_IRQHandler(MYI2C_BUS1);
+}
+
+/**
+  * @brief  This function handles I2C2 event interrupt request.
+  * @param  None
+  * @retval None
+  */
+void I2C2_EV_IRQHandler(void)
+{
+	MYI2C_EV_IRQHandler(MYI2C_BUS2);
+}
+
+/**
+  * @brief  This function handles I2C2 error interrupt request.
+  * @param  None
+  * @retval None
+  */
+void I2C2_ER_IRQHandler(void)
+{
+	MYI2C_ER_IRQHandler(MYI2C_BUS2);
+}
+
+/**
+  * @brief  This function handles DMA1 Channel7 (I2C1_RX) interrupt request.
+  * @param  None
+  * @retval None
+  */
+void DMA1_Channel7_IRQHandler(void)
+{
+	MYI2C_DMA_IRQHandler(MYI2C_BUS1);
+}
+
+/**
+  * @brief  This function handles DMA1 Channel1 (ADC1 regular scan) interrupt request.
+  * @param  None
+  * @retval None
+  */
+void DMA1_Channel1_IRQHandler(void)
+{
+	MYADC_DMA_IRQHandler();
+}
+
+/**
+  * @brief  This function handles DMA1 Channel5 (I2C2_RX) interrupt request.
+  * @param  None
+  * @retval None
+  */
+void DMA1_Channel5_IRQHandler(void)
+{
+	MYI2C_DMA_IRQHandler(MYI2C_BUS2);
+}
+
 /**
   * @brief  This function handles PPP interrupt request.
   * @param  None
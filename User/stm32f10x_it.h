@@ -44,6 +44,16 @@ void SVC_Handler(void);
 void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
+void TIM2_IRQHandler(void);
+void ADC1_2_IRQHandler(void);
+void TIM1_UP_IRQHandler(void);
+void TIM1_BRK_IRQHandler(void);
+void I2C1_EV_IRQHandler(void);
+void I2C1_ER_IRQHandler(void);
+void I2C2_EV_IRQHandler(void);
+void I2C2_ER_IRQHandler(void);
+void DMA1_Channel7_IRQHandler(void);
+void DMA1_Channel5_IRQHandler(void);
 
 #ifdef __cplusplus
 }